@@ -0,0 +1,99 @@
+#ifndef ABSORPTION_H
+#define ABSORPTION_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "hasse.h"
+#include "matrix.h"
+
+/**
+ * @brief Probabilités d'absorption et temps moyens d'atteinte des classes persistantes.
+ * Avec Q le bloc transitoire -> transitoire et R le bloc transitoire -> persistant,
+ * X = (I-Q)^-1 R et t = (I-Q)^-1 1, obtenus sans puissance de matrice.
+ * X est rangée par lignes creuses : la ligne du sommet v+1 ne garde que les
+ * classes persistantes qu'il atteint (une seule pour un sommet persistant).
+ */
+typedef struct {
+    int nb_vertices;
+    int *is_transient;          /**< is_transient[v] : 1 si le sommet v+1 est transitoire. */
+    int nb_persistent;          /**< Nombre de classes persistantes. */
+    int *persistent_classes;    /**< Indices (dans la partition) des classes persistantes. */
+    size_t *row_start;          /**< Début de la ligne du sommet v+1 dans columns et values. */
+    int *row_size;              /**< Nombre de coefficients non nuls de cette ligne. */
+    int *columns;               /**< Classe persistante p (0..nb_persistent-1), croissante dans une ligne. */
+    float *values;              /**< Probabilité que le sommet finisse dans la classe p. */
+    size_t nnz;                 /**< Taille de columns et values. */
+    float *expected_steps;      /**< Nombre moyen de pas avant d'entrer dans une classe persistante (0 si persistant). */
+} t_absorption;
+
+/**
+ * @brief Calcule les probabilités d'absorption et les temps moyens.
+ * Les classes sont traitées dans l'ordre de Tarjan (ordre topologique inverse) :
+ * chaque classe transitoire ne dépend que de classes déjà résolues, et son
+ * système creux (I-Q) X = B est résolu par BiCGSTAB préconditionné par
+ * Gauss-Seidel symétrique (Gauss-Seidel seul en secours) à un résidu
+ * relatif de 1e-12. Les colonnes d'une classe sont les seules classes
+ * persistantes atteintes depuis elle : mémoire O((k + arcs) x colonnes) par
+ * classe et O(coefficients non nuls de X) au total.
+ */
+t_absorption computeAbsorption(const t_graph *g, const t_partition *part, const t_link_array *links);
+
+/**
+ * @brief Distribution stationnaire d'une classe fermée : pi (I - P_c) = 0 avec
+ * sum(pi) = 1. Le dernier sommet de la classe est fixé, ce qui laisse un système
+ * creux inversible résolu comme ceux de computeAbsorption, en mémoire O(k + arcs).
+ * Pour une classe périodique, c'est la moyenne de Cesàro. Renvoie un vecteur
+ * dans l'ordre de la classe.
+ */
+float *computeClassStationary(const t_graph *g, const t_partition *part, int compo_index);
+
+/**
+ * @brief Lignes de la matrice limite lim M^n, produites une à une :
+ * L[i][j] = X[i][p] * pi_p[j] pour j dans la classe persistante p, et 0 pour
+ * j transitoire. Seules les distributions pi_p sont gardées (O(n) au total) :
+ * la matrice n x n n'est jamais construite.
+ * Pour les classes périodiques, la limite est prise au sens de Cesàro.
+ */
+typedef struct {
+    const t_partition *part;
+    const t_absorption *abs;
+    float **pi;                 /**< pi[p] : distribution de la p-ième classe persistante, dans l'ordre de la classe. */
+    float *row;                 /**< Dernière ligne produite. */
+    int last;                   /**< Sommet de cette ligne (-1 : aucune). */
+} t_limit_rows;
+
+/**
+ * @brief Prépare les lignes de la limite : un système creux par classe persistante.
+ */
+t_limit_rows createLimitRows(const t_graph *g, const t_partition *part, const t_absorption *abs);
+
+/**
+ * @brief Ligne i de la limite (lecteur de lignes, voir t_row_reader), valable
+ * jusqu'à l'appel suivant ; arg est un t_limit_rows. Seuls les coefficients
+ * de la ligne précédente sont remis à zéro.
+ */
+const float *limitRow(void *arg, int i);
+
+/**
+ * @brief Libère les distributions et la ligne courante.
+ */
+void freeLimitRows(t_limit_rows *L);
+
+/**
+ * @brief Probabilité que le sommet v+1 finisse dans la p-ième classe persistante.
+ */
+float absorptionProbability(const t_absorption *abs, int v, int p);
+
+/**
+ * @brief Renvoie une copie de abs sur n sommets dont la ligne v est la ligne
+ * source[v] de abs (renumérotation, ou états d'origine d'un quotient) ;
+ * persistent_classes est copié tel quel.
+ */
+t_absorption remapAbsorption(const t_absorption *abs, int n, const int *source);
+
+/**
+ * @brief Libère la mémoire d'un résultat d'absorption.
+ */
+void freeAbsorption(t_absorption *abs);
+
+#endif // ABSORPTION_H
@@ -0,0 +1,39 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include "options.h"
+#include "writer.h"
+#include "markov.h"
+
+/**
+ * @brief Environnement d'une analyse : fichiers annexes et parallélisme.
+ */
+typedef struct {
+    const char *graph_mermaid;  /**< Export Mermaid du graphe (NULL : pas d'export). */
+    const char *hasse_mermaid;  /**< Export Mermaid du diagramme de Hasse (NULL : pas d'export). */
+    int nb_threads;             /**< Threads des étapes parallèles (<= 0 : nombre de processeurs). */
+} t_analysis_env;
+
+/**
+ * @brief Résumé d'une analyse (une ligne du rapport du mode --batch).
+ * Les champs non calculés par les étapes demandées valent -1.
+ */
+typedef struct {
+    int nb_vertices;
+    int nb_arcs;
+    int valid;                  /**< 1 si la matrice est stochastique (génératrice avec --ctmc). */
+    int nb_classes;
+    int nb_transient;           /**< Nombre de classes transitoires. */
+    int irreducible;
+} t_analysis_summary;
+
+/**
+ * @brief Charge la chaîne de filename dans ctx et exécute les étapes de
+ * opt->stages, résultats écrits par w. Renvoie 0 si le fichier n'a pas pu
+ * être lu. summary peut être NULL. La chaîne et ses résultats restent dans
+ * ctx jusqu'au chargement suivant.
+ */
+int analyzeFile(t_markov_context *ctx, const char *filename, const t_options *opt,
+                const t_analysis_env *env, t_writer *w, t_analysis_summary *summary);
+
+#endif // ANALYSIS_H
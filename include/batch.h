@@ -0,0 +1,18 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "options.h"
+
+/**
+ * @brief Mode --batch : analyse toutes les chaînes de opt->batch (un répertoire,
+ * dont on prend les fichiers *.txt, ou un fichier listant un chemin par ligne)
+ * sur un pool de opt->jobs threads. Chaque thread réutilise son rédacteur d'un
+ * fichier à l'autre ; les résultats et exports Mermaid de chaque chaîne sont
+ * écrits sous des noms propres dans opt->batch_dir, et le rapport (une ligne
+ * par fichier, dans l'ordre de la liste) sur la sortie standard.
+ * Renvoie le nombre de fichiers qui n'ont pas pu être analysés, ou -1 si la
+ * liste elle-même est illisible.
+ */
+int runBatch(const t_options *opt);
+
+#endif // BATCH_H
@@ -0,0 +1,49 @@
+#ifndef BITMATRIX_H
+#define BITMATRIX_H
+
+#include <stdint.h>
+
+/**
+ * @brief Matrice booléenne compactée en mots de 64 bits (une ligne = words mots).
+ * Sert aux questions purement structurelles (accessibilité entre classes du
+ * diagramme de Hasse) sans passer par les produits de float.
+ */
+typedef struct {
+    int rows;
+    int cols;
+    int words;          /**< Nombre de mots de 64 bits par ligne. */
+    uint64_t *bits;     /**< rows * words mots, ligne par ligne. */
+} t_bitmatrix;
+
+/**
+ * @brief Crée une matrice booléenne rows x cols initialisée à 0.
+ */
+t_bitmatrix createBitMatrix(int rows, int cols);
+
+/**
+ * @brief Libère la mémoire d'une matrice booléenne.
+ */
+void freeBitMatrix(t_bitmatrix *m);
+
+/**
+ * @brief Renvoie le bit (i,j) (indices 0..n-1).
+ */
+int bitMatrixGet(const t_bitmatrix *m, int i, int j);
+
+/**
+ * @brief Met le bit (i,j) à 1.
+ */
+void bitMatrixSet(t_bitmatrix *m, int i, int j);
+
+/**
+ * @brief Calcule C = A * B dans l'algèbre (OU, ET), méthode des quatre Russes :
+ * les lignes de B sont groupées par 8 et leurs 256 combinaisons précalculées.
+ */
+void bitMatrixMultiply(const t_bitmatrix *A, const t_bitmatrix *B, t_bitmatrix *C);
+
+/**
+ * @brief Fermeture transitive : bit (i,j) à 1 s'il existe un chemin de longueur >= 1 de i à j.
+ */
+t_bitmatrix bitMatrixTransitiveClosure(const t_bitmatrix *M);
+
+#endif // BITMATRIX_H
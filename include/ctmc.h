@@ -0,0 +1,53 @@
+#ifndef CTMC_H
+#define CTMC_H
+
+#include "graph.h"
+
+/**
+ * @brief Poids de Poisson tronqués (Fox-Glynn) : w[k - left] ~ e^(-qt) (qt)^k / k!
+ * pour k dans [left, right], normalisés, la masse négligée étant <= eps.
+ */
+typedef struct {
+    int left;
+    int right;
+    double *weights;
+} t_poisson_weights;
+
+/**
+ * @brief Calcule les poids de Poisson de paramètre lambda_t à la manière de
+ * Fox-Glynn : départ au mode avec un poids arbitraire, récurrences vers la
+ * gauche et vers la droite, puis normalisation (pas de sous-dépassement).
+ */
+t_poisson_weights foxGlynn(double lambda_t, double eps);
+
+/**
+ * @brief Libère les poids de Poisson.
+ */
+void freePoissonWeights(t_poisson_weights *w);
+
+/**
+ * @brief Taux d'uniformisation lambda = 1.02 * max_i (taux sortant de i)
+ * (1 si aucun taux n'est positif). La marge garantit des boucles, donc une
+ * chaîne uniformisée apériodique.
+ */
+double uniformizationRate(const t_graph *Q);
+
+/**
+ * @brief Uniformisation d'un générateur Q : P = I + Q / lambda avec lambda =
+ * uniformizationRate(Q). Le taux diagonal est recalculé à partir des taux sortants.
+ * Le graphe renvoyé est une chaîne à temps discret de même distribution stationnaire.
+ */
+t_graph *uniformize(const t_graph *Q, double *lambda_out);
+
+/**
+ * @brief Distribution transitoire pi(t) = pi0 * e^(Qt) par uniformisation :
+ * somme des w_k * pi0 * P^k, P = I + Q / uniformizationRate(Q) étant appliqué en
+ * double directement à partir des taux de Q (pas de graphe float intermédiaire).
+ * Dès que deux itérés successifs diffèrent de moins de eps * 1e-3 (norme 1),
+ * la masse restante des poids est reportée sur le dernier itéré et le calcul
+ * s'arrête. Renvoie le nombre de produits effectués.
+ */
+int transientDistribution(const t_graph *Q, const double *pi0, double t,
+                          double eps, double *out);
+
+#endif // CTMC_H
@@ -1,6 +1,8 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <stdint.h>
+
 /**
  * @brief Arc de la liste d'adjacence (une arête du graphe).
  */
@@ -23,13 +25,44 @@ typedef struct {
 typedef struct {
     int nb_vertices;        /**< Nombre de sommets. */
     t_adj_list *array;      /**< Tableau de listes (taille nb_vertices). */
+    int continuous;         /**< 1 si les arcs portent des taux (générateur d'une chaîne à temps continu). */
 } t_graph;
 
 /**
- * @brief Lit un graphe à partir d'un fichier texte au format du sujet.
+ * @brief Format binaire des graphes (markov_gen --binary), dans l'ordre
+ * d'octets de la machine : GRAPH_BINARY_MAGIC, uint32 n, puis pour chaque
+ * sommet 1..n : uint32 d suivi de d enregistrements t_binary_arc.
+ */
+#define GRAPH_BINARY_MAGIC "MKG1"
+
+typedef struct {
+    uint32_t dest;          /**< Sommet d'arrivée (1..n). */
+    float proba;
+} t_binary_arc;
+
+/**
+ * @brief Lit un graphe à partir d'un fichier texte au format du sujet, ou au
+ * format binaire (reconnu à son en-tête GRAPH_BINARY_MAGIC).
+ * Renvoie NULL (message sur stderr) si le fichier ne peut pas être lu, ou si
+ * un fichier binaire est tronqué ou désigne un sommet hors de 1..n.
  */
 t_graph *readGraph(const char *filename);
 
+/**
+ * @brief Renvoie le nombre d'arcs du graphe.
+ */
+int countArcs(const t_graph *g);
+
+/**
+ * @brief Crée un graphe de n sommets sans arc.
+ */
+t_graph *createGraph(int nb_vertices);
+
+/**
+ * @brief Ajoute l'arc src -> dest de probabilité proba (sommets 1..n).
+ */
+void addArc(t_graph *g, int src, int dest, float proba);
+
 /**
  * @brief Libère toute la mémoire associée au graphe.
  */
@@ -42,9 +75,43 @@ void printAdjList(const t_graph *g);
 
 /**
  * @brief Vérifie si le graphe est un graphe de Markov (sommes des probas ~ 1).
+ * Pour un générateur (g->continuous), vérifie que les taux hors diagonale sont
+ * positifs et que chaque ligne, diagonale comprise, a une somme ~ 0.
  */
 int checkMarkov(const t_graph *g, float eps);
 
+/**
+ * @brief Même vérification que checkMarkov, sans affichage.
+ */
+int isMarkovGraph(const t_graph *g, float eps);
+
+/**
+ * @brief Résultat détaillé de la vérification (voir verifyMarkov).
+ */
+typedef struct {
+    int valid;
+    int nb_invalid;             /**< Nombre de lignes fautives. */
+    int *invalid_rows;          /**< Sommets (1..n) dont la ligne est fautive (NULL si aucun). */
+    float *row_sums;            /**< Somme de chacune de ces lignes. */
+} t_markov_check;
+
+/**
+ * @brief Même vérification que checkMarkov, résultat renvoyé sous forme de
+ * données (à libérer avec freeMarkovCheck).
+ */
+t_markov_check verifyMarkov(const t_graph *g, float eps);
+
+/**
+ * @brief Libère les tableaux d'un t_markov_check.
+ */
+void freeMarkovCheck(t_markov_check *check);
+
+/**
+ * @brief Ecrit le graphe dans un fichier texte au format du sujet (relu par readGraph).
+ * Renvoie 0 (message sur stderr) si le fichier ne peut pas être écrit.
+ */
+int saveGraph(const t_graph *g, const char *filename);
+
 /**
  * @brief Exporte le graphe au format Mermaid dans un fichier .mmd.
  */
@@ -12,6 +12,15 @@ typedef struct {
     int to;     /**< indice de la classe d'arrivée. */
 } t_link;
 
+/**
+ * @brief Nature d'une classe de la partition.
+ */
+typedef enum {
+    CLASS_TRANSIENT,
+    CLASS_PERSISTENT,
+    CLASS_ABSORBING             /**< Classe persistante réduite à un état. */
+} t_class_kind;
+
 /**
  * @brief Tableau dynamique de liens.
  */
@@ -43,6 +52,9 @@ void build_class_links(const t_graph *g, const t_partition *part, t_link_array *
 
 /**
  * @brief Supprime les liens transitifs (pour un vrai diagramme de Hasse).
+ * L'accessibilité entre classes est calculée sur des matrices booléennes compactes,
+ * ou par parcours des successeurs bornés par le rang topologique quand les
+ * classes sont nombreuses.
  */
 void removeTransitiveLinks(t_link_array *links);
 
@@ -51,6 +63,18 @@ void removeTransitiveLinks(t_link_array *links);
  */
 int export_mermaid_hasse(const t_partition *part, const t_link_array *links, const char *filename);
 
+/**
+ * @brief Renvoie un tableau (taille part->size) : 1 si la classe est transitoire
+ * (au moins un lien sortant), 0 si elle est persistante. À libérer par l'appelant.
+ */
+int *buildTransientFlags(const t_partition *part, const t_link_array *links);
+
+/**
+ * @brief Renvoie la nature de chaque classe (tableau de taille part->size, à
+ * libérer par l'appelant).
+ */
+t_class_kind *classifyClasses(const t_partition *part, const t_link_array *links);
+
 /**
  * @brief Affiche les caractéristiques du graphe:
  * classes transitoires/persistantes, états absorbants, irréductibilité.
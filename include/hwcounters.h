@@ -0,0 +1,72 @@
+#ifndef HWCOUNTERS_H
+#define HWCOUNTERS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * @brief Noyaux instrumentés par les compteurs matériels.
+ */
+typedef enum {
+    KERNEL_MULTIPLY,            /**< multiplyMatrices (produit dense n^3). */
+    KERNEL_MULTIPLY_ROWS,       /**< multiply_rows (blocs de lignes des vues, pipeline). */
+    KERNEL_TARJAN,              /**< tarjanPartition (parcours en profondeur). */
+    KERNEL_CLASS_LINKS,         /**< build_class_links (liens entre classes). */
+    KERNEL_HASSE_REDUCTION,     /**< removeTransitiveLinks (réduction transitive). */
+    NB_KERNELS
+} t_kernel;
+
+/**
+ * @brief Compteurs lus : cycles, instructions, défauts du dernier niveau de cache, erreurs de prédiction.
+ */
+typedef enum {
+    HW_CYCLES,
+    HW_INSTRUCTIONS,
+    HW_LLC_MISSES,
+    HW_BRANCH_MISSES,
+    HW_NB_EVENTS
+} t_hw_event;
+
+/**
+ * @brief Mesure en cours d'un noyau (voir hwProbeBegin / hwProbeEnd).
+ */
+typedef struct {
+    int active;
+    t_kernel kernel;
+    double wall;
+    uint64_t values[HW_NB_EVENTS];
+    int counted;                /**< 1 si les compteurs du thread sont ouverts. */
+} t_hw_probe;
+
+/**
+ * @brief Active la mesure des noyaux. Les compteurs (perf_event_open, espace
+ * utilisateur seulement) sont ouverts à la première mesure de chaque thread ;
+ * s'ils sont indisponibles (noyau, droits, machine virtuelle), seuls les temps
+ * et les débits sont rapportés.
+ */
+void hwCountersEnable(void);
+
+/**
+ * @brief Renvoie 1 si la mesure des noyaux est active.
+ */
+int hwCountersEnabled(void);
+
+/**
+ * @brief Début de la mesure d'un noyau (un test si la mesure est désactivée).
+ */
+void hwProbeBegin(t_hw_probe *p, t_kernel kernel);
+
+/**
+ * @brief Fin de la mesure. flops : opérations flottantes nominales ; arcs :
+ * arcs (ou liens) parcourus, pour les octets de mémoire par arc (0 si sans objet).
+ */
+void hwProbeEnd(t_hw_probe *p, double flops, double arcs);
+
+/**
+ * @brief Ecrit, par noyau, les compteurs et les métriques dérivées : IPC,
+ * GFLOP/s, défauts LLC pour mille instructions, octets lus en mémoire par arc
+ * (défauts LLC x 64 / arcs), et une estimation du facteur limitant.
+ */
+void hwCountersReport(FILE *out, int json);
+
+#endif // HWCOUNTERS_H
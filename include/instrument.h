@@ -0,0 +1,70 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define PROBE_NAME_MAX 48
+
+/**
+ * @brief Mesure en cours d'une étape (voir probeBegin / probeEnd).
+ * Les mesures de même nom sont cumulées dans le rapport.
+ */
+typedef struct {
+    char name[PROBE_NAME_MAX];
+    int active;                 /**< 0 si l'instrumentation était désactivée au début. */
+    int thread_scope;           /**< CPU et allocations du thread appelant seulement. */
+    double wall;
+    double cpu;
+    unsigned long long allocs;
+    unsigned long long bytes;
+    long rss_kb;                /**< Mémoire résidente du processus au début (Ko). */
+} t_probe;
+
+/**
+ * @brief Active l'instrumentation (désactivée par défaut : chaque sonde ne
+ * coûte alors qu'un test).
+ */
+void instrumentEnable(void);
+
+/**
+ * @brief Renvoie 1 si l'instrumentation est active.
+ */
+int instrumentEnabled(void);
+
+/**
+ * @brief Début d'une étape : temps mur, temps CPU du processus, allocations de tous les threads.
+ */
+void probeBegin(t_probe *p, const char *name);
+
+/**
+ * @brief Début d'une étape exécutée par un seul thread (tâche du pool) :
+ * temps CPU et allocations de ce thread seulement. La mesure est nommée
+ * "name detail" (detail peut être NULL), par exemple "periode C3".
+ */
+void probeBeginThread(t_probe *p, const char *name, const char *detail);
+
+/**
+ * @brief Fin de l'étape : cumule la mesure, la variation de mémoire résidente
+ * du processus pendant l'étape et le pic de mémoire résidente. Ce pic
+ * (ru_maxrss) couvre toute la vie du processus jusqu'à la fin de l'étape :
+ * une étape qui suit une étape gourmande hérite de son pic. Les variations
+ * sont celles du processus entier, autres threads compris.
+ */
+void probeEnd(t_probe *p);
+
+/**
+ * @brief Compte une allocation de bytes octets. Appelée par les redirections
+ * de malloc/calloc/realloc (src/alloc_wrap.c).
+ */
+void instrumentCountAllocation(size_t bytes);
+
+/**
+ * @brief Ecrit le tableau des étapes (ou un objet JSON si json != 0), dans
+ * l'ordre de première apparition. Les allocations ne sont comptées que si le
+ * programme (ou libmarkov partagée) est lié avec src/alloc_wrap.c et les
+ * redirections (voir CMakeLists.txt) ; sinon elles sont affichées "-".
+ */
+void instrumentReport(FILE *out, int json);
+
+#endif // INSTRUMENT_H
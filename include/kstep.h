@@ -0,0 +1,45 @@
+#ifndef KSTEP_H
+#define KSTEP_H
+
+#include "sparse.h"
+
+/**
+ * @brief Fonction appelée à chaque horizon demandé. block contient les batch
+ * distributions pi_b * P^k, ligne par ligne (block[b * n + i]).
+ */
+typedef void (*t_kstep_callback)(int k, const float *block, int batch, int n, void *user);
+
+/**
+ * @brief Distributions à k pas pour un lot de vecteurs initiaux.
+ */
+typedef struct {
+    int n;
+    int batch;
+    int nb_horizons;
+    int *horizons;          /**< Horizons triés, sans doublon. */
+    float **distributions;  /**< distributions[h] : batch x n, ligne b = pi_b * P^horizons[h]. */
+} t_kstep_result;
+
+/**
+ * @brief Fait avancer tous les vecteurs initiaux ensemble (initial : batch x n, ligne
+ * par ligne) par produits creux x bloc dense, et appelle callback à chaque horizon
+ * de la liste (0 compris). Coût proportionnel à nnz * batch par pas, au lieu de n^3
+ * pour une puissance de matrice. Les colonnes sont réparties sur nb_threads threads
+ * (<= 0 : nombre de processeurs ; 1 : dans le thread appelant, sans pool).
+ */
+void batchDistributionsStream(const t_csr_matrix *P, const float *initial, int batch,
+                              const int *horizons, int nb_horizons, int nb_threads,
+                              t_kstep_callback callback, void *user);
+
+/**
+ * @brief Même calcul, en conservant les distributions de chaque horizon.
+ */
+t_kstep_result batchDistributions(const t_csr_matrix *P, const float *initial, int batch,
+                                  const int *horizons, int nb_horizons, int nb_threads);
+
+/**
+ * @brief Libère la mémoire d'un résultat de requêtes par lots.
+ */
+void freeKStepResult(t_kstep_result *res);
+
+#endif // KSTEP_H
@@ -0,0 +1,69 @@
+#ifndef LUMPING_H
+#define LUMPING_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "hasse.h"
+#include "absorption.h"
+
+/**
+ * @brief Partition des états en blocs ordinairement agrégeables : deux états
+ * d'un même bloc ont la même probabilité totale d'aller dans chaque bloc.
+ * Les blocs sont numérotés 1..nb_blocks dans l'ordre de leur plus petit état.
+ */
+typedef struct {
+    int nb_vertices;
+    int nb_blocks;
+    int *block_of;          /**< block_of[v] : bloc (1..nb_blocks) du sommet v+1. */
+    int *block_start;       /**< Début de chaque bloc dans members (taille nb_blocks+1). */
+    int *members;           /**< Sommets (1..n) rangés bloc par bloc, par ordre croissant. */
+} t_lumping;
+
+/**
+ * @brief Calcule la partition agrégeable la plus grossière qui raffine la
+ * partition initiale (états transitoires ; classe persistante et sous-classe
+ * cyclique), par raffinement avec
+ * séparateurs (Paige-Tarjan / Valmari) : chaque bloc séparateur parcourt les
+ * arcs entrants de ses états, et lors d'une coupure seuls les nouveaux blocs
+ * autres que le plus grand sont remis en file, d'où O(m log n) arcs parcourus.
+ * Deux poids sont considérés égaux à tol près.
+ */
+t_lumping computeLumping(const t_graph *g, const t_partition *part, const t_link_array *links,
+                         float tol);
+
+/**
+ * @brief Construit la chaîne quotient (un sommet par bloc). La ligne d'un bloc
+ * est la moyenne des lignes agrégées de ses états.
+ */
+t_graph *buildQuotientGraph(const t_graph *g, const t_lumping *L);
+
+/**
+ * @brief Pour chaque classe persistante du quotient, renvoie l'indice de la
+ * classe d'origine et lui en donne le nom ; les classes transitoires du
+ * quotient (qui peuvent regrouper plusieurs classes) sont notées -1 et T1, T2...
+ * Renvoie un tableau de taille qpart->size, à libérer par l'appelant.
+ */
+int *mapQuotientClasses(const t_lumping *L, t_partition *qpart, const t_partition *part,
+                        const t_link_array *links);
+
+/**
+ * @brief Ramène sur les états d'origine un résultat d'absorption calculé sur
+ * le quotient (exact : ces grandeurs sont constantes sur chaque bloc).
+ * class_map est le tableau renvoyé par mapQuotientClasses.
+ */
+t_absorption expandAbsorption(const t_absorption *q, const t_lumping *L, const int *class_map);
+
+/**
+ * @brief Classes du quotient ramenées aux états : la classe qc regroupe les
+ * états de ses blocs, dans l'ordre où la partition d'origine part (partie 2)
+ * les liste. Les noms sont ceux de qpart. A libérer avec freePartition.
+ */
+t_partition expandQuotientClasses(const t_partition *qpart, const t_lumping *L,
+                                  const t_partition *part);
+
+/**
+ * @brief Libère la mémoire d'une partition agrégeable.
+ */
+void freeLumping(t_lumping *L);
+
+#endif // LUMPING_H
@@ -0,0 +1,184 @@
+#ifndef MARKOV_H
+#define MARKOV_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "hasse.h"
+#include "matrix.h"
+#include "absorption.h"
+#include "sparse.h"
+#include "kstep.h"
+
+/**
+ * @brief Contexte d'analyse de libmarkov (opaque). Il possède la chaîne et les
+ * résultats calculés à la demande (partition, liens, matrices...), conservés
+ * jusqu'au chargement suivant, ainsi que des tampons de travail réutilisés
+ * d'une chaîne à l'autre.
+ * Un contexte ne doit pas être utilisé par plusieurs threads pendant un
+ * calcul ; après markovPrepare, la lecture des résultats préparés peut se
+ * faire depuis plusieurs threads.
+ */
+typedef struct s_markov_context t_markov_context;
+
+/**
+ * @brief Résultats que markovPrepare calcule d'avance.
+ */
+typedef enum {
+    MARKOV_CLASSES      = 1 << 0,   /**< Partition, liens de Hasse, nature des classes. */
+    MARKOV_PERIODS      = 1 << 1,
+    MARKOV_STATIONARY   = 1 << 2,   /**< Distribution exacte de chaque classe persistante. */
+    MARKOV_ABSORPTION   = 1 << 3,
+    MARKOV_MATRIX       = 1 << 4,   /**< Matrice de transition dense. */
+    MARKOV_CSR          = 1 << 5,   /**< Matrice de transition creuse. */
+    MARKOV_ALL          = (1 << 6) - 1
+} t_markov_result;
+
+/**
+ * @brief Résumé d'une chaîne (voir markovSummary).
+ */
+typedef struct {
+    int nb_vertices;
+    int nb_arcs;
+    int valid;                  /**< 1 si la matrice est stochastique (génératrice pour une chaîne continue). */
+    int nb_classes;
+    int nb_transient;           /**< Nombre de classes transitoires. */
+    int irreducible;
+} t_markov_summary;
+
+/**
+ * @brief Crée un contexte vide.
+ */
+t_markov_context *markovCreate(void);
+
+/**
+ * @brief Libère le contexte, la chaîne et tous les résultats.
+ */
+void markovFree(t_markov_context *ctx);
+
+/**
+ * @brief Oublie la chaîne et ses résultats ; les tampons de travail sont gardés.
+ */
+void markovClear(t_markov_context *ctx);
+
+/**
+ * @brief Charge la chaîne de filename (texte ou binaire, voir readGraph) ;
+ * continuous : le fichier donne les taux d'un générateur. Renvoie 0 (message
+ * sur stderr) si le fichier ne peut pas être lu.
+ */
+int markovLoadFile(t_markov_context *ctx, const char *filename, int continuous);
+
+/**
+ * @brief Donne au contexte la chaîne g (le contexte en devient propriétaire).
+ */
+void markovSetGraph(t_markov_context *ctx, t_graph *g);
+
+/**
+ * @brief Remplace le générateur chargé par la chaîne uniformisée
+ * P = I + Q / lambda et renvoie lambda (0 si la chaîne n'est pas continue).
+ */
+double markovUniformize(t_markov_context *ctx);
+
+/**
+ * @brief Calcule d'avance les résultats demandés (combinaison de t_markov_result).
+ */
+void markovPrepare(t_markov_context *ctx, int results);
+
+/**
+ * @brief Chaîne chargée (NULL si aucune).
+ */
+const t_graph *markovGraph(const t_markov_context *ctx);
+
+/**
+ * @brief Taille, validité et classes de la chaîne (calcule la partition).
+ */
+void markovSummary(t_markov_context *ctx, t_markov_summary *summary);
+
+/**
+ * @brief Partition en classes (ordre de Tarjan).
+ */
+const t_partition *markovPartition(t_markov_context *ctx);
+
+/**
+ * @brief Liens entre classes après réduction transitive (diagramme de Hasse).
+ */
+const t_link_array *markovLinks(t_markov_context *ctx);
+
+/**
+ * @brief Nature de chaque classe (indices de markovPartition).
+ */
+const t_class_kind *markovClassKinds(t_markov_context *ctx);
+
+/**
+ * @brief Classe (indice dans la partition) de chaque sommet v+1.
+ */
+const int *markovVertexClass(t_markov_context *ctx);
+
+/**
+ * @brief Période de chaque classe.
+ */
+const int *markovPeriods(t_markov_context *ctx);
+
+/**
+ * @brief Distribution stationnaire exacte de la classe ci, dans l'ordre de ses
+ * sommets (NULL pour une classe transitoire).
+ */
+const float *markovStationary(t_markov_context *ctx, int ci);
+
+/**
+ * @brief Probabilité stationnaire du sommet v (1..n) dans sa classe (0 si transitoire).
+ */
+float markovStationaryAt(t_markov_context *ctx, int v);
+
+/**
+ * @brief Probabilités d'absorption et temps moyens d'atteinte.
+ */
+const t_absorption *markovAbsorption(t_markov_context *ctx);
+
+/**
+ * @brief Matrice de transition dense.
+ */
+const t_matrix *markovMatrix(t_markov_context *ctx);
+
+/**
+ * @brief Matrice de transition creuse (CSR).
+ */
+const t_csr_matrix *markovCsr(t_markov_context *ctx);
+
+/**
+ * @brief Plafonne le cache de puissances de markovPower à max_bytes octets
+ * (0 : aucun plafond) ; au-delà, les puissances les moins récemment utilisées
+ * sont évincées. Le plafond est gardé d'une chaîne à l'autre.
+ */
+void markovSetPowerCacheLimit(t_markov_context *ctx, size_t max_bytes);
+
+/**
+ * @brief Copie de M^k (à libérer avec freeMatrix) ; les carrés intermédiaires
+ * restent en cache dans le contexte pour les appels suivants.
+ */
+t_matrix markovPower(t_markov_context *ctx, int k);
+
+/**
+ * @brief out = pi0 * P^k (vecteurs de n éléments) par k produits creux, avec
+ * les vecteurs de travail du contexte.
+ */
+void markovDistribution(t_markov_context *ctx, const double *pi0, long k, double *out);
+
+/**
+ * @brief Distributions pi_b * P^k d'un lot de batch vecteurs initiaux (initial :
+ * batch x n, ligne par ligne) pour chaque horizon de la liste, transmises à
+ * callback dans l'ordre croissant des horizons (voir batchDistributionsStream).
+ * Ne lit que la matrice creuse : appelable depuis plusieurs threads après
+ * markovPrepare(ctx, MARKOV_CSR).
+ */
+void markovBatchDistributionsStream(t_markov_context *ctx, const float *initial, int batch,
+                                    const int *horizons, int nb_horizons, int nb_threads,
+                                    t_kstep_callback callback, void *user);
+
+/**
+ * @brief Même calcul, en conservant les distributions de chaque horizon (à
+ * libérer avec freeKStepResult ; résultat vide si aucune chaîne n'est chargée).
+ */
+t_kstep_result markovBatchDistributions(t_markov_context *ctx, const float *initial, int batch,
+                                        const int *horizons, int nb_horizons, int nb_threads);
+
+#endif // MARKOV_H
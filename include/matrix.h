@@ -13,6 +13,33 @@ typedef struct {
     float **data;
 } t_matrix;
 
+/**
+ * @brief Vue sur une sous-matrice carrée, sans recopie des coefficients :
+ * matrice parente et liste des sommets retenus (1..n, par exemple ceux d'une classe).
+ * vertices == NULL désigne la matrice parente entière.
+ */
+typedef struct {
+    const t_matrix *parent;
+    const int *vertices;
+    int size;
+} t_matrix_view;
+
+/**
+ * @brief Ligne i de la vue, dans l'indexation de la matrice parente.
+ */
+static inline const float *viewRow(const t_matrix_view *V, int i)
+{
+    return V->parent->data[V->vertices ? V->vertices[i] - 1 : i];
+}
+
+/**
+ * @brief Coefficient (i,j) de la vue (indices locaux 0..size-1).
+ */
+static inline float viewAt(const t_matrix_view *V, int i, int j)
+{
+    return viewRow(V, i)[V->vertices ? V->vertices[j] - 1 : j];
+}
+
 /**
  * @brief Crée une matrice n x n initialisée à 0.
  */
@@ -43,6 +70,24 @@ void multiplyMatrices(const t_matrix *A, const t_matrix *B, t_matrix *C);
  */
 float diffMatrices(const t_matrix *M, const t_matrix *N);
 
+/**
+ * @brief Calcule C = A * B où B est lu à travers une vue.
+ */
+void multiplyMatrixView(const t_matrix *A, const t_matrix_view *B, t_matrix *C);
+
+/**
+ * @brief Noyau fusionné : calcule les lignes [row_begin, row_end) de C = A * B et
+ * renvoie, accumulée dans le même balayage, la somme des |a_ij - c_ij| sur ces lignes.
+ */
+float multiplyAndDiffRows(const t_matrix *A, const t_matrix *B, t_matrix *C,
+                          int row_begin, int row_end);
+
+/**
+ * @brief Noyau fusionné avec B lu à travers une vue.
+ */
+float multiplyAndDiffRowsView(const t_matrix *A, const t_matrix_view *B, t_matrix *C,
+                              int row_begin, int row_end);
+
 /**
  * @brief Affiche une matrice avec un nom.
  */
@@ -53,10 +98,30 @@ void printMatrix(const t_matrix *M, const char *name);
  */
 t_matrix matrixPower(const t_matrix *M, int power);
 
+/**
+ * @brief Calcule V^power pour une vue.
+ */
+t_matrix matrixPowerView(const t_matrix_view *V, int power);
+
+/**
+ * @brief Vue couvrant toute la matrice M.
+ */
+t_matrix_view fullMatrixView(const t_matrix *M);
+
+/**
+ * @brief Vue sur la sous-matrice d'une classe (aucune recopie).
+ */
+t_matrix_view classMatrixView(const t_matrix *M, const t_partition *part, int compo_index);
+
+/**
+ * @brief Recopie une vue dans un bloc contigu (à libérer avec freeMatrix).
+ */
+t_matrix gatherView(const t_matrix_view *V);
+
 /**
  * @brief Extrait la sous-matrice correspondant à une classe donnée.
  */
-t_matrix subMatrix(t_matrix matrix, t_partition part, int compo_index);
+t_matrix subMatrix(const t_matrix *matrix, const t_partition *part, int compo_index);
 
 /**
  * @brief Itère les puissances de M jusqu'à ce que diff(M^n, M^(n-1)) < eps
@@ -65,8 +130,19 @@ t_matrix subMatrix(t_matrix matrix, t_partition part, int compo_index);
 t_matrix iterateUntilStationary(const t_matrix *M, float eps, int max_iter, int *power_out);
 
 /**
- * @brief Calcule la période d'une classe (matrice de transition de la sous-chaîne).
+ * @brief Même itération, la matrice étant lue à travers une vue.
+ */
+t_matrix iterateUntilStationaryView(const t_matrix_view *V, float eps, int max_iter, int *power_out);
+
+/**
+ * @brief Calcule la période d'une classe (matrice de transition de la sous-chaîne)
+ * par parcours en largeur sur les coefficients non nuls (voir period.h).
+ */
+int getPeriod(const t_matrix *sub_matrix);
+
+/**
+ * @brief Calcule la période d'une vue (même parcours en largeur).
  */
-int getPeriod(t_matrix sub_matrix);
+int getPeriodView(const t_matrix_view *V);
 
 #endif // MATRIX_H
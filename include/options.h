@@ -0,0 +1,69 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "output.h"
+#include "writer.h"
+
+/**
+ * @brief Etapes de l'analyse, sélectionnables par --stages.
+ */
+typedef enum {
+    STAGE_GRAPH         = 1 << 0,   /**< Liste d'adjacence, vérification, export Mermaid. */
+    STAGE_CLASSES       = 1 << 1,   /**< Partition, diagramme de Hasse, caractéristiques. */
+    STAGE_POWERS        = 1 << 2,   /**< M et ses puissances. */
+    STAGE_LIMIT         = 1 << 3,   /**< Matrice limite exacte. */
+    STAGE_DISTRIBUTIONS = 1 << 4,   /**< Distributions stationnaires et périodes par classe. */
+    STAGE_ABSORPTION    = 1 << 5,   /**< Probabilités d'absorption et temps moyens. */
+    STAGE_SIMULATION    = 1 << 6,   /**< Simulation de Monte Carlo. */
+    STAGE_KSTEP         = 1 << 7,   /**< Distributions à k pas depuis des états donnés. */
+    STAGE_ALL           = (1 << 8) - 1,
+    STAGE_DEFAULT       = STAGE_ALL & ~(STAGE_SIMULATION | STAGE_KSTEP)  /**< Sans --stages : simulation et k pas sont à demander. */
+} t_stage;
+
+#define MAX_POWERS 16
+#define MAX_KSTEP 16
+
+/**
+ * @brief Options de la ligne de commande.
+ */
+typedef struct {
+    const char *filename;
+    int stages;                     /**< Combinaison de t_stage. */
+    t_print_options print;
+    t_output_format format;         /**< Format des résultats (--format). */
+    const char *output;             /**< Fichier de sortie (NULL : sortie standard). */
+    int powers[MAX_POWERS];         /**< Puissances de M affichées. */
+    int nb_powers;
+    size_t power_cache_bytes;       /**< Plafond du cache de puissances (--power-cache ; 0 : aucun). */
+    int lump;
+    int ctmc;
+    double horizon;                 /**< Temps t de la distribution transitoire (--ctmc). */
+    int sim_start;                  /**< État initial des trajectoires (--sim-start). */
+    long sim_walks;                 /**< Nombre de trajectoires (--sim-walks). */
+    int sim_steps;                  /**< Longueur maximale d'une trajectoire (--sim-steps). */
+    unsigned long long sim_seed;    /**< Graine de la simulation (--sim-seed). */
+    int sim_bins;                   /**< Classes de l'histogramme des temps d'atteinte (--sim-bins). */
+    int kstep[MAX_KSTEP];           /**< Horizons des distributions à k pas (--kstep). */
+    int nb_kstep;
+    int kstep_from[MAX_KSTEP];      /**< États initiaux des distributions à k pas (--kstep-from). */
+    int nb_kstep_from;
+    const char *out_of_core;        /**< Répertoire des matrices tuilées (NULL : en mémoire). */
+    const char *batch;              /**< Répertoire ou liste de fichiers du mode --batch (NULL : un seul fichier). */
+    const char *batch_dir;          /**< Répertoire des résultats du mode --batch. */
+    int jobs;                       /**< Threads des modes --batch et --serve (<= 0 : nombre de processeurs). */
+    const char *serve;              /**< Socket Unix du mode serveur (NULL : analyse directe). */
+    int counters;                   /**< Compteurs matériels par noyau sur stderr : 0 aucun, 1 tableau, 2 JSON. */
+    int stats;                      /**< Mesures par étape sur stderr : 0 aucune, 1 tableau, 2 JSON. */
+} t_options;
+
+/**
+ * @brief Lit les options ; renvoie 0 (après un message sur stderr) si elles sont invalides.
+ */
+int parseOptions(int argc, char **argv, t_options *opt);
+
+/**
+ * @brief Affiche l'aide sur stderr.
+ */
+void printUsage(const char *program);
+
+#endif // OPTIONS_H
@@ -0,0 +1,56 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+/**
+ * @brief Niveau de détail des matrices et vecteurs affichés.
+ */
+typedef enum {
+    PRINT_FULL,         /**< Tous les coefficients. */
+    PRINT_TOPK,         /**< Les k plus grands coefficients, avec leurs indices. */
+    PRINT_SUMMARY       /**< Statistiques seulement. */
+} t_print_mode;
+
+/**
+ * @brief Options d'affichage ; un pointeur NULL équivaut à PRINT_FULL.
+ */
+typedef struct {
+    t_print_mode mode;
+    int topk;
+} t_print_options;
+
+/**
+ * @brief Indices des k plus grandes valeurs de values[0..n), par valeur
+ * décroissante (tas de taille k, O(n log k)). Renvoie le nombre d'indices écrits.
+ */
+int topKIndices(const float *values, int n, int k, int *out);
+
+/**
+ * @brief Lecteur de lignes : renvoie la ligne i (valable jusqu'à l'appel suivant).
+ * Permet de parcourir une matrice dense, permutée ou hors mémoire de la même façon.
+ */
+typedef const float *(*t_row_reader)(void *arg, int i);
+
+/**
+ * @brief Les k plus grands coefficients non nuls des lignes lues par read,
+ * par valeur décroissante : row[t], col[t] (0..n-1) et value[t]. Renvoie le
+ * nombre de coefficients écrits.
+ */
+int topKRowEntries(t_row_reader read, void *arg, int rows, int cols, int k,
+                   int *row, int *col, float *value);
+
+/**
+ * @brief Statistiques d'une matrice : coefficients non nuls, maximum, et bornes des sommes de lignes.
+ */
+typedef struct {
+    long nnz;
+    float max;
+    float min_row_sum;
+    float max_row_sum;
+} t_matrix_summary;
+
+/**
+ * @brief Calcule les statistiques des lignes lues par read (indépendantes de l'ordre des lignes).
+ */
+t_matrix_summary summarizeRows(t_row_reader read, void *arg, int rows, int cols);
+
+#endif // OUTPUT_H
@@ -0,0 +1,62 @@
+#ifndef PERIOD_H
+#define PERIOD_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "matrix.h"
+
+/**
+ * @brief Résultat de l'analyse d'une classe périodique (période d > 1).
+ * Les vecteurs sont indexés dans l'ordre de la classe (c->vertices).
+ */
+typedef struct {
+    int period;             /**< Période d de la classe. */
+    int size;               /**< Nombre de sommets de la classe. */
+    int *phase;             /**< Sous-classe cyclique (0..d-1) de chaque sommet. */
+    int power;              /**< Puissance n atteinte sur le bloc de P^d. */
+    float *cesaro;          /**< Distribution limite au sens de Cesàro. */
+    float **phase_limits;   /**< phase_limits[s] : limite de P^(nd+s) depuis la sous-classe 0. */
+} t_cyclic_analysis;
+
+/**
+ * @brief Calcule la période d'une classe directement sur son sous-graphe :
+ * parcours en largeur depuis un sommet, puis pgcd des level[u] + 1 - level[v]
+ * sur tous les arcs internes à la classe. Coût O(V+E) de la classe.
+ * Renvoie 0 pour une classe sans arc interne (sommet isolé sans boucle).
+ * Si phase_out n'est pas NULL, il reçoit la sous-classe cyclique (level mod d)
+ * de chaque sommet, dans l'ordre de part->classes[compo_index].vertices.
+ */
+int getClassPeriod(const t_graph *g, const t_partition *part, const int *vertex_to_class,
+                   int compo_index, int *phase_out);
+
+/**
+ * @brief Calcule la période de toutes les classes en un seul passage sur le graphe.
+ * Renvoie un tableau de taille part->size, à libérer par l'appelant.
+ */
+int *getAllPeriods(const t_graph *g, const t_partition *part);
+
+/**
+ * @brief Décompose une classe de période d en ses d sous-classes cycliques et
+ * itère sur le bloc de P^d associé à la sous-classe 0, qui est apériodique.
+ * Les limites par phase s'en déduisent par pi_s = pi_(s-1) * P, et la
+ * distribution de Cesàro est leur moyenne. Pour d <= 1, seule la période est remplie.
+ */
+t_cyclic_analysis analyzeCyclicClass(const t_graph *g, const t_matrix *M, const t_partition *part,
+                                     const int *vertex_to_class, int compo_index,
+                                     float eps, int max_iter);
+
+/**
+ * @brief Même analyse à partir d'une vue sur la sous-matrice de la classe
+ * et de ses phases (calculées par getClassPeriod). Les sous-classes sont
+ * renumérotées pour que le sommet d'indice origin soit dans la sous-classe 0,
+ * et les limites par phase partent de ce sommet.
+ */
+t_cyclic_analysis analyzeCyclicView(const t_matrix_view *V, const int *phase, int period,
+                                    int origin, float eps, int max_iter);
+
+/**
+ * @brief Libère la mémoire d'une analyse de classe périodique.
+ */
+void freeCyclicAnalysis(t_cyclic_analysis *a);
+
+#endif // PERIOD_H
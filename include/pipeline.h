@@ -0,0 +1,48 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "matrix.h"
+#include "period.h"
+
+/**
+ * @brief Résultats de l'analyse d'une classe (partie 3).
+ */
+typedef struct {
+    int size;                   /**< Nombre de sommets de la classe. */
+    int period;                 /**< Période de la classe. */
+    int power;                  /**< Puissance n atteinte (sur P^d si la classe est périodique). */
+    double rate;                /**< Taux de convergence estimé (|lambda2| ou rayon spectral). */
+    int budget;                 /**< Itérations permises : max_iter, ou le budget déduit de rate s'il est plus grand. */
+    int converged;              /**< 0 si le budget est épuisé avant que diff < eps. */
+    float *distribution;        /**< Ligne du sommet de départ dans la limite, ou distribution de Cesàro si période > 1. */
+    t_cyclic_analysis cyclic;   /**< Sous-classes cycliques et limites par phase (période > 1). */
+} t_class_result;
+
+/**
+ * @brief Analyse toutes les classes en parallèle sur un pool à vol de tâches.
+ * Chaque classe est extraite du graphe en un bloc dense k x k (la matrice n x n
+ * n'est pas nécessaire), puis période et distribution stationnaire sont traitées comme des tâches distinctes. Les
+ * petites classes sont regroupées en lots, les grandes voient leurs produits
+ * matriciels découpés par blocs de lignes.
+ * max_iter est le budget d'itérations par défaut (sur le bloc de P^d pour une
+ * classe périodique). Pour une classe apériodique qui mélange lentement, le
+ * budget prédit à partir du trou spectral estimé le remplace s'il est plus
+ * grand, dans la limite d'un plafond de sécurité (10000 itérations). Une classe
+ * dont le budget s'épuise avant convergence a converged à 0.
+ * origin[ci] est l'indice, dans la classe ci, du sommet de départ : sa ligne
+ * de la limite est retenue, et il est dans la sous-classe cyclique 0 (NULL :
+ * premier sommet de chaque classe).
+ * nb_threads <= 0 : nombre de processeurs en ligne.
+ * Renvoie un tableau de part->size résultats, dans l'ordre des classes.
+ */
+t_class_result *runClassPipeline(const t_graph *g, const t_partition *part, const int *origin,
+                                 int nb_threads, float eps, int max_iter);
+
+/**
+ * @brief Libère le tableau renvoyé par runClassPipeline.
+ */
+void freeClassResults(t_class_result *results, int nb_classes);
+
+#endif // PIPELINE_H
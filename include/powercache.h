@@ -0,0 +1,49 @@
+#ifndef POWERCACHE_H
+#define POWERCACHE_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+/**
+ * @brief Puissance de M conservée par le cache.
+ */
+typedef struct {
+    int exponent;
+    t_matrix m;
+    int pinned;                 /**< En cours d'utilisation : ne pas évincer. */
+    unsigned long last_use;
+} t_power_entry;
+
+/**
+ * @brief Cache de puissances d'une matrice : les carrés M^(2^i) sont calculés à
+ * la demande et conservés, comme les puissances déjà demandées. Toute puissance
+ * M^k se déduit de la plus grande puissance en cache <= k et des carrés.
+ * Au-delà de max_bytes, les entrées les moins récemment utilisées sont évincées.
+ */
+typedef struct {
+    const t_matrix *base;       /**< M (non possédée). */
+    t_power_entry **entries;
+    int size;
+    int capacity;
+    size_t max_bytes;           /**< 0 : pas de limite. */
+    size_t bytes;
+    unsigned long clock;
+    int multiplications;        /**< Produits matriciels effectués depuis la création. */
+} t_power_cache;
+
+/**
+ * @brief Initialise un cache vide pour la matrice M.
+ */
+void initPowerCache(t_power_cache *cache, const t_matrix *M, size_t max_bytes);
+
+/**
+ * @brief Libère toutes les puissances conservées.
+ */
+void freePowerCache(t_power_cache *cache);
+
+/**
+ * @brief Renvoie une copie de M^k (à libérer avec freeMatrix).
+ */
+t_matrix powerCacheGet(t_power_cache *cache, int k);
+
+#endif // POWERCACHE_H
@@ -0,0 +1,66 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "matrix.h"
+#include "absorption.h"
+#include "pipeline.h"
+
+/**
+ * @brief Renumérotation des états (identifiants 1..n).
+ */
+typedef struct {
+    int n;
+    int *order;         /**< order[i] : ancien identifiant du nouvel état i+1. */
+    int *position;      /**< position[v] : nouvel identifiant de l'ancien état v+1. */
+} t_permutation;
+
+/**
+ * @brief Ordre par blocs triangulaires : les classes sont rangées dans l'ordre
+ * topologique (inverse de l'ordre de Tarjan), de sorte que M devient triangulaire
+ * supérieure par blocs, et les états de chaque classe sont rangés par
+ * Cuthill-McKee inverse pour réduire la largeur de bande de chaque bloc.
+ */
+t_permutation blockTriangularOrder(const t_graph *g, const t_partition *part);
+
+/**
+ * @brief Libère la mémoire d'une permutation.
+ */
+void freePermutation(t_permutation *p);
+
+/**
+ * @brief Renvoie une copie du graphe avec les états renumérotés.
+ */
+t_graph *permuteGraph(const t_graph *g, const t_permutation *p);
+
+/**
+ * @brief Renvoie une copie de la partition avec les états renumérotés.
+ * Les classes gardent leur indice et leur nom ; les sommets de chaque classe
+ * sont rangés par nouvel identifiant croissant (accès contigus dans les blocs).
+ * Les résultats par classe se ramènent à l'ordre d'origine par unpermuteClassResults.
+ */
+t_partition permutePartition(const t_partition *part, const t_permutation *p);
+
+/**
+ * @brief Renvoie le résultat d'absorption dans la numérotation d'origine.
+ */
+t_absorption unpermuteAbsorption(const t_absorption *abs, const t_permutation *p);
+
+/**
+ * @brief Pour chaque classe, indice dans la classe de ppart (= permutePartition(part, p))
+ * du premier sommet de la classe de part : sommet de départ de runClassPipeline,
+ * pour que ses résultats portent sur la même ligne que dans l'ordre d'origine.
+ * Tableau de part->size entiers, à libérer par l'appelant.
+ */
+int *permutedClassOrigins(const t_partition *part, const t_partition *ppart, const t_permutation *p);
+
+/**
+ * @brief Ramène les résultats de runClassPipeline calculés sur ppart
+ * (= permutePartition(part, p)) à l'ordre des sommets des classes de part :
+ * distributions, Cesàro, phases et limites par phase.
+ */
+void unpermuteClassResults(t_class_result *results, const t_partition *part,
+                           const t_partition *ppart, const t_permutation *p);
+
+#endif // REORDER_H
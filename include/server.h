@@ -0,0 +1,35 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "options.h"
+
+/**
+ * @brief Mode --serve : serveur résident sur la socket Unix opt->serve.
+ * Chaque chaîne chargée garde en mémoire sa partition, ses liens entre classes,
+ * les distributions stationnaires exactes de ses classes persistantes, ses
+ * probabilités d'absorption et sa matrice creuse ; les requêtes ne font
+ * ensuite que des lectures. Les requêtes sont servies en parallèle par un
+ * pool de opt->jobs threads (une connexion inactive n'occupe aucun thread) ;
+ * un chargement se fait hors verrou et ne bloque les lecteurs que le temps de
+ * publier la chaîne, et une requête ne bloque pas les chargements.
+ *
+ * Protocole : une requête par ligne, une réponse par ligne ("OK ..." ou "ERR message").
+ *   LOAD nom fichier      OK nom etats classes
+ *   UNLOAD nom            OK
+ *   LIST                  OK nom1 nom2 ...
+ *   INFO nom              OK etats=n arcs=m markov=0|1 classes=c transitoires=t irreductible=0|1
+ *   CLASS nom etat        OK C2 persistante|transitoire|absorbant
+ *   STATIONARY nom etat   OK p (distribution stationnaire de la classe de l'état ; 0 si transitoire)
+ *   KSTEP nom etat k      OK v:p ... (distribution après k pas depuis etat, coefficients non nuls ;
+ *                         k <= 10000)
+ *   ABSORB nom etat       OK pas=x C1:p ... (temps moyen et probabilités d'absorption non nulles)
+ *   QUIT                  ferme la connexion
+ *   SHUTDOWN              arrête le serveur : les requêtes en cours se terminent,
+ *                         les connexions ouvertes sont fermées
+ *
+ * Si opt->filename est donné, la chaîne est chargée au démarrage sous le nom
+ * de son fichier sans extension. Renvoie 0, ou -1 si la socket n'a pas pu être ouverte.
+ */
+int runServer(const t_options *opt);
+
+#endif // SERVER_H
@@ -0,0 +1,70 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdint.h>
+#include "graph.h"
+
+/**
+ * @brief Tables d'alias de Walker : un tirage de transition en O(1) par état.
+ * Les entrées de l'état i occupent [row_ptr[i], row_ptr[i+1]).
+ */
+typedef struct {
+    int n;
+    int *row_ptr;
+    float *threshold;   /**< Seuil : on garde dest si u < threshold, sinon alias. */
+    int *dest;          /**< Destination principale (0..n-1). */
+    int *alias;         /**< Destination alternative (0..n-1). */
+} t_alias_tables;
+
+/**
+ * @brief Paramètres d'une simulation de trajectoires.
+ */
+typedef struct {
+    int start;              /**< État initial (1..n). */
+    const int *targets;     /**< targets[v] = 1 si le sommet v+1 est une cible (peut être NULL). */
+    int stop_on_hit;        /**< Arrêter une trajectoire dès qu'elle atteint une cible. */
+    long nb_walks;          /**< Nombre de trajectoires indépendantes. */
+    int max_steps;          /**< Longueur maximale d'une trajectoire. */
+    int nb_threads;         /**< Threads de calcul (<= 0 : nombre de processeurs). */
+    uint64_t seed;          /**< Graine : résultats identiques quel que soit nb_threads. */
+    int nb_bins;            /**< Nombre de classes de l'histogramme des temps d'atteinte. */
+} t_simulation_params;
+
+/**
+ * @brief Résultats agrégés d'une simulation.
+ */
+typedef struct {
+    int n;
+    long nb_walks;
+    uint64_t total_steps;   /**< Nombre total de visites comptées. */
+    uint64_t *visits;       /**< visits[v] : nombre de passages par le sommet v+1 (instant 0 compris). */
+    long nb_hits;           /**< Trajectoires ayant atteint une cible. */
+    double mean_hitting_time;
+    int nb_bins;
+    int bin_width;
+    uint64_t *histogram;    /**< histogram[b] : temps d'atteinte dans [b*bin_width, (b+1)*bin_width). */
+} t_simulation_result;
+
+/**
+ * @brief Construit les tables d'alias de chaque état (algorithme de Vose).
+ */
+t_alias_tables buildAliasTables(const t_graph *g);
+
+/**
+ * @brief Libère la mémoire des tables d'alias.
+ */
+void freeAliasTables(t_alias_tables *t);
+
+/**
+ * @brief Simule nb_walks trajectoires en parallèle. Chaque trajectoire w tire ses
+ * nombres dans son propre flux (générateur à compteur indexé par seed et w), ce qui
+ * rend les résultats reproductibles et indépendants du découpage entre threads.
+ */
+t_simulation_result simulateWalks(const t_alias_tables *tables, const t_simulation_params *params);
+
+/**
+ * @brief Libère la mémoire d'un résultat de simulation.
+ */
+void freeSimulationResult(t_simulation_result *res);
+
+#endif // SIMULATION_H
@@ -0,0 +1,57 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include "graph.h"
+#include "matrix.h"
+
+/**
+ * @brief Matrice creuse au format CSR (lignes compressées), indices 0..n-1.
+ */
+typedef struct {
+    int n;              /**< Dimension (matrice carrée). */
+    int nnz;            /**< Nombre de coefficients non nuls. */
+    int *row_ptr;       /**< Début de chaque ligne dans col_idx/values (taille n+1). */
+    int *col_idx;       /**< Colonne de chaque coefficient. */
+    float *values;      /**< Valeur de chaque coefficient. */
+} t_csr_matrix;
+
+/**
+ * @brief Construit la matrice de transition creuse d'un graphe.
+ */
+t_csr_matrix csrFromGraph(const t_graph *g);
+
+/**
+ * @brief Construit la matrice creuse des coefficients non nuls d'une vue.
+ */
+t_csr_matrix csrFromView(const t_matrix_view *V);
+
+/**
+ * @brief Libère la mémoire d'une matrice creuse.
+ */
+void freeCsr(t_csr_matrix *A);
+
+/**
+ * @brief Produit vecteur ligne x matrice : y = x * A (x et y de taille n).
+ */
+void csrLeftMultiply(const double *x, const t_csr_matrix *A, double *y);
+
+/**
+ * @brief Produit matrice x vecteur colonne : y = A * x (x et y de taille n).
+ */
+void csrRightMultiply(const t_csr_matrix *A, const double *x, double *y);
+
+/**
+ * @brief Renvoie la transposée de A (utile pour calculer x * A colonne par colonne).
+ */
+t_csr_matrix csrTranspose(const t_csr_matrix *A);
+
+/**
+ * @brief Produit creux x bloc dense (SpMM) : Y = X * A, restreint aux colonnes
+ * [col_begin, col_end) de A. X et Y sont rangés état par état : X[i * batch + b]
+ * est la composante i du b-ième vecteur. AT est la transposée de A (csrTranspose),
+ * ce qui permet d'écrire chaque ligne de Y sans conflit entre threads.
+ */
+void csrBlockMultiply(const float *X, int batch, const t_csr_matrix *AT, float *Y,
+                      int col_begin, int col_end);
+
+#endif // SPARSE_H
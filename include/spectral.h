@@ -0,0 +1,29 @@
+#ifndef SPECTRAL_H
+#define SPECTRAL_H
+
+#include "sparse.h"
+
+/**
+ * @brief Estimation spectrale d'une classe (matrice de transition de la sous-chaîne).
+ */
+typedef struct {
+    double rho;         /**< Rayon spectral estimé (1 pour une classe stochastique). */
+    double lambda2;     /**< Module estimé de la deuxième valeur propre. */
+    double rate;        /**< Taux de décroissance dominant de diff(M^n, M^(n-1)). */
+    int iterations;     /**< Nombre total d'itérations de la puissance effectuées. */
+} t_spectral_estimate;
+
+/**
+ * @brief Estime rho puis |lambda2| par itérations de la puissance sur la structure
+ * creuse : les vecteurs propres dominants à gauche (u) et à droite (v) servent à
+ * déflater une troisième itération, dont la décroissance donne |lambda2|.
+ */
+t_spectral_estimate estimateSpectralGap(const t_csr_matrix *P, int max_iter, double tol);
+
+/**
+ * @brief Prédit le nombre de puissances n pour que diff(M^n, M^(n-1)) < eps sur une
+ * classe de taille size, avec une marge de sécurité. Résultat borné à [2, cap].
+ */
+int predictIterations(const t_spectral_estimate *est, int size, float eps, int cap);
+
+#endif // SPECTRAL_H
@@ -0,0 +1,107 @@
+#ifndef SYNTH_H
+#define SYNTH_H
+
+#include <stdint.h>
+#include "graph.h"
+
+/**
+ * @brief Familles de chaînes synthétiques (bancs d'essai et générateur).
+ */
+typedef enum {
+    SYNTH_RANDOM_SPARSE,    /**< Arcs aléatoires, degré sortant constant (SYNTH_SPARSE_DEGREE). */
+    SYNTH_LONG_CYCLE,       /**< Un seul cycle 1 -> 2 -> ... -> n -> 1 (période n). */
+    SYNTH_ABSORBING,        /**< Moitié d'états absorbants, moitié d'états transitoires. */
+    SYNTH_DEEP_DAG,         /**< i -> i+1, i+2 : n classes transitoires en profondeur, une absorbante. */
+    SYNTH_DENSE_BLOCKS,     /**< Blocs complets de SYNTH_BLOCK_SIZE états reliés en chaîne. */
+    NB_SYNTH_FAMILIES
+} t_synth_family;
+
+#define SYNTH_SPARSE_DEGREE 4
+#define SYNTH_BLOCK_SIZE 32
+
+/**
+ * @brief Nom d'une famille ("random", "cycle", "absorbing", "dag", "blocks").
+ */
+const char *synthFamilyName(t_synth_family family);
+
+/**
+ * @brief Famille correspondant à un nom, ou -1 si le nom est inconnu.
+ */
+int synthFamilyFromName(const char *name);
+
+/**
+ * @brief Engendre une chaîne de n états de la famille donnée. Le résultat ne
+ * dépend que de (family, n, seed) ; les probabilités de chaque ligne somment à 1.
+ */
+t_graph *generateChain(t_synth_family family, int n, uint64_t seed);
+
+/* ================= Modèle paramétré (markov_gen) ================= */
+
+#define SYNTH_MAX_DEGREE 4096
+#define SYNTH_MAX_ROW (SYNTH_MAX_DEGREE + 2)    /**< Arcs aléatoires, raccourci de période et fuite. */
+
+/**
+ * @brief Loi du nombre d'arcs sortants d'un état non absorbant.
+ */
+typedef enum {
+    DEGREE_FIXED,       /**< degree arcs. */
+    DEGREE_UNIFORM,     /**< Uniforme sur 1..2*degree-1. */
+    DEGREE_GEOMETRIC    /**< 1 + loi géométrique, de moyenne degree. */
+} t_degree_dist;
+
+/**
+ * @brief Paramètres du modèle. Les états 1..m sont répartis en nb_classes
+ * classes consécutives de tailles multiples de period ; les états suivants
+ * sont absorbants. Les nb_closed dernières classes sont persistantes, les
+ * autres sont transitoires et ont des arcs vers les états qui les suivent.
+ */
+typedef struct {
+    int nb_states;
+    int degree;                 /**< Degré sortant moyen (arcs de l'anneau compris). */
+    t_degree_dist degree_dist;
+    int nb_classes;
+    int nb_closed;
+    int period;                 /**< Période exacte de chaque classe. */
+    double absorbing;           /**< Fraction d'états absorbants. */
+    double leak;                /**< Probabilité qu'un état transitoire ait un arc hors de sa classe. */
+    uint64_t seed;
+} t_synth_params;
+
+/**
+ * @brief Modèle validé : paramètres et découpage en classes.
+ */
+typedef struct {
+    t_synth_params params;
+    int class_states;           /**< m : états des classes (les autres sont absorbants). */
+    int units;                  /**< Nombre de groupes de period états. */
+} t_synth_model;
+
+/**
+ * @brief Arc d'une ligne engendrée (dest : 1..n).
+ */
+typedef struct {
+    int dest;
+    float proba;
+} t_synth_arc;
+
+/**
+ * @brief Valide les paramètres et calcule le découpage ; renvoie 0 (message
+ * sur stderr) s'ils sont incohérents.
+ */
+int initSynthModel(t_synth_model *model, const t_synth_params *params);
+
+/**
+ * @brief Nombre d'états absorbants du modèle (fraction demandée et états en
+ * surplus qui ne complètent pas une période).
+ */
+int synthAbsorbingStates(const t_synth_model *model);
+
+/**
+ * @brief Engendre la ligne de l'état state (1..n) dans row, triée par
+ * destination, et renvoie le nombre d'arcs (row doit pouvoir en contenir SYNTH_MAX_ROW).
+ * Fonction pure de (paramètres, state) : les lignes peuvent être produites
+ * dans n'importe quel ordre et par plusieurs threads.
+ */
+int synthRow(const t_synth_model *model, int state, t_synth_arc *row);
+
+#endif // SYNTH_H
@@ -0,0 +1,52 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/**
+ * @brief Fonction exécutée par une tâche.
+ */
+typedef void (*t_task_fn)(void *arg);
+
+/**
+ * @brief Groupe de tâches dont on peut attendre la fin (compteur de tâches en cours).
+ * Initialiser pending à 0 avant la première soumission.
+ */
+typedef struct {
+    int pending;
+} t_task_group;
+
+/**
+ * @brief Pool de threads à vol de tâches (opaque).
+ * Chaque thread possède sa file : il dépile ses propres tâches par le bas (LIFO)
+ * et, quand elle est vide, vole les plus anciennes dans la file des autres.
+ */
+typedef struct s_thread_pool t_thread_pool;
+
+/**
+ * @brief Crée un pool de nb_threads threads (<= 0 : nombre de processeurs en ligne).
+ */
+t_thread_pool *pool_create(int nb_threads);
+
+/**
+ * @brief Attend la fin des tâches en cours puis libère le pool.
+ */
+void pool_destroy(t_thread_pool *pool);
+
+/**
+ * @brief Renvoie le nombre de threads du pool.
+ */
+int pool_size(const t_thread_pool *pool);
+
+/**
+ * @brief Soumet une tâche rattachée à un groupe (group peut être NULL).
+ * Appelée depuis un thread du pool, la tâche va dans la file de ce thread.
+ */
+void pool_submit(t_thread_pool *pool, t_task_fn fn, void *arg, t_task_group *group);
+
+/**
+ * @brief Attend que toutes les tâches du groupe soient terminées.
+ * Le thread appelant exécute des tâches en attendant (pas de blocage si
+ * l'appel a lieu depuis une tâche).
+ */
+void pool_wait(t_thread_pool *pool, t_task_group *group);
+
+#endif // THREADPOOL_H
@@ -0,0 +1,90 @@
+#ifndef TILED_H
+#define TILED_H
+
+#include <stddef.h>
+#include "graph.h"
+
+/**
+ * @brief Matrice n x n stockée hors mémoire, par tuiles carrées, dans un fichier
+ * projeté en mémoire (mmap). La tuile (ti,tj) occupe tile*tile floats contigus ;
+ * les tuiles du bord sont complétées par des zéros.
+ */
+typedef struct {
+    int n;              /**< Dimension de la matrice. */
+    int tile;           /**< Côté d'une tuile. */
+    int nb_tiles;       /**< Nombre de tuiles par ligne (et par colonne). */
+    int fd;             /**< Descripteur du fichier de stockage. */
+    float *map;         /**< Projection du fichier. */
+    size_t map_bytes;   /**< Taille de la projection. */
+    char path[512];     /**< Chemin du fichier (supprimé par freeTiledMatrix). */
+} t_tiled_matrix;
+
+/**
+ * @brief Volume d'entrées/sorties entre le cache de tuiles et les fichiers.
+ */
+typedef struct {
+    size_t bytes_read;
+    size_t bytes_written;
+} t_io_stats;
+
+/**
+ * @brief Cache borné de tuiles en mémoire (éviction LRU, écriture différée).
+ */
+typedef struct s_tile_cache t_tile_cache;
+
+/**
+ * @brief Crée une matrice tuilée nulle dans un nouveau fichier du répertoire dir.
+ */
+t_tiled_matrix createTiledMatrix(const char *dir, int n, int tile);
+
+/**
+ * @brief Libère la projection et supprime le fichier de stockage.
+ */
+void freeTiledMatrix(t_tiled_matrix *m);
+
+/**
+ * @brief Construit la matrice de transition tuilée directement depuis le graphe
+ * (sans passer par une matrice dense en mémoire).
+ */
+t_tiled_matrix tiledFromGraph(const t_graph *g, const char *dir, int tile);
+
+/**
+ * @brief Copie la ligne i de T dans row (n floats), sans passer par une matrice dense.
+ */
+void tiledReadRow(const t_tiled_matrix *T, int i, float *row);
+
+/**
+ * @brief Crée un cache d'au plus max_bytes octets (au moins 3 tuiles).
+ */
+t_tile_cache *createTileCache(size_t max_bytes, int tile);
+
+/**
+ * @brief Écrit les tuiles modifiées puis libère le cache.
+ */
+void freeTileCache(t_tile_cache *cache);
+
+/**
+ * @brief Oublie les tuiles de m présentes dans le cache (à appeler avant freeTiledMatrix).
+ */
+void tileCacheInvalidate(t_tile_cache *cache, const t_tiled_matrix *m);
+
+/**
+ * @brief Renvoie les octets lus et écrits par le cache depuis sa création.
+ */
+t_io_stats tileCacheStats(const t_tile_cache *cache);
+
+/**
+ * @brief Calcule C = A * B tuile par tuile à travers le cache, en préchargeant
+ * les tuiles suivantes. Même ordre de sommation que multiplyMatrices, donc
+ * mêmes résultats que le calcul en mémoire.
+ */
+void tiledMultiply(const t_tiled_matrix *A, const t_tiled_matrix *B, t_tiled_matrix *C,
+                   t_tile_cache *cache);
+
+/**
+ * @brief Calcule M^power hors mémoire (mêmes produits successifs que matrixPower).
+ * Les fichiers intermédiaires sont créés dans dir.
+ */
+t_tiled_matrix tiledPower(const t_tiled_matrix *M, int power, const char *dir, t_tile_cache *cache);
+
+#endif // TILED_H
@@ -54,4 +54,9 @@ float *calloc_float_array(int n);
  */
 int *calloc_int_array(int n);
 
+/**
+ * @brief PGCD de deux entiers (signes ignorés), pgcd(0, b) = |b|.
+ */
+int gcd_int(int a, int b);
+
 #endif // UTILS_H
@@ -0,0 +1,132 @@
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdio.h>
+#include "graph.h"
+#include "tarjan.h"
+#include "hasse.h"
+#include "matrix.h"
+#include "output.h"
+#include "pipeline.h"
+#include "absorption.h"
+#include "simulation.h"
+#include "lumping.h"
+#include "tiled.h"
+
+/**
+ * @brief Format des résultats.
+ */
+typedef enum {
+    FORMAT_TEXT,        /**< Texte lisible (affichages historiques). */
+    FORMAT_JSONL,       /**< Un objet JSON par ligne, champ "type" pour l'enregistrement. */
+    FORMAT_BINARY       /**< Flux d'enregistrements binaires (voir writer.c). */
+} t_output_format;
+
+/**
+ * @brief Rédacteur de résultats : un grand tampon vidé par blocs dans le flux
+ * de sortie, et un enregistrement par résultat (partition, classes, matrices...).
+ * En format texte, les enregistrements reprennent les affichages historiques
+ * mais passent eux aussi par le tampon et vont dans le flux du rédacteur.
+ */
+typedef struct s_writer t_writer;
+
+/**
+ * @brief Crée un rédacteur sur out (NULL : détaché, voir writerReset). opt règle le niveau de détail des matrices et vecteurs (NULL : complet).
+ */
+t_writer *createWriter(FILE *out, t_output_format format, const t_print_options *opt);
+
+/**
+ * @brief Vide le tampon et libère le rédacteur (le flux n'est pas fermé).
+ */
+void freeWriter(t_writer *w);
+
+/**
+ * @brief Vide le tampon puis dirige les enregistrements suivants vers out,
+ * traité comme un nouveau flux (en-tête réécrit en format binaire).
+ * Permet de réutiliser le tampon d'un fichier de résultats à l'autre ;
+ * out = NULL détache le rédacteur (rien ne doit être écrit avant le prochain appel).
+ */
+void writerReset(t_writer *w, FILE *out);
+
+/**
+ * @brief Ecrit le contenu du tampon dans le flux.
+ */
+void writerFlush(t_writer *w);
+
+/**
+ * @brief Texte libre (titres, messages), émis seulement en format texte.
+ */
+void writeText(t_writer *w, const char *fmt, ...);
+
+/**
+ * @brief Graphe : liste d'adjacence et vérification (texte), ou taille et validité.
+ */
+void writeGraph(t_writer *w, const t_graph *g, float eps);
+
+/**
+ * @brief Partition en classes.
+ */
+void writePartition(t_writer *w, const t_partition *part);
+
+/**
+ * @brief Caractéristiques des classes (transitoire, persistante, absorbante) et irréductibilité.
+ */
+void writeClassification(t_writer *w, const t_partition *part, const t_link_array *links);
+
+/**
+ * @brief Matrice, dans la numérotation d'origine : si position n'est pas NULL,
+ * la ligne (ou colonne) d'origine v est la ligne position[v]-1 de M, ce qui
+ * évite de recopier la matrice.
+ */
+void writeMatrix(t_writer *w, const t_matrix *M, const int *position, const char *name);
+
+/**
+ * @brief Comme writeMatrix pour une matrice hors mémoire, lue ligne par ligne
+ * dans ses tuiles (aucune matrice dense n'est construite).
+ */
+void writeTiledMatrix(t_writer *w, const t_tiled_matrix *T, const int *position, const char *name);
+
+/**
+ * @brief Comme writeMatrix pour une matrice n x n produite ligne par ligne par
+ * read(arg, i) (lignes stockées, numérotées comme M) : seule une ligne est en mémoire.
+ */
+void writeRowMatrix(t_writer *w, t_row_reader read, void *arg, int n, const int *position, const char *name);
+
+/**
+ * @brief Vecteur nommé ; label sert aux lignes "label[i] = x" du format texte.
+ */
+void writeVector(t_writer *w, const char *name, const char *label, const float *v, int n);
+
+/**
+ * @brief Distributions et périodes de chaque classe.
+ */
+void writeClassResults(t_writer *w, const t_partition *part, const t_class_result *results);
+
+/**
+ * @brief Probabilités d'absorption et temps moyens.
+ */
+void writeAbsorption(t_writer *w, const t_partition *part, const t_absorption *abs);
+
+/**
+ * @brief Résultat de simulation.
+ */
+void writeSimulation(t_writer *w, const t_simulation_result *res);
+
+/**
+ * @brief Partition agrégeable.
+ */
+void writeLumping(t_writer *w, const t_lumping *L);
+
+/**
+ * @brief Classes du quotient (--lump) ramenées aux états (expandQuotientClasses)
+ * avec leur période, constante sur les états de la classe ; results est dans
+ * l'ordre des classes de epart.
+ */
+void writeQuotientClasses(t_writer *w, const t_partition *epart, const t_class_result *results);
+
+/**
+ * @brief Octets lus et écrits par le cache de tuiles (puissances hors mémoire).
+ */
+void writeIoStats(t_writer *w, const t_io_stats *io);
+
+#endif // WRITER_H
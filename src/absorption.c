@@ -0,0 +1,672 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "absorption.h"
+#include "utils.h"
+
+#define SOLVER_TOL 1e-12            /**< Résidu (ou variation) relatif à la convergence. */
+#define SOLVER_MAX_ITER 2000
+#define SOLVER_MAX_SWEEPS 100000
+
+static double *calloc_double_array(size_t n)
+{
+    double *arr = calloc(n > 0 ? n : 1, sizeof(double));
+    if (!arr) {
+        perror("calloc double array");
+        exit(EXIT_FAILURE);
+    }
+    return arr;
+}
+
+/* ================= Blocs creux des classes ================= */
+
+/*
+ * Bloc d'une classe en CSR local (indices 0..k-1 dans l'ordre de la classe) :
+ * arcs internes hors diagonale, la diagonale étant gardée à part.
+ * Transposé, la ligne j liste les arcs i -> j (accès par colonne).
+ */
+typedef struct {
+    int k;
+    size_t *row_ptr;
+    int *col;
+    double *val;
+    double *diag;
+} t_class_block;
+
+/* Bloc des k sommets vertices (1..n) ; local[v] : rang du sommet v+1 dans
+ * vertices, -1 pour les sommets hors du bloc. */
+static void build_class_block(const t_graph *g, const int *vertices, int k, const int *local,
+                              int transpose, t_class_block *b)
+{
+    b->k = k;
+    b->row_ptr = calloc((size_t)k + 1, sizeof(size_t));
+    b->diag = calloc((size_t)(k > 0 ? k : 1), sizeof(double));
+    if (!b->row_ptr || !b->diag) {
+        perror("calloc class block");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < k; ++i) {
+        for (t_arc *cur = g->array[vertices[i] - 1].head; cur; cur = cur->next) {
+            int j = local[cur->dest - 1];
+            if (j < 0) continue;
+            if (j == i) b->diag[i] += cur->proba;
+            else b->row_ptr[(transpose ? j : i) + 1]++;
+        }
+    }
+    for (int i = 0; i < k; ++i) {
+        b->row_ptr[i + 1] += b->row_ptr[i];
+    }
+    size_t nnz = b->row_ptr[k];
+    b->col = malloc(sizeof(int) * (nnz > 0 ? nnz : 1));
+    b->val = malloc(sizeof(double) * (nnz > 0 ? nnz : 1));
+    size_t *fill = malloc(sizeof(size_t) * (size_t)(k > 0 ? k : 1));
+    if (!b->col || !b->val || !fill) {
+        perror("malloc class block");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(fill, b->row_ptr, sizeof(size_t) * (size_t)k);
+    for (int i = 0; i < k; ++i) {
+        for (t_arc *cur = g->array[vertices[i] - 1].head; cur; cur = cur->next) {
+            int j = local[cur->dest - 1];
+            if (j < 0 || j == i) continue;
+            size_t e = fill[transpose ? j : i]++;
+            b->col[e] = transpose ? i : j;
+            b->val[e] = cur->proba;
+        }
+    }
+    free(fill);
+}
+
+static void free_class_block(t_class_block *b)
+{
+    free(b->row_ptr);
+    free(b->col);
+    free(b->val);
+    free(b->diag);
+}
+
+/* Y = (I - Q) X, X et Y rangés par lignes (k x width). */
+static void block_apply(const t_class_block *b, const double *X, double *Y, size_t width)
+{
+    for (int i = 0; i < b->k; ++i) {
+        const double *xi = X + (size_t)i * width;
+        double *yi = Y + (size_t)i * width;
+        double d = 1.0 - b->diag[i];
+        for (size_t p = 0; p < width; ++p) {
+            yi[p] = d * xi[p];
+        }
+        for (size_t e = b->row_ptr[i]; e < b->row_ptr[i + 1]; ++e) {
+            const double *xj = X + (size_t)b->col[e] * width;
+            double q = b->val[e];
+            for (size_t p = 0; p < width; ++p) {
+                yi[p] -= q * xj[p];
+            }
+        }
+    }
+}
+
+/* Z = M^-1 R avec M = (D - L) D^-1 (D - U) : un balayage de Gauss-Seidel
+ * avant puis arrière. Exact quand le bloc est triangulaire (chemins, cycles ouverts). */
+static void block_precondition(const t_class_block *b, const double *R, double *Z, size_t width)
+{
+    for (int i = 0; i < b->k; ++i) {
+        double *zi = Z + (size_t)i * width;
+        memcpy(zi, R + (size_t)i * width, sizeof(double) * width);
+        for (size_t e = b->row_ptr[i]; e < b->row_ptr[i + 1]; ++e) {
+            if (b->col[e] > i) continue;
+            const double *zj = Z + (size_t)b->col[e] * width;
+            double q = b->val[e];
+            for (size_t p = 0; p < width; ++p) {
+                zi[p] += q * zj[p];
+            }
+        }
+        double d = 1.0 - b->diag[i];
+        for (size_t p = 0; p < width; ++p) {
+            zi[p] /= d;
+        }
+    }
+    for (int i = b->k - 1; i >= 0; --i) {
+        double *zi = Z + (size_t)i * width;
+        double d = 1.0 - b->diag[i];
+        for (size_t e = b->row_ptr[i]; e < b->row_ptr[i + 1]; ++e) {
+            if (b->col[e] < i) continue;
+            const double *zj = Z + (size_t)b->col[e] * width;
+            double q = b->val[e] / d;
+            for (size_t p = 0; p < width; ++p) {
+                zi[p] += q * zj[p];
+            }
+        }
+    }
+}
+
+/* dot[p] = somme des U[i][p] * V[i][p] pour les colonnes actives. */
+static void block_dot(const double *U, const double *V, int k, size_t width, const int *active,
+                      double *dot)
+{
+    for (size_t p = 0; p < width; ++p) {
+        dot[p] = 0.0;
+    }
+    for (size_t i = 0; i < (size_t)k; ++i) {
+        for (size_t p = 0; p < width; ++p) {
+            if (active[p]) dot[p] += U[i * width + p] * V[i * width + p];
+        }
+    }
+}
+
+/*
+ * BiCGSTAB préconditionné (à droite) sur les width colonnes à la fois, chaque
+ * colonne avec ses propres scalaires. X contient l'estimation de départ.
+ * Renvoie 1 si toutes les colonnes ont convergé, 0 sinon (arrêt ou itérations épuisées).
+ */
+static int bicgstab_solve(const t_class_block *b, const double *B, double *X, size_t width)
+{
+    size_t size = (size_t)b->k * width;
+    double *r = calloc_double_array(size);
+    double *rh = calloc_double_array(size);
+    double *pv = calloc_double_array(size);
+    double *v = calloc_double_array(size);
+    double *ph = calloc_double_array(size);
+    double *sh = calloc_double_array(size);
+    double *t = calloc_double_array(size);
+    double *scal = calloc_double_array(6 * width);
+    double *rho = scal, *alpha = scal + width, *omega = scal + 2 * width;
+    double *bnorm = scal + 3 * width, *dot = scal + 4 * width, *dot2 = scal + 5 * width;
+    int *active = calloc_int_array((int)width);
+    int ok = 1;
+
+    block_apply(b, X, t, width);
+    for (size_t e = 0; e < size; ++e) {
+        r[e] = rh[e] = B[e] - t[e];
+    }
+    for (size_t p = 0; p < width; ++p) {
+        active[p] = 1;
+        rho[p] = alpha[p] = omega[p] = 1.0;
+    }
+    block_dot(B, B, b->k, width, active, bnorm);
+    block_dot(r, r, b->k, width, active, dot);
+    int remaining = 0;
+    for (size_t p = 0; p < width; ++p) {
+        bnorm[p] = sqrt(bnorm[p]);
+        active[p] = sqrt(dot[p]) > SOLVER_TOL * bnorm[p];
+        remaining += active[p];
+    }
+
+    for (int it = 0; it < SOLVER_MAX_ITER && remaining > 0; ++it) {
+        block_dot(rh, r, b->k, width, active, dot);
+        for (size_t p = 0; p < width; ++p) {
+            if (!active[p]) continue;
+            if (dot[p] == 0.0) {
+                active[p] = 0;
+                remaining--;
+                ok = 0;
+                continue;
+            }
+            double beta = dot[p] / rho[p] * (alpha[p] / omega[p]);
+            rho[p] = dot[p];
+            for (size_t i = 0; i < (size_t)b->k; ++i) {
+                size_t e = i * width + p;
+                pv[e] = r[e] + beta * (pv[e] - omega[p] * v[e]);
+            }
+        }
+        block_precondition(b, pv, ph, width);
+        block_apply(b, ph, v, width);
+        block_dot(rh, v, b->k, width, active, dot);
+        for (size_t p = 0; p < width; ++p) {
+            if (!active[p]) continue;
+            alpha[p] = dot[p] != 0.0 ? rho[p] / dot[p] : 0.0;
+            for (size_t i = 0; i < (size_t)b->k; ++i) {
+                size_t e = i * width + p;
+                r[e] -= alpha[p] * v[e];
+                X[e] += alpha[p] * ph[e];
+            }
+        }
+        block_dot(r, r, b->k, width, active, dot);
+        for (size_t p = 0; p < width; ++p) {
+            if (active[p] && sqrt(dot[p]) <= SOLVER_TOL * bnorm[p]) {
+                active[p] = 0;
+                remaining--;
+            }
+        }
+        if (remaining == 0) break;
+
+        block_precondition(b, r, sh, width);
+        block_apply(b, sh, t, width);
+        block_dot(t, r, b->k, width, active, dot);
+        block_dot(t, t, b->k, width, active, dot2);
+        for (size_t p = 0; p < width; ++p) {
+            if (!active[p]) continue;
+            omega[p] = dot2[p] != 0.0 ? dot[p] / dot2[p] : 0.0;
+            for (size_t i = 0; i < (size_t)b->k; ++i) {
+                size_t e = i * width + p;
+                X[e] += omega[p] * sh[e];
+                r[e] -= omega[p] * t[e];
+            }
+        }
+        block_dot(r, r, b->k, width, active, dot);
+        for (size_t p = 0; p < width; ++p) {
+            if (!active[p]) continue;
+            if (sqrt(dot[p]) <= SOLVER_TOL * bnorm[p]) {
+                active[p] = 0;
+                remaining--;
+            } else if (omega[p] == 0.0) {
+                active[p] = 0;
+                remaining--;
+                ok = 0;
+            }
+        }
+    }
+
+    free(r);
+    free(rh);
+    free(pv);
+    free(v);
+    free(ph);
+    free(sh);
+    free(t);
+    free(scal);
+    free(active);
+    return ok && remaining == 0;
+}
+
+/* Gauss-Seidel depuis X : converge toujours (Q sous-stochastique de rayon
+ * spectral < 1), mais lentement quand la classe fuit peu. Renvoie 0 sans convergence. */
+static int gauss_seidel_solve(const t_class_block *b, const double *B, double *X, size_t width)
+{
+    double *acc = calloc_double_array(width);
+    int converged = 0;
+    for (int sweep = 0; sweep < SOLVER_MAX_SWEEPS && !converged; ++sweep) {
+        double delta = 0.0, scale = 0.0;
+        for (int i = 0; i < b->k; ++i) {
+            double *x = X + (size_t)i * width;
+            memcpy(acc, B + (size_t)i * width, sizeof(double) * width);
+            for (size_t e = b->row_ptr[i]; e < b->row_ptr[i + 1]; ++e) {
+                const double *xj = X + (size_t)b->col[e] * width;
+                double q = b->val[e];
+                for (size_t p = 0; p < width; ++p) {
+                    acc[p] += q * xj[p];
+                }
+            }
+            double d = 1.0 - b->diag[i];
+            for (size_t p = 0; p < width; ++p) {
+                double next = acc[p] / d;
+                if (fabs(next - x[p]) > delta) delta = fabs(next - x[p]);
+                if (fabs(next) > scale) scale = fabs(next);
+                x[p] = next;
+            }
+        }
+        converged = delta <= SOLVER_TOL * scale;
+    }
+    free(acc);
+    return converged;
+}
+
+/*
+ * Résout (I - Q) X = B pour le bloc b d'un ensemble d'états transitoires
+ * (Q sous-stochastique, I - Q inversible) ; X (k x width) part de 0.
+ * BiCGSTAB d'abord, Gauss-Seidel pour finir si BiCGSTAB échoue.
+ */
+static int solve_block(const t_class_block *b, const double *B, double *X, size_t width)
+{
+    if (bicgstab_solve(b, B, X, width)) return 1;
+    return gauss_seidel_solve(b, B, X, width);
+}
+
+/* Lignes creuses de X en cours de construction : coefficients en double
+ * (ils servent de second membre aux classes suivantes), convertis à la fin. */
+typedef struct {
+    size_t *row_start;
+    int *row_size;
+    int *columns;
+    double *values;
+    size_t nnz;
+    size_t capacity;
+} t_sparse_rows;
+
+static void append_entry(t_sparse_rows *X, int p, double x)
+{
+    if (X->nnz == X->capacity) {
+        X->capacity = X->capacity ? 2 * X->capacity : 1024;
+        int *columns = realloc(X->columns, sizeof(int) * X->capacity);
+        double *values = realloc(X->values, sizeof(double) * X->capacity);
+        if (!columns || !values) {
+            perror("realloc absorption rows");
+            exit(EXIT_FAILURE);
+        }
+        X->columns = columns;
+        X->values = values;
+    }
+    X->columns[X->nnz] = p;
+    X->values[X->nnz] = x;
+    X->nnz++;
+}
+
+static int compare_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+t_absorption computeAbsorption(const t_graph *g, const t_partition *part, const t_link_array *links)
+{
+    int n = g->nb_vertices;
+    t_absorption abs;
+    abs.nb_vertices = n;
+
+    int *transient = buildTransientFlags(part, links);
+    int *vertex_to_class = buildVertexToClass(part, n);
+
+    /* Numérotation des classes persistantes. */
+    int *persistent_index = calloc_int_array(part->size > 0 ? part->size : 1);
+    abs.nb_persistent = 0;
+    for (int ci = 0; ci < part->size; ++ci) {
+        persistent_index[ci] = transient[ci] ? -1 : abs.nb_persistent++;
+    }
+    abs.persistent_classes = calloc_int_array(abs.nb_persistent > 0 ? abs.nb_persistent : 1);
+    for (int ci = 0; ci < part->size; ++ci) {
+        if (persistent_index[ci] >= 0) abs.persistent_classes[persistent_index[ci]] = ci;
+    }
+
+    int np = abs.nb_persistent;
+    t_sparse_rows X = {0};
+    X.row_start = calloc((size_t)(n > 0 ? n : 1), sizeof(size_t));
+    X.row_size = calloc_int_array(n > 0 ? n : 1);
+    double *steps = calloc_double_array((size_t)n);
+    /* slot[p] : colonne locale de la classe persistante p pour la classe en cours (-1 sinon). */
+    int *slot = malloc(sizeof(int) * (size_t)(np > 0 ? np : 1));
+    int *cols = calloc_int_array(np > 0 ? np : 1);
+    int *local = malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    if (!X.row_start || !slot || !local) {
+        perror("malloc absorption");
+        exit(EXIT_FAILURE);
+    }
+    for (int p = 0; p < np; ++p) {
+        slot[p] = -1;
+    }
+    for (int v = 0; v < n; ++v) {
+        local[v] = -1;
+    }
+
+    for (int ci = 0; ci < part->size; ++ci) {
+        const t_class *c = &part->classes[ci];
+        if (!transient[ci]) {
+            for (int i = 0; i < c->size; ++i) {
+                int v = c->vertices[i] - 1;
+                X.row_start[v] = X.nnz;
+                X.row_size[v] = 1;
+                append_entry(&X, persistent_index[ci], 1.0);
+            }
+            continue;
+        }
+
+        /* Colonnes de la classe : classes persistantes atteintes par ses arcs
+         * sortants, dont les lignes (classes d'indice inférieur) sont connues. */
+        int k = c->size;
+        int ncols = 0;
+        for (int i = 0; i < k; ++i) {
+            local[c->vertices[i] - 1] = i;
+        }
+        for (int i = 0; i < k; ++i) {
+            for (t_arc *cur = g->array[c->vertices[i] - 1].head; cur; cur = cur->next) {
+                int w = cur->dest - 1;
+                if (local[w] >= 0) continue;
+                for (size_t e = X.row_start[w]; e < X.row_start[w] + (size_t)X.row_size[w]; ++e) {
+                    if (slot[X.columns[e]] < 0) {
+                        slot[X.columns[e]] = ncols;
+                        cols[ncols++] = X.columns[e];
+                    }
+                }
+            }
+        }
+        qsort(cols, (size_t)ncols, sizeof(int), compare_int);
+        for (int t = 0; t < ncols; ++t) {
+            slot[cols[t]] = t;
+        }
+
+        size_t width = (size_t)ncols + 1;  /* une colonne par classe atteinte + le temps moyen */
+        t_class_block block;
+        build_class_block(g, c->vertices, k, local, 0, &block);
+        double *B = calloc_double_array((size_t)k * width);
+        double *Xc = calloc_double_array((size_t)k * width);
+        for (int i = 0; i < k; ++i) {
+            double *row = B + (size_t)i * width;
+            row[ncols] = 1.0;
+            for (t_arc *cur = g->array[c->vertices[i] - 1].head; cur; cur = cur->next) {
+                int w = cur->dest - 1;
+                if (local[w] >= 0) continue;
+                for (size_t e = X.row_start[w]; e < X.row_start[w] + (size_t)X.row_size[w]; ++e) {
+                    row[slot[X.columns[e]]] += cur->proba * X.values[e];
+                }
+                row[ncols] += cur->proba * steps[w];
+            }
+        }
+
+        if (!solve_block(&block, B, Xc, width)) {
+            fprintf(stderr, "computeAbsorption: pas de convergence pour la classe %s\n", c->name);
+        }
+        for (int i = 0; i < k; ++i) {
+            int v = c->vertices[i] - 1;
+            const double *xi = Xc + (size_t)i * width;
+            X.row_start[v] = X.nnz;
+            for (int t = 0; t < ncols; ++t) {
+                if (xi[t] != 0.0) append_entry(&X, cols[t], xi[t]);
+            }
+            X.row_size[v] = (int)(X.nnz - X.row_start[v]);
+            steps[v] = xi[ncols];
+            local[v] = -1;
+        }
+        for (int t = 0; t < ncols; ++t) {
+            slot[cols[t]] = -1;
+        }
+        free(B);
+        free(Xc);
+        free_class_block(&block);
+    }
+
+    abs.row_start = X.row_start;
+    abs.row_size = X.row_size;
+    abs.columns = X.columns ? X.columns : calloc_int_array(1);
+    abs.nnz = X.nnz;
+    abs.values = malloc(sizeof(float) * (X.nnz > 0 ? X.nnz : 1));
+    if (!abs.values) {
+        perror("malloc absorption values");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t e = 0; e < X.nnz; ++e) {
+        abs.values[e] = (float)X.values[e];
+    }
+    abs.expected_steps = calloc_float_array(n > 0 ? n : 1);
+    abs.is_transient = calloc_int_array(n > 0 ? n : 1);
+    for (int v = 0; v < n; ++v) {
+        abs.is_transient[v] = transient[vertex_to_class[v]];
+        abs.expected_steps[v] = abs.is_transient[v] ? (float)steps[v] : 0.0f;
+    }
+
+    free(X.values);
+    free(steps);
+    free(slot);
+    free(cols);
+    free(local);
+    free(persistent_index);
+    free(vertex_to_class);
+    free(transient);
+    return abs;
+}
+
+float absorptionProbability(const t_absorption *abs, int v, int p)
+{
+    const int *cols = abs->columns + abs->row_start[v];
+    int lo = 0, hi = abs->row_size[v];
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (cols[mid] < p) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < abs->row_size[v] && cols[lo] == p ? abs->values[abs->row_start[v] + (size_t)lo] : 0.0f;
+}
+
+t_absorption remapAbsorption(const t_absorption *abs, int n, const int *source)
+{
+    t_absorption r;
+    int np = abs->nb_persistent;
+    r.nb_vertices = n;
+    r.nb_persistent = np;
+    r.persistent_classes = calloc_int_array(np > 0 ? np : 1);
+    memcpy(r.persistent_classes, abs->persistent_classes, sizeof(int) * (size_t)np);
+    r.row_start = calloc((size_t)(n > 0 ? n : 1), sizeof(size_t));
+    if (!r.row_start) {
+        perror("calloc absorption rows");
+        exit(EXIT_FAILURE);
+    }
+    r.row_size = calloc_int_array(n > 0 ? n : 1);
+    r.expected_steps = calloc_float_array(n > 0 ? n : 1);
+    r.is_transient = calloc_int_array(n > 0 ? n : 1);
+    /* Les lignes sont partagées : seul leur début change. */
+    r.nnz = abs->nnz;
+    r.columns = malloc(sizeof(int) * (abs->nnz > 0 ? abs->nnz : 1));
+    r.values = malloc(sizeof(float) * (abs->nnz > 0 ? abs->nnz : 1));
+    if (!r.columns || !r.values) {
+        perror("malloc absorption rows");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(r.columns, abs->columns, sizeof(int) * abs->nnz);
+    memcpy(r.values, abs->values, sizeof(float) * abs->nnz);
+    for (int v = 0; v < n; ++v) {
+        int w = source[v];
+        r.row_start[v] = abs->row_start[w];
+        r.row_size[v] = abs->row_size[w];
+        r.is_transient[v] = abs->is_transient[w];
+        r.expected_steps[v] = abs->expected_steps[w];
+    }
+    return r;
+}
+
+float *computeClassStationary(const t_graph *g, const t_partition *part, int compo_index)
+{
+    const t_class *c = &part->classes[compo_index];
+    int k = c->size;
+    int n = g->nb_vertices;
+    float *pi = calloc_float_array(k > 0 ? k : 1);
+    if (k <= 1) {
+        pi[0] = 1.0f;
+        return pi;
+    }
+    int *local = malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    if (!local) {
+        perror("malloc stationary");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; ++v) {
+        local[v] = -1;
+    }
+
+    /* Avec pi = 1 sur le dernier sommet r, les autres vérifient
+     * (I - P_S)^T pi_S = P[r, S]^T, où S est la classe privée de r : P_S est
+     * sous-stochastique (r est accessible depuis tout S), le système est inversible. */
+    int m = k - 1;
+    int r = c->vertices[m] - 1;
+    for (int i = 0; i < m; ++i) {
+        local[c->vertices[i] - 1] = i;
+    }
+    t_class_block block;
+    build_class_block(g, c->vertices, m, local, 1, &block);
+    double *B = calloc_double_array((size_t)m);
+    double *X = calloc_double_array((size_t)m);
+    for (t_arc *cur = g->array[r].head; cur; cur = cur->next) {
+        int j = local[cur->dest - 1];
+        if (j >= 0) B[j] += cur->proba;
+    }
+
+    if (!solve_block(&block, B, X, 1)) {
+        fprintf(stderr, "computeClassStationary: pas de convergence pour la classe %s\n", c->name);
+    }
+    double total = 1.0;
+    for (int i = 0; i < m; ++i) {
+        total += X[i];
+    }
+    for (int i = 0; i < m; ++i) {
+        pi[i] = (float)(X[i] / total);
+    }
+    pi[m] = (float)(1.0 / total);
+
+    free(B);
+    free(X);
+    free_class_block(&block);
+    free(local);
+    return pi;
+}
+
+t_limit_rows createLimitRows(const t_graph *g, const t_partition *part, const t_absorption *abs)
+{
+    t_limit_rows L;
+    L.part = part;
+    L.abs = abs;
+    L.last = -1;
+    L.row = calloc_float_array(g->nb_vertices > 0 ? g->nb_vertices : 1);
+    L.pi = malloc(sizeof(float *) * (size_t)(abs->nb_persistent > 0 ? abs->nb_persistent : 1));
+    if (!L.pi) {
+        perror("malloc limit distributions");
+        exit(EXIT_FAILURE);
+    }
+    for (int p = 0; p < abs->nb_persistent; ++p) {
+        L.pi[p] = computeClassStationary(g, part, abs->persistent_classes[p]);
+    }
+    return L;
+}
+
+/* Ecrit la ligne du sommet i dans L->row, ou remet ses coefficients à zéro si clear. */
+static void fill_limit_row(t_limit_rows *L, int i, int clear)
+{
+    const t_absorption *abs = L->abs;
+    for (size_t e = abs->row_start[i]; e < abs->row_start[i] + (size_t)abs->row_size[i]; ++e) {
+        int p = abs->columns[e];
+        const t_class *c = &L->part->classes[abs->persistent_classes[p]];
+        for (int j = 0; j < c->size; ++j) {
+            L->row[c->vertices[j] - 1] = clear ? 0.0f : abs->values[e] * L->pi[p][j];
+        }
+    }
+}
+
+const float *limitRow(void *arg, int i)
+{
+    t_limit_rows *L = arg;
+    if (L->last == i) return L->row;
+    if (L->last >= 0) fill_limit_row(L, L->last, 1);
+    fill_limit_row(L, i, 0);
+    L->last = i;
+    return L->row;
+}
+
+void freeLimitRows(t_limit_rows *L)
+{
+    if (!L || !L->pi) return;
+    for (int p = 0; p < L->abs->nb_persistent; ++p) {
+        free(L->pi[p]);
+    }
+    free(L->pi);
+    free(L->row);
+    L->pi = NULL;
+    L->row = NULL;
+    L->last = -1;
+}
+
+void freeAbsorption(t_absorption *abs)
+{
+    if (!abs || !abs->row_start) return;
+    free(abs->row_start);
+    free(abs->row_size);
+    free(abs->columns);
+    free(abs->values);
+    free(abs->expected_steps);
+    free(abs->is_transient);
+    free(abs->persistent_classes);
+    abs->row_start = NULL;
+    abs->row_size = NULL;
+    abs->columns = NULL;
+    abs->values = NULL;
+    abs->expected_steps = NULL;
+    abs->is_transient = NULL;
+    abs->persistent_classes = NULL;
+    abs->nb_vertices = abs->nb_persistent = 0;
+    abs->nnz = 0;
+}
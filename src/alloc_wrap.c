@@ -0,0 +1,27 @@
+#include <stddef.h>
+#include "instrument.h"
+
+/* Appels de malloc/calloc/realloc redirigés par l'éditeur de liens
+ * (-Wl,--wrap=...) : lié au programme, ou à libmarkov partagée qui redirige
+ * alors ses propres appels ; la bibliothèque reste utilisable sans ces options. */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    instrumentCountAllocation(size);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    instrumentCountAllocation(nmemb * size);
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    instrumentCountAllocation(size);
+    return __real_realloc(ptr, size);
+}
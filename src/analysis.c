@@ -0,0 +1,421 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "analysis.h"
+#include "graph.h"
+#include "tarjan.h"
+#include "hasse.h"
+#include "matrix.h"
+#include "utils.h"
+#include "pipeline.h"
+#include "powercache.h"
+#include "absorption.h"
+#include "simulation.h"
+#include "lumping.h"
+#include "reorder.h"
+#include "ctmc.h"
+#include "tiled.h"
+#include "instrument.h"
+
+#define OUT_OF_CORE_TILE 64
+#define OUT_OF_CORE_CACHE_BYTES ((size_t)64 << 20)
+#define CLASS_MAX_ITER 50       /* budget d'itérations par défaut d'une classe */
+
+static void power_name(char *name, size_t size, int k)
+{
+    snprintf(name, size, "M^%d", k);
+}
+
+/* Lignes de la matrice d'un graphe, sans matrice dense : comme
+ * createMatrixFromGraph, le dernier arc l'emporte. */
+typedef struct {
+    const t_graph *g;
+    float *row;
+} t_graph_rows;
+
+static const float *graph_row(void *arg, int i)
+{
+    t_graph_rows *r = arg;
+    for (int j = 0; j < r->g->nb_vertices; ++j) {
+        r->row[j] = 0.0f;
+    }
+    for (t_arc *cur = r->g->array[i].head; cur; cur = cur->next) {
+        r->row[cur->dest - 1] = cur->proba;
+    }
+    return r->row;
+}
+
+/* Avec --lump, M est celle des états (graphe d'origine) ; ses puissances sont
+ * celles du quotient, par blocs : les probabilités vers chaque état d'un bloc
+ * ne se déduisent pas du quotient. */
+static void write_state_matrix(t_writer *w, const t_graph *states)
+{
+    t_graph_rows rows = {states, calloc_float_array(states->nb_vertices > 0 ? states->nb_vertices : 1)};
+    writeRowMatrix(w, graph_row, &rows, states->nb_vertices, NULL, "M");
+    free(rows.row);
+}
+
+static void power_label(char *name, size_t size, int k, int lumped)
+{
+    power_name(name, size, k);
+    if (lumped) snprintf(name + strlen(name), size - strlen(name), " (blocs)");
+}
+
+/* Puissances hors mémoire : M et ses puissances restent dans des matrices
+ * tuilées sous opt->out_of_core et sont écrites ligne par ligne depuis leurs tuiles. */
+static void runTiledPowers(t_writer *w, const t_graph *pg, const t_permutation *perm,
+                           const t_graph *states, const t_options *opt)
+{
+    char name[32];
+    t_tiled_matrix T = tiledFromGraph(pg, opt->out_of_core, OUT_OF_CORE_TILE);
+    if (states) write_state_matrix(w, states);
+    else writeTiledMatrix(w, &T, perm->position, "M");
+    t_tile_cache *cache = createTileCache(OUT_OF_CORE_CACHE_BYTES, OUT_OF_CORE_TILE);
+    for (int i = 0; i < opt->nb_powers; ++i) {
+        t_tiled_matrix Tk = tiledPower(&T, opt->powers[i], opt->out_of_core, cache);
+        tileCacheInvalidate(cache, &Tk);
+        power_label(name, sizeof(name), opt->powers[i], states != NULL);
+        writeTiledMatrix(w, &Tk, perm->position, name);
+        freeTiledMatrix(&Tk);
+    }
+    t_io_stats io = tileCacheStats(cache);
+    writeIoStats(w, &io);
+    tileCacheInvalidate(cache, &T);
+    freeTileCache(cache);
+    freeTiledMatrix(&T);
+}
+
+/* Puissances de M en mémoire (échelle de puissances). Les matrices sont
+ * calculées dans l'ordre par blocs et affichées dans l'ordre d'origine.
+ * states : graphe d'origine avec --lump (M sur le quotient), NULL sinon. */
+static void runPowers(t_writer *w, const t_matrix *M, const t_permutation *perm,
+                      const t_graph *states, const t_options *opt)
+{
+    char name[32];
+    if (states) write_state_matrix(w, states);
+    else writeMatrix(w, M, perm->position, "M");
+    t_power_cache powers;
+    initPowerCache(&powers, M, opt->power_cache_bytes);
+    for (int i = 0; i < opt->nb_powers; ++i) {
+        t_matrix Mk = powerCacheGet(&powers, opt->powers[i]);
+        power_label(name, sizeof(name), opt->powers[i], states != NULL);
+        writeMatrix(w, &Mk, perm->position, name);
+        freeMatrix(&Mk);
+    }
+    freePowerCache(&powers);
+}
+
+/* Distribution transitoire pi(t) depuis l'état 1 du générateur Q. */
+static void writeTransientDistribution(t_writer *w, const t_graph *Q, double horizon)
+{
+    int n = Q->nb_vertices;
+    double *pi0 = calloc((size_t)n, sizeof(double));
+    double *pit = calloc((size_t)n, sizeof(double));
+    float *shown = calloc_float_array(n);
+    if (!pi0 || !pit) {
+        perror("calloc transient distribution");
+        exit(EXIT_FAILURE);
+    }
+    pi0[0] = 1.0;
+    int products = transientDistribution(Q, pi0, horizon, 1e-6, pit);
+    writeText(w, "Distribution transitoire pi(t=%g) depuis l'etat 1 (%d produits) :\n",
+              horizon, products);
+    for (int v = 0; v < n; ++v) {
+        shown[v] = (float)pit[v];
+    }
+    writeVector(w, "transient", "p", shown, n);
+    free(pi0);
+    free(pit);
+    free(shown);
+}
+
+/* Partie 3 : matrices, limite, distributions et absorption, éventuellement
+ * sur la chaîne quotient (--lump). */
+static void runMatrixStages(t_writer *w, const t_graph *g, const t_partition *part,
+                            const t_link_array *links, const t_options *opt,
+                            const t_analysis_env *env)
+{
+    int stages = opt->stages;
+    writeText(w, "\n=== PARTIE 3 : MATRICES / DISTRIBUTIONS / PERIODE ===\n");
+
+    /* Avec --lump, la partie 3 travaille sur la chaîne quotient. */
+    const t_graph *ag = g;
+    const t_partition *apart = part;
+    const t_link_array *alinks = links;
+    t_lumping lumping = {0};
+    t_graph *qg = NULL;
+    t_partition qpart = {0};
+    t_link_array qlinks;
+    int *class_map = NULL;
+    t_probe probe;
+    if (opt->lump) {
+        probeBegin(&probe, "computeLumping");
+        lumping = computeLumping(g, part, links, 1e-3f);
+        probeEnd(&probe);
+        writeLumping(w, &lumping);
+        qg = buildQuotientGraph(g, &lumping);
+        qpart = tarjanPartition(qg);
+        class_map = mapQuotientClasses(&lumping, &qpart, part, links);
+        init_link_array(&qlinks);
+        build_class_links(qg, &qpart, &qlinks);
+        removeTransitiveLinks(&qlinks);
+        ag = qg;
+        apart = &qpart;
+        alinks = &qlinks;
+        writeText(w, "Puissances, limite et distributions portent sur les blocs ; absorption, "
+                     "temps d'atteinte et periodes, constants sur chaque bloc, sont ramenes aux etats.\n");
+    }
+
+    const t_graph *states = opt->lump ? g : NULL;
+
+    probeBegin(&probe, "blockTriangularOrder");
+    t_permutation perm = blockTriangularOrder(ag, apart);
+    t_graph *pg = permuteGraph(ag, &perm);
+    t_partition ppart = permutePartition(apart, &perm);
+    probeEnd(&probe);
+
+    /* Hors mémoire, la matrice dense n'est jamais construite. */
+    t_matrix M = {0, 0, NULL};
+    if ((stages & STAGE_POWERS) && !opt->out_of_core) {
+        probeBegin(&probe, "createMatrixFromGraph");
+        M = createMatrixFromGraph(pg);
+        probeEnd(&probe);
+    }
+    if (stages & STAGE_POWERS) {
+        probeBegin(&probe, "puissances de M");
+        if (opt->out_of_core) runTiledPowers(w, pg, &perm, states, opt);
+        else runPowers(w, &M, &perm, states, opt);
+        probeEnd(&probe);
+    }
+
+    t_absorption pabs = {0};
+    if (stages & (STAGE_LIMIT | STAGE_ABSORPTION)) {
+        probeBegin(&probe, "computeAbsorption");
+        pabs = computeAbsorption(pg, &ppart, alinks);
+        probeEnd(&probe);
+    }
+    if (stages & STAGE_LIMIT) {
+        /* La limite est écrite ligne par ligne, y compris hors mémoire. */
+        probeBegin(&probe, "createLimitRows");
+        t_limit_rows limit = createLimitRows(pg, &ppart, &pabs);
+        probeEnd(&probe);
+        const char *name = opt->lump ? "limite lim M^n par blocs (exacte, Cesaro si periodique)"
+                                     : "limite lim M^n (exacte, Cesaro si periodique)";
+        writeRowMatrix(w, limitRow, &limit, pg->nb_vertices, perm.position, name);
+        freeLimitRows(&limit);
+    }
+
+    if (stages & STAGE_DISTRIBUTIONS) {
+        int *origin = permutedClassOrigins(apart, &ppart, &perm);
+        probeBegin(&probe, "runClassPipeline");
+        t_class_result *results = runClassPipeline(pg, &ppart, origin, env->nb_threads, 0.01f, CLASS_MAX_ITER);
+        probeEnd(&probe);
+        unpermuteClassResults(results, apart, &ppart, &perm);
+        writeClassResults(w, apart, results);
+        if (opt->lump) {
+            t_partition epart = expandQuotientClasses(apart, &lumping, part);
+            writeQuotientClasses(w, &epart, results);
+            freePartition(&epart);
+        }
+        freeClassResults(results, ppart.size);
+        free(origin);
+    }
+
+    if (stages & STAGE_ABSORPTION) {
+        t_absorption abs = unpermuteAbsorption(&pabs, &perm);
+        if (opt->lump) {
+            t_absorption expanded = expandAbsorption(&abs, &lumping, class_map);
+            freeAbsorption(&abs);
+            abs = expanded;
+        }
+        writeAbsorption(w, part, &abs);
+        freeAbsorption(&abs);
+    }
+
+    freeAbsorption(&pabs);
+    freeMatrix(&M);
+    freePartition(&ppart);
+    freeGraph(pg);
+    freePermutation(&perm);
+
+    if (opt->lump) {
+        free(class_map);
+        free_link_array(&qlinks);
+        freePartition(&qpart);
+        freeGraph(qg);
+        freeLumping(&lumping);
+    }
+}
+
+/* Partie 4 : trajectoires depuis opt->sim_start jusqu'aux classes persistantes. */
+static void runSimulationStage(t_writer *w, const t_graph *g, const t_partition *part,
+                               const t_link_array *links, const t_options *opt,
+                               const t_analysis_env *env)
+{
+    writeText(w, "\n=== PARTIE 4 : SIMULATION (MONTE CARLO) ===\n");
+    if (opt->sim_start > g->nb_vertices) {
+        writeText(w, "Etat initial %d hors de 1..%d : simulation ignoree\n",
+                  opt->sim_start, g->nb_vertices);
+        return;
+    }
+    int *transient = buildTransientFlags(part, links);
+    int *vertex_class = buildVertexToClass(part, g->nb_vertices);
+    int *targets = calloc_int_array(g->nb_vertices);
+    for (int v = 0; v < g->nb_vertices; ++v) {
+        targets[v] = !transient[vertex_class[v]];
+    }
+    t_probe probe;
+    probeBegin(&probe, "simulateWalks");
+    t_alias_tables tables = buildAliasTables(g);
+    t_simulation_params sim = {opt->sim_start, targets, 0, opt->sim_walks, opt->sim_steps,
+                               env->nb_threads, (uint64_t)opt->sim_seed, opt->sim_bins};
+    t_simulation_result sim_res = simulateWalks(&tables, &sim);
+    probeEnd(&probe);
+    writeText(w, "Depart : etat %d, cibles : etats des classes persistantes\n", opt->sim_start);
+    writeSimulation(w, &sim_res);
+    freeSimulationResult(&sim_res);
+    freeAliasTables(&tables);
+    free(targets);
+    free(vertex_class);
+    free(transient);
+}
+
+typedef struct {
+    t_writer *w;
+    const int *from;
+} t_kstep_output;
+
+static void write_kstep(int k, const float *block, int batch, int n, void *user)
+{
+    t_kstep_output *out = user;
+    char name[48];
+    for (int b = 0; b < batch; ++b) {
+        writeText(out->w, "\nDistribution apres %d pas depuis l'etat %d :\n", k, out->from[b]);
+        snprintf(name, sizeof(name), "kstep_%d_%d", out->from[b], k);
+        writeVector(out->w, name, "p", block + (size_t)b * (size_t)n, n);
+    }
+}
+
+/* Partie 5 : pi * P^k depuis chaque état de opt->kstep_from, avancés ensemble
+ * (un produit creux x bloc par pas pour tout le lot). */
+static void runKStepStage(t_writer *w, t_markov_context *ctx, const t_options *opt,
+                          const t_analysis_env *env)
+{
+    int n = markovGraph(ctx)->nb_vertices;
+    writeText(w, "\n=== PARTIE 5 : DISTRIBUTIONS A K PAS ===\n");
+    for (int b = 0; b < opt->nb_kstep_from; ++b) {
+        if (opt->kstep_from[b] > n) {
+            writeText(w, "Etat initial %d hors de 1..%d : distributions a k pas ignorees\n",
+                      opt->kstep_from[b], n);
+            return;
+        }
+    }
+    int batch = opt->nb_kstep_from;
+    float *initial = calloc((size_t)(batch > 0 ? batch : 1) * (size_t)(n > 0 ? n : 1), sizeof(float));
+    if (!initial) {
+        perror("calloc kstep initial");
+        exit(EXIT_FAILURE);
+    }
+    for (int b = 0; b < batch; ++b) {
+        initial[(size_t)b * (size_t)n + (size_t)(opt->kstep_from[b] - 1)] = 1.0f;
+    }
+    t_kstep_output out = {w, opt->kstep_from};
+    t_probe probe;
+    probeBegin(&probe, "batchDistributions");
+    markovBatchDistributionsStream(ctx, initial, batch, opt->kstep, opt->nb_kstep, env->nb_threads,
+                                   write_kstep, &out);
+    probeEnd(&probe);
+    free(initial);
+}
+
+int analyzeFile(t_markov_context *ctx, const char *filename, const t_options *opt,
+                const t_analysis_env *env, t_writer *w, t_analysis_summary *summary)
+{
+    t_analysis_summary local;
+    if (!summary) summary = &local;
+    summary->nb_vertices = -1;
+    summary->nb_arcs = -1;
+    summary->valid = -1;
+    summary->nb_classes = -1;
+    summary->nb_transient = -1;
+    summary->irreducible = -1;
+
+    t_probe probe;
+    probeBegin(&probe, "readGraph");
+    int loaded = markovLoadFile(ctx, filename, opt->ctmc);
+    probeEnd(&probe);
+    if (!loaded) return 0;
+    const t_graph *g = markovGraph(ctx);
+    int stages = opt->stages;
+
+    summary->nb_vertices = g->nb_vertices;
+    summary->nb_arcs = countArcs(g);
+    summary->valid = isMarkovGraph(g, 0.01f);
+
+    if (stages & STAGE_GRAPH) {
+        writeText(w, "=== PARTIE 1 : GRAPHE / MARKOV / MERMAID ===\n");
+        writeGraph(w, g, 0.01f);
+        if (env->graph_mermaid) {
+            exportMermaidGraph(g, env->graph_mermaid);
+            writeText(w, "pour visualiser graphe : %s\n", env->graph_mermaid);
+        }
+    }
+
+    /* Chaîne à temps continu : la suite de l'analyse porte sur la chaîne
+     * uniformisée, qui a les mêmes classes et la même distribution stationnaire. */
+    if (opt->ctmc) {
+        writeText(w, "Uniformisation : P = I + Q / lambda, lambda = %.4f\n",
+                  uniformizationRate(g));
+        if (stages & STAGE_DISTRIBUTIONS) {
+            probeBegin(&probe, "transientDistribution");
+            writeTransientDistribution(w, g, opt->horizon);
+            probeEnd(&probe);
+        }
+        if (stages & ~STAGE_GRAPH) {
+            probeBegin(&probe, "uniformize");
+            markovUniformize(ctx);
+            probeEnd(&probe);
+            g = markovGraph(ctx);
+        }
+    }
+
+    /* Seules ces étapes lisent la partition : sans elles, ni Tarjan ni le
+     * diagramme de Hasse ne sont calculés (champs du résumé laissés à -1). */
+    const t_partition *part = NULL;
+    const t_link_array *links = NULL;
+    if (stages & (STAGE_CLASSES | STAGE_POWERS | STAGE_LIMIT | STAGE_DISTRIBUTIONS
+                  | STAGE_ABSORPTION | STAGE_SIMULATION)) {
+        part = markovPartition(ctx);
+        links = markovLinks(ctx);
+        const t_class_kind *kinds = markovClassKinds(ctx);
+        summary->nb_classes = part->size;
+        summary->nb_transient = 0;
+        for (int ci = 0; ci < part->size; ++ci) {
+            summary->nb_transient += kinds[ci] == CLASS_TRANSIENT;
+        }
+        summary->irreducible = part->size == 1;
+    }
+
+    if (stages & STAGE_CLASSES) {
+        writeText(w, "\n=== PARTIE 2 : TARJAN / PARTITION / HASSE ===\n");
+        writePartition(w, part);
+        if (env->hasse_mermaid) {
+            export_mermaid_hasse(part, links, env->hasse_mermaid);
+            writeText(w, "Pour visualiser diagramme de Hasse : %s\n", env->hasse_mermaid);
+        }
+        writeClassification(w, part, links);
+    }
+
+    if (stages & (STAGE_POWERS | STAGE_LIMIT | STAGE_DISTRIBUTIONS | STAGE_ABSORPTION)) {
+        runMatrixStages(w, g, part, links, opt, env);
+    }
+
+    if (stages & STAGE_SIMULATION) {
+        runSimulationStage(w, g, part, links, opt, env);
+    }
+
+    if (stages & STAGE_KSTEP) {
+        runKStepStage(w, ctx, opt, env);
+    }
+    return 1;
+}
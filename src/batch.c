@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "batch.h"
+#include "analysis.h"
+#include "threadpool.h"
+
+#define BATCH_PATH_MAX 4096
+
+typedef struct {
+    char *path;
+    int ok;
+    double ms;
+    t_analysis_summary summary;
+} t_batch_job;
+
+/* Les threads du pool prennent les fichiers un par un dans la liste commune. */
+typedef struct {
+    const t_options *opt;
+    t_batch_job *jobs;
+    int nb_jobs;
+    int next;
+    pthread_mutex_t lock;
+} t_batch;
+
+typedef struct {
+    char **items;
+    int size;
+    int capacity;
+} t_path_list;
+
+static void path_list_add(t_path_list *l, const char *path)
+{
+    if (l->size == l->capacity) {
+        l->capacity = l->capacity ? 2 * l->capacity : 64;
+        char **items = realloc(l->items, (size_t)l->capacity * sizeof(char *));
+        if (!items) {
+            perror("realloc batch list");
+            exit(EXIT_FAILURE);
+        }
+        l->items = items;
+    }
+    l->items[l->size] = strdup(path);
+    if (!l->items[l->size]) {
+        perror("strdup batch path");
+        exit(EXIT_FAILURE);
+    }
+    l->size++;
+}
+
+static int compare_paths(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static int has_suffix(const char *s, const char *suffix)
+{
+    size_t n = strlen(s), k = strlen(suffix);
+    return n >= k && strcmp(s + n - k, suffix) == 0;
+}
+
+/* Répertoire : ses fichiers *.txt par ordre alphabétique ; sinon un chemin par
+ * ligne (lignes vides et commentaires # ignorés). */
+static int collect_paths(const char *source, t_path_list *l)
+{
+    struct stat st;
+    if (stat(source, &st) != 0) {
+        perror(source);
+        return 0;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(source);
+        if (!dir) {
+            perror(source);
+            return 0;
+        }
+        char path[BATCH_PATH_MAX];
+        struct dirent *e;
+        while ((e = readdir(dir)) != NULL) {
+            if (e->d_name[0] == '.' || !has_suffix(e->d_name, ".txt")) continue;
+            snprintf(path, sizeof(path), "%s/%s", source, e->d_name);
+            path_list_add(l, path);
+        }
+        closedir(dir);
+        qsort(l->items, (size_t)l->size, sizeof(char *), compare_paths);
+        return 1;
+    }
+
+    FILE *f = fopen(source, "rt");
+    if (!f) {
+        perror(source);
+        return 0;
+    }
+    char line[BATCH_PATH_MAX];
+    while (fgets(line, sizeof(line), f)) {
+        size_t n = strcspn(line, "\r\n");
+        line[n] = '\0';
+        if (n == 0 || line[0] == '#') continue;
+        path_list_add(l, line);
+    }
+    fclose(f);
+    return 1;
+}
+
+/* Nom du fichier sans répertoire ni extension. */
+static void path_stem(const char *path, char *stem, size_t size)
+{
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    snprintf(stem, size, "%s", base);
+    char *dot = strrchr(stem, '.');
+    if (dot && dot != stem) *dot = '\0';
+}
+
+static double elapsed_ms(const struct timespec *t0)
+{
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return (double)(t1.tv_sec - t0->tv_sec) * 1e3 + (double)(t1.tv_nsec - t0->tv_nsec) * 1e-6;
+}
+
+/* Les chemins de sortie sont préfixés par le rang du fichier dans la liste :
+ * deux chaînes de même nom dans des répertoires différents ne s'écrasent pas. */
+static void run_job(t_batch *b, int index, t_markov_context *ctx, t_writer *w)
+{
+    t_batch_job *job = &b->jobs[index];
+    const char *dir = b->opt->batch_dir;
+    char stem[256];
+    char out_path[BATCH_PATH_MAX];
+    char graph_path[BATCH_PATH_MAX];
+    char hasse_path[BATCH_PATH_MAX];
+    path_stem(job->path, stem, sizeof(stem));
+    snprintf(out_path, sizeof(out_path), "%s/%05d_%s.%s", dir, index + 1, stem,
+             b->opt->format == FORMAT_BINARY ? "bin" : b->opt->format == FORMAT_JSONL ? "jsonl" : "txt");
+    snprintf(graph_path, sizeof(graph_path), "%s/%05d_%s.graph.mmd", dir, index + 1, stem);
+    snprintf(hasse_path, sizeof(hasse_path), "%s/%05d_%s.hasse.mmd", dir, index + 1, stem);
+
+    struct timespec t0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    FILE *out = fopen(out_path, "wb");
+    if (!out) {
+        perror(out_path);
+        job->ok = 0;
+        return;
+    }
+    /* Un seul thread par chaîne : le parallélisme vient des fichiers. */
+    t_analysis_env env = {graph_path, hasse_path, 1};
+    writerReset(w, out);
+    job->ok = analyzeFile(ctx, job->path, b->opt, &env, w, &job->summary);
+    writerReset(w, NULL);
+    fclose(out);
+    if (!job->ok) remove(out_path);
+    job->ms = elapsed_ms(&t0);
+}
+
+/* Chaque thread garde son contexte et son writer d'un fichier à l'autre. */
+static void batch_worker(void *arg)
+{
+    t_batch *b = arg;
+    t_markov_context *ctx = markovCreate();
+    t_writer *w = createWriter(NULL, b->opt->format, &b->opt->print);
+    for (;;) {
+        pthread_mutex_lock(&b->lock);
+        int index = b->next++;
+        pthread_mutex_unlock(&b->lock);
+        if (index >= b->nb_jobs) break;
+        run_job(b, index, ctx, w);
+    }
+    freeWriter(w);
+    markovFree(ctx);
+}
+
+static void print_field(int x)
+{
+    if (x < 0) printf("\t-");
+    else printf("\t%d", x);
+}
+
+static void print_report(const t_batch *b, double total_ms)
+{
+    int nb_failed = 0;
+    printf("fichier\tetats\tarcs\tmarkov\tclasses\ttransitoires\tirreductible\tms\tstatut\n");
+    for (int i = 0; i < b->nb_jobs; ++i) {
+        const t_batch_job *job = &b->jobs[i];
+        const t_analysis_summary *s = &job->summary;
+        printf("%s", job->path);
+        print_field(s->nb_vertices);
+        print_field(s->nb_arcs);
+        print_field(s->valid);
+        print_field(s->nb_classes);
+        print_field(s->nb_transient);
+        print_field(s->irreducible);
+        printf("\t%.2f\t%s\n", job->ms, job->ok ? "ok" : "erreur");
+        nb_failed += !job->ok;
+    }
+    printf("# %d fichiers, %d erreurs, %.2f ms\n", b->nb_jobs, nb_failed, total_ms);
+}
+
+int runBatch(const t_options *opt)
+{
+    t_path_list paths = {NULL, 0, 0};
+    if (!collect_paths(opt->batch, &paths)) return -1;
+    if (mkdir(opt->batch_dir, 0755) != 0 && errno != EEXIST) {
+        perror(opt->batch_dir);
+        return -1;
+    }
+
+    t_batch b;
+    b.opt = opt;
+    b.nb_jobs = paths.size;
+    b.next = 0;
+    b.jobs = calloc((size_t)(paths.size > 0 ? paths.size : 1), sizeof(t_batch_job));
+    if (!b.jobs) {
+        perror("calloc batch jobs");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < paths.size; ++i) {
+        b.jobs[i].path = paths.items[i];
+        b.jobs[i].summary.nb_vertices = -1;
+        b.jobs[i].summary.nb_arcs = -1;
+        b.jobs[i].summary.valid = -1;
+        b.jobs[i].summary.nb_classes = -1;
+        b.jobs[i].summary.nb_transient = -1;
+        b.jobs[i].summary.irreducible = -1;
+    }
+    pthread_mutex_init(&b.lock, NULL);
+
+    struct timespec t0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    t_thread_pool *pool = pool_create(opt->jobs);
+    int nb_workers = pool_size(pool) < b.nb_jobs ? pool_size(pool) : b.nb_jobs;
+    t_task_group group = {0};
+    for (int i = 0; i < nb_workers; ++i) {
+        pool_submit(pool, batch_worker, &b, &group);
+    }
+    pool_wait(pool, &group);
+    pool_destroy(pool);
+
+    print_report(&b, elapsed_ms(&t0));
+
+    int nb_failed = 0;
+    for (int i = 0; i < b.nb_jobs; ++i) {
+        nb_failed += !b.jobs[i].ok;
+    }
+    pthread_mutex_destroy(&b.lock);
+    free(b.jobs);
+    for (int i = 0; i < paths.size; ++i) {
+        free(paths.items[i]);
+    }
+    free(paths.items);
+    return nb_failed;
+}
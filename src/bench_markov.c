@@ -0,0 +1,473 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "graph.h"
+#include "tarjan.h"
+#include "hasse.h"
+#include "matrix.h"
+#include "absorption.h"
+#include "period.h"
+#include "synth.h"
+
+#define BENCH_MAX_SIZES 16
+#define BENCH_PATH_MAX 4096
+
+/* ================= Etapes mesurées ================= */
+
+/**
+ * @brief Chaîne synthétique et résultats intermédiaires partagés par les étapes.
+ */
+typedef struct {
+    t_synth_family family;
+    int n;
+    int nb_arcs;
+    t_graph *g;
+    char path[BENCH_PATH_MAX];      /**< Copie du graphe sur disque (étape load). */
+    t_partition part;
+    t_link_array links;             /**< Liens entre classes, avant réduction. */
+    int *transient;
+    t_matrix M;                     /**< Matrice de transition (si n <= dense-max). */
+    /* Données de travail d'une répétition (préparées hors mesure). */
+    t_link_array work_links;
+    t_matrix product;
+} t_bench_case;
+
+/**
+ * @brief Condition d'exécution d'une étape par rapport à --dense-max.
+ */
+typedef enum {
+    LIMIT_NONE,         /**< Toujours exécutée. */
+    LIMIT_DENSE         /**< Matrice n x n : n <= dense-max. */
+} t_bench_limit;
+
+typedef struct {
+    const char *name;
+    t_bench_limit limit;
+    void (*setup)(t_bench_case *c);     /**< Hors mesure, avant chaque répétition (peut être NULL). */
+    void (*run)(t_bench_case *c);
+    void (*teardown)(t_bench_case *c);  /**< Hors mesure, après chaque répétition (peut être NULL). */
+} t_bench_stage;
+
+static int bench_power = 16;
+
+static void run_load(t_bench_case *c)
+{
+    t_graph *g = readGraph(c->path);
+    if (!g) exit(EXIT_FAILURE);
+    freeGraph(g);
+}
+
+static void run_scc(t_bench_case *c)
+{
+    t_partition p = tarjanPartition(c->g);
+    freePartition(&p);
+}
+
+static void run_links(t_bench_case *c)
+{
+    t_link_array links;
+    init_link_array(&links);
+    build_class_links(c->g, &c->part, &links);
+    free_link_array(&links);
+}
+
+/* Copie des liens (déjà sans doublon) : la réduction travaille en place. */
+static void copy_links(const t_link_array *src, t_link_array *dst)
+{
+    dst->size = src->size;
+    dst->capacity = src->size > 0 ? src->size : 1;
+    dst->data = malloc(sizeof(t_link) * (size_t)dst->capacity);
+    if (!dst->data) {
+        perror("malloc links");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(dst->data, src->data, sizeof(t_link) * (size_t)src->size);
+}
+
+static void setup_reduction(t_bench_case *c)
+{
+    copy_links(&c->links, &c->work_links);
+}
+
+static void run_reduction(t_bench_case *c)
+{
+    removeTransitiveLinks(&c->work_links);
+}
+
+static void teardown_reduction(t_bench_case *c)
+{
+    free_link_array(&c->work_links);
+}
+
+static void setup_multiply(t_bench_case *c)
+{
+    c->product = createEmptyMatrix(c->n);
+}
+
+static void run_multiply(t_bench_case *c)
+{
+    multiplyMatrices(&c->M, &c->M, &c->product);
+}
+
+static void teardown_multiply(t_bench_case *c)
+{
+    freeMatrix(&c->product);
+}
+
+static void run_power(t_bench_case *c)
+{
+    t_matrix Mk = matrixPower(&c->M, bench_power);
+    freeMatrix(&Mk);
+}
+
+static void run_stationary(t_bench_case *c)
+{
+    for (int ci = 0; ci < c->part.size; ++ci) {
+        if (c->transient[ci]) continue;
+        free(computeClassStationary(c->g, &c->part, ci));
+    }
+}
+
+static void run_period(t_bench_case *c)
+{
+    free(getAllPeriods(c->g, &c->part));
+}
+
+static const t_bench_stage STAGES[] = {
+    {"load", LIMIT_NONE, NULL, run_load, NULL},
+    {"scc", LIMIT_NONE, NULL, run_scc, NULL},
+    {"links", LIMIT_NONE, NULL, run_links, NULL},
+    {"reduction", LIMIT_NONE, setup_reduction, run_reduction, teardown_reduction},
+    {"multiply", LIMIT_DENSE, setup_multiply, run_multiply, teardown_multiply},
+    {"power", LIMIT_DENSE, NULL, run_power, NULL},
+    {"stationary", LIMIT_NONE, NULL, run_stationary, NULL},
+    {"period", LIMIT_NONE, NULL, run_period, NULL},
+};
+
+#define NB_STAGES ((int)(sizeof(STAGES) / sizeof(STAGES[0])))
+
+/* ================= Options ================= */
+
+typedef struct {
+    int families;                   /**< Masque des t_synth_family mesurées. */
+    int stages;                     /**< Masque des indices de STAGES. */
+    int sizes[BENCH_MAX_SIZES];
+    int nb_sizes;
+    int warmup;
+    int repeat;
+    int dense_max;
+    unsigned long long seed;
+    int json;
+    const char *output;
+} t_bench_options;
+
+static void print_usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage : %s [options]\n"
+            "  --families LISTE   random,cycle,absorbing,dag,blocks (defaut : toutes)\n"
+            "  --sizes LISTE      nombres d'etats (defaut 256,1024,4096)\n"
+            "  --stages LISTE     load,scc,links,reduction,multiply,power,stationary,period\n"
+            "                     (defaut : toutes)\n"
+            "  --warmup N         repetitions non mesurees (defaut 1)\n"
+            "  --repeat N         repetitions mesurees (defaut 5)\n"
+            "  --dense-max N      taille maximale des calculs denses (defaut 512) : multiply et\n"
+            "                     power si n <= N\n"
+            "  --power K          puissance calculee par l'etape power (defaut 16)\n"
+            "  --seed S           graine des familles aleatoires (defaut 42)\n"
+            "  --format FORMAT    csv (defaut) ou json\n"
+            "  --output FICHIER   ecrit les resultats dans FICHIER\n",
+            program);
+}
+
+/* Liste de noms séparés par des virgules -> masque ; lookup renvoie -1 si le nom est inconnu. */
+static int parse_name_list(const char *list, int (*lookup)(const char *), int *mask)
+{
+    *mask = 0;
+    char *copy = strdup(list);
+    if (!copy) {
+        perror("strdup bench list");
+        exit(EXIT_FAILURE);
+    }
+    int ok = 1;
+    for (char *tok = strtok(copy, ","); tok; tok = strtok(NULL, ",")) {
+        int index = lookup(tok);
+        if (index < 0) {
+            fprintf(stderr, "Nom inconnu : %s\n", tok);
+            ok = 0;
+        } else {
+            *mask |= 1 << index;
+        }
+    }
+    free(copy);
+    return ok;
+}
+
+static int stage_from_name(const char *name)
+{
+    for (int s = 0; s < NB_STAGES; ++s) {
+        if (strcmp(name, STAGES[s].name) == 0) return s;
+    }
+    return -1;
+}
+
+static int parse_sizes(const char *list, t_bench_options *opt)
+{
+    opt->nb_sizes = 0;
+    const char *p = list;
+    while (*p) {
+        char *end;
+        long n = strtol(p, &end, 10);
+        if (end == p || n < 1 || n > 1000000000L || opt->nb_sizes == BENCH_MAX_SIZES
+            || (*end && *end != ',')) {
+            fprintf(stderr, "Liste de tailles invalide : %s\n", list);
+            return 0;
+        }
+        opt->sizes[opt->nb_sizes++] = (int)n;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return opt->nb_sizes > 0;
+}
+
+static int parse_bench_options(int argc, char **argv, t_bench_options *opt)
+{
+    opt->families = (1 << NB_SYNTH_FAMILIES) - 1;
+    opt->stages = (1 << NB_STAGES) - 1;
+    opt->sizes[0] = 256;
+    opt->sizes[1] = 1024;
+    opt->sizes[2] = 4096;
+    opt->nb_sizes = 3;
+    opt->warmup = 1;
+    opt->repeat = 5;
+    opt->dense_max = 512;
+    opt->seed = 42;
+    opt->json = 0;
+    opt->output = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Option inconnue ou incomplete : %s\n", a);
+            return 0;
+        }
+        const char *v = argv[++i];
+        if (strcmp(a, "--families") == 0) {
+            if (!parse_name_list(v, synthFamilyFromName, &opt->families)) return 0;
+        } else if (strcmp(a, "--stages") == 0) {
+            if (!parse_name_list(v, stage_from_name, &opt->stages)) return 0;
+        } else if (strcmp(a, "--sizes") == 0) {
+            if (!parse_sizes(v, opt)) return 0;
+        } else if (strcmp(a, "--warmup") == 0) {
+            opt->warmup = atoi(v);
+        } else if (strcmp(a, "--repeat") == 0) {
+            opt->repeat = atoi(v);
+        } else if (strcmp(a, "--dense-max") == 0) {
+            opt->dense_max = atoi(v);
+        } else if (strcmp(a, "--power") == 0) {
+            bench_power = atoi(v);
+        } else if (strcmp(a, "--seed") == 0) {
+            opt->seed = strtoull(v, NULL, 10);
+        } else if (strcmp(a, "--format") == 0) {
+            if (strcmp(v, "csv") == 0) opt->json = 0;
+            else if (strcmp(v, "json") == 0) opt->json = 1;
+            else {
+                fprintf(stderr, "Format inconnu : %s\n", v);
+                return 0;
+            }
+        } else if (strcmp(a, "--output") == 0) {
+            opt->output = v;
+        } else {
+            fprintf(stderr, "Option inconnue ou incomplete : %s\n", a);
+            return 0;
+        }
+    }
+    if (opt->warmup < 0 || opt->repeat < 1 || bench_power < 1) {
+        fprintf(stderr, "--warmup >= 0, --repeat >= 1 et --power >= 1 attendus\n");
+        return 0;
+    }
+    return 1;
+}
+
+/* ================= Mesures ================= */
+
+/**
+ * @brief Statistiques des répétitions d'une étape (millisecondes).
+ */
+typedef struct {
+    double min;
+    double median;
+    double mean;
+    double max;
+    double stddev;
+} t_bench_stats;
+
+static double now_ms(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec * 1e3 + (double)t.tv_nsec * 1e-6;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static t_bench_stats measure_stage(const t_bench_stage *stage, t_bench_case *c,
+                                   int warmup, int repeat, double *samples)
+{
+    for (int r = -warmup; r < repeat; ++r) {
+        if (stage->setup) stage->setup(c);
+        double t0 = now_ms();
+        stage->run(c);
+        double t1 = now_ms();
+        if (stage->teardown) stage->teardown(c);
+        if (r >= 0) samples[r] = t1 - t0;
+    }
+
+    qsort(samples, (size_t)repeat, sizeof(double), compare_doubles);
+    t_bench_stats s;
+    s.min = samples[0];
+    s.max = samples[repeat - 1];
+    s.median = repeat % 2 ? samples[repeat / 2] : 0.5 * (samples[repeat / 2 - 1] + samples[repeat / 2]);
+    double sum = 0.0, sq = 0.0;
+    for (int r = 0; r < repeat; ++r) {
+        sum += samples[r];
+    }
+    s.mean = sum / repeat;
+    for (int r = 0; r < repeat; ++r) {
+        sq += (samples[r] - s.mean) * (samples[r] - s.mean);
+    }
+    s.stddev = repeat > 1 ? sqrt(sq / (repeat - 1)) : 0.0;
+    return s;
+}
+
+/* Engendre la chaîne, l'écrit sur disque et calcule ce dont les étapes ont besoin. */
+static void prepare_case(t_bench_case *c, t_synth_family family, int n, const t_bench_options *opt)
+{
+    memset(c, 0, sizeof(*c));
+    c->family = family;
+    c->n = n;
+    c->g = generateChain(family, n, (uint64_t)opt->seed);
+    c->nb_arcs = countArcs(c->g);
+
+    const char *tmp = getenv("TMPDIR");
+    snprintf(c->path, sizeof(c->path), "%s/markov_bench_XXXXXX", tmp && *tmp ? tmp : "/tmp");
+    int fd = mkstemp(c->path);
+    if (fd < 0) {
+        perror(c->path);
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    if (!saveGraph(c->g, c->path)) exit(EXIT_FAILURE);
+
+    c->part = tarjanPartition(c->g);
+    init_link_array(&c->links);
+    build_class_links(c->g, &c->part, &c->links);
+    t_link_array reduced;
+    copy_links(&c->links, &reduced);
+    removeTransitiveLinks(&reduced);
+    c->transient = buildTransientFlags(&c->part, &reduced);
+    free_link_array(&reduced);
+    if (n <= opt->dense_max) c->M = createMatrixFromGraph(c->g);
+}
+
+static void release_case(t_bench_case *c)
+{
+    remove(c->path);
+    freeMatrix(&c->M);
+    free(c->transient);
+    free_link_array(&c->links);
+    freePartition(&c->part);
+    freeGraph(c->g);
+}
+
+static int stage_allowed(const t_bench_stage *stage, const t_bench_case *c, int dense_max)
+{
+    switch (stage->limit) {
+        case LIMIT_DENSE:
+            return c->n <= dense_max;
+        default:
+            return 1;
+    }
+}
+
+static void write_header(FILE *out, const t_bench_options *opt)
+{
+    if (opt->json) {
+        time_t now = time(NULL);
+        char date[32];
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+        fprintf(out, "{\"benchmark\":\"markov_bench\",\"date\":\"%s\",\"seed\":%llu,"
+                     "\"warmup\":%d,\"repeat\":%d,\"dense_max\":%d,\"power\":%d,\"results\":[",
+                date, opt->seed, opt->warmup, opt->repeat, opt->dense_max, bench_power);
+    } else {
+        fprintf(out, "family,n,arcs,classes,stage,repeat,min_ms,median_ms,mean_ms,max_ms,stddev_ms\n");
+    }
+}
+
+static void write_row(FILE *out, const t_bench_options *opt, int index, const t_bench_case *c,
+                      const char *stage, const t_bench_stats *s)
+{
+    if (opt->json) {
+        fprintf(out, "%s\n{\"family\":\"%s\",\"n\":%d,\"arcs\":%d,\"classes\":%d,\"stage\":\"%s\","
+                     "\"repeat\":%d,\"min_ms\":%.4f,\"median_ms\":%.4f,\"mean_ms\":%.4f,"
+                     "\"max_ms\":%.4f,\"stddev_ms\":%.4f}",
+                index ? "," : "", synthFamilyName(c->family), c->n, c->nb_arcs, c->part.size, stage,
+                opt->repeat, s->min, s->median, s->mean, s->max, s->stddev);
+    } else {
+        fprintf(out, "%s,%d,%d,%d,%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                synthFamilyName(c->family), c->n, c->nb_arcs, c->part.size, stage,
+                opt->repeat, s->min, s->median, s->mean, s->max, s->stddev);
+    }
+    fflush(out);
+}
+
+int main(int argc, char **argv)
+{
+    t_bench_options opt;
+    if (!parse_bench_options(argc, argv, &opt)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    FILE *out = stdout;
+    if (opt.output && !(out = fopen(opt.output, "w"))) {
+        perror(opt.output);
+        return EXIT_FAILURE;
+    }
+    double *samples = malloc(sizeof(double) * (size_t)opt.repeat);
+    if (!samples) {
+        perror("malloc bench samples");
+        exit(EXIT_FAILURE);
+    }
+
+    write_header(out, &opt);
+    int rows = 0;
+    for (int f = 0; f < NB_SYNTH_FAMILIES; ++f) {
+        if (!(opt.families & (1 << f))) continue;
+        for (int k = 0; k < opt.nb_sizes; ++k) {
+            t_bench_case c;
+            prepare_case(&c, (t_synth_family)f, opt.sizes[k], &opt);
+            for (int s = 0; s < NB_STAGES; ++s) {
+                if (!(opt.stages & (1 << s))) continue;
+                if (!stage_allowed(&STAGES[s], &c, opt.dense_max)) {
+                    fprintf(stderr, "# %s %s n=%d : saute (--dense-max %d)\n",
+                            STAGES[s].name, synthFamilyName(c.family), c.n, opt.dense_max);
+                    continue;
+                }
+                t_bench_stats st = measure_stage(&STAGES[s], &c, opt.warmup, opt.repeat, samples);
+                write_row(out, &opt, rows++, &c, STAGES[s].name, &st);
+            }
+            release_case(&c);
+        }
+    }
+    if (opt.json) fprintf(out, "\n]}\n");
+
+    free(samples);
+    if (out != stdout) fclose(out);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bitmatrix.h"
+
+#define ROW(m, i) ((m)->bits + (size_t)(i) * (size_t)(m)->words)
+
+t_bitmatrix createBitMatrix(int rows, int cols)
+{
+    t_bitmatrix m;
+    m.rows = rows;
+    m.cols = cols;
+    m.words = (cols + 63) / 64;
+    size_t nb = (size_t)rows * (size_t)m.words;
+    m.bits = calloc(nb > 0 ? nb : 1, sizeof(uint64_t));
+    if (!m.bits) {
+        perror("calloc bitmatrix");
+        exit(EXIT_FAILURE);
+    }
+    return m;
+}
+
+void freeBitMatrix(t_bitmatrix *m)
+{
+    if (!m) return;
+    free(m->bits);
+    m->bits = NULL;
+    m->rows = m->cols = m->words = 0;
+}
+
+int bitMatrixGet(const t_bitmatrix *m, int i, int j)
+{
+    return (int)((ROW(m, i)[j / 64] >> (j % 64)) & 1u);
+}
+
+void bitMatrixSet(t_bitmatrix *m, int i, int j)
+{
+    ROW(m, i)[j / 64] |= (uint64_t)1 << (j % 64);
+}
+
+void bitMatrixMultiply(const t_bitmatrix *A, const t_bitmatrix *B, t_bitmatrix *C)
+{
+    int n = A->rows;
+    int inner = A->cols;
+    int words = B->words;
+    uint64_t *table = malloc(sizeof(uint64_t) * 256 * (size_t)(words > 0 ? words : 1));
+    if (!table) {
+        perror("malloc four russians table");
+        exit(EXIT_FAILURE);
+    }
+
+    memset(C->bits, 0, sizeof(uint64_t) * (size_t)C->rows * (size_t)C->words);
+
+    for (int k0 = 0; k0 < inner; k0 += 8) {
+        int group = inner - k0 < 8 ? inner - k0 : 8;
+
+        /* table[x] = OU des lignes k0+b de B pour chaque bit b de x. */
+        memset(table, 0, sizeof(uint64_t) * (size_t)words);
+        for (int x = 1; x < (1 << group); ++x) {
+            int low = __builtin_ctz((unsigned)x);
+            const uint64_t *prev = table + (size_t)(x & (x - 1)) * (size_t)words;
+            const uint64_t *brow = ROW(B, k0 + low);
+            uint64_t *dst = table + (size_t)x * (size_t)words;
+            for (int w = 0; w < words; ++w) {
+                dst[w] = prev[w] | brow[w];
+            }
+        }
+
+        /* Les 8 bits de A sont alignés dans un même mot puisque k0 est multiple de 8. */
+        for (int i = 0; i < n; ++i) {
+            unsigned x = (unsigned)(ROW(A, i)[k0 / 64] >> (k0 % 64)) & ((1u << group) - 1);
+            if (x == 0) continue;
+            const uint64_t *src = table + (size_t)x * (size_t)words;
+            uint64_t *crow = ROW(C, i);
+            for (int w = 0; w < words; ++w) {
+                crow[w] |= src[w];
+            }
+        }
+    }
+
+    free(table);
+}
+
+t_bitmatrix bitMatrixTransitiveClosure(const t_bitmatrix *M)
+{
+    int n = M->rows;
+    t_bitmatrix R = createBitMatrix(n, n);
+    memcpy(R.bits, M->bits, sizeof(uint64_t) * (size_t)n * (size_t)M->words);
+
+    /* Warshall, une ligne entière par opération. */
+    for (int k = 0; k < n; ++k) {
+        const uint64_t *rk = ROW(&R, k);
+        for (int i = 0; i < n; ++i) {
+            if (!bitMatrixGet(&R, i, k)) continue;
+            uint64_t *ri = ROW(&R, i);
+            for (int w = 0; w < R.words; ++w) {
+                ri[w] |= rk[w];
+            }
+        }
+    }
+    return R;
+}
@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ctmc.h"
+#include "sparse.h"
+#include "utils.h"
+
+#define UNIFORMIZATION_MARGIN 1.02
+/* Poids initial au mode : grand, sans risque de dépassement en remontant les queues. */
+#define FOX_GLYNN_MODE_WEIGHT 1e280
+/* Ecart (norme 1) entre deux itérés sous lequel pi0 * P^k est tenu pour stationnaire. */
+#define STEADY_STATE_FACTOR 1e-3
+
+t_poisson_weights foxGlynn(double lambda_t, double eps)
+{
+    t_poisson_weights w;
+    if (lambda_t <= 0.0) {
+        w.left = w.right = 0;
+        w.weights = malloc(sizeof(double));
+        if (!w.weights) {
+            perror("malloc poisson weights");
+            exit(EXIT_FAILURE);
+        }
+        w.weights[0] = 1.0;
+        return w;
+    }
+
+    int mode = (int)floor(lambda_t);
+    /* Les queues au-delà de mode +/- (sqrt(lambda_t) * c + c') ont une masse
+     * négligeable ; on s'arrête dès que le poids relatif passe sous eps / 1e3. */
+    double cutoff = FOX_GLYNN_MODE_WEIGHT * eps * 1e-3;
+    int span = (int)(10.0 * sqrt(lambda_t + 1.0)) + 50;
+    int lo = mode - span < 0 ? 0 : mode - span;
+    int hi = mode + span;
+    double *tmp = calloc((size_t)(hi - lo + 1), sizeof(double));
+    if (!tmp) {
+        perror("calloc poisson weights");
+        exit(EXIT_FAILURE);
+    }
+
+    tmp[mode - lo] = FOX_GLYNN_MODE_WEIGHT;
+    int left = mode;
+    for (int k = mode; k > lo; --k) {
+        double next = tmp[k - lo] * k / lambda_t;
+        if (next < cutoff) break;
+        tmp[k - 1 - lo] = next;
+        left = k - 1;
+    }
+    int right = mode;
+    for (int k = mode; k < hi; ++k) {
+        double next = tmp[k - lo] * lambda_t / (k + 1);
+        if (next < cutoff) break;
+        tmp[k + 1 - lo] = next;
+        right = k + 1;
+    }
+
+    /* Normalisation en sommant des petits vers les grands poids. */
+    double total = 0.0;
+    int a = left, b = right;
+    while (a < b) {
+        if (tmp[a - lo] < tmp[b - lo]) {
+            total += tmp[a++ - lo];
+        } else {
+            total += tmp[b-- - lo];
+        }
+    }
+    total += tmp[a - lo];
+
+    /* Troncature : on retire les queues tant que leur masse reste <= eps / 2. */
+    double tail = 0.0;
+    while (left < mode && tail + tmp[left - lo] / total <= eps / 2) {
+        tail += tmp[left - lo] / total;
+        left++;
+    }
+    tail = 0.0;
+    while (right > mode && tail + tmp[right - lo] / total <= eps / 2) {
+        tail += tmp[right - lo] / total;
+        right--;
+    }
+
+    w.left = left;
+    w.right = right;
+    w.weights = malloc(sizeof(double) * (size_t)(right - left + 1));
+    if (!w.weights) {
+        perror("malloc poisson weights");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = left; k <= right; ++k) {
+        w.weights[k - left] = tmp[k - lo] / total;
+    }
+    free(tmp);
+    return w;
+}
+
+void freePoissonWeights(t_poisson_weights *w)
+{
+    if (!w) return;
+    free(w->weights);
+    w->weights = NULL;
+    w->left = w->right = 0;
+}
+
+/* Taux de sortie de chaque état (boucles ignorées), sommés en double. */
+static double *exit_rates(const t_graph *Q)
+{
+    int n = Q->nb_vertices;
+    double *out_rate = malloc(sizeof(double) * (size_t)(n > 0 ? n : 1));
+    if (!out_rate) {
+        perror("malloc exit rates");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; ++i) {
+        out_rate[i] = 0.0;
+        for (t_arc *cur = Q->array[i].head; cur; cur = cur->next) {
+            if (cur->dest != i + 1) out_rate[i] += cur->proba;
+        }
+    }
+    return out_rate;
+}
+
+static double rate_from_exits(const double *out_rate, int n)
+{
+    double max_rate = 0.0;
+    for (int i = 0; i < n; ++i) {
+        if (out_rate[i] > max_rate) max_rate = out_rate[i];
+    }
+    return max_rate > 0.0 ? UNIFORMIZATION_MARGIN * max_rate : 1.0;
+}
+
+double uniformizationRate(const t_graph *Q)
+{
+    double *out_rate = exit_rates(Q);
+    double lambda = rate_from_exits(out_rate, Q->nb_vertices);
+    free(out_rate);
+    return lambda;
+}
+
+t_graph *uniformize(const t_graph *Q, double *lambda_out)
+{
+    int n = Q->nb_vertices;
+    double *out_rate = exit_rates(Q);
+    double lambda = rate_from_exits(out_rate, n);
+
+    t_graph *P = createGraph(n);
+    for (int i = 0; i < n; ++i) {
+        addArc(P, i + 1, i + 1, (float)(1.0 - out_rate[i] / lambda));
+        for (t_arc *cur = Q->array[i].head; cur; cur = cur->next) {
+            if (cur->dest == i + 1 || cur->proba == 0.0f) continue;
+            addArc(P, i + 1, cur->dest, (float)(cur->proba / lambda));
+        }
+    }
+    free(out_rate);
+    if (lambda_out) *lambda_out = lambda;
+    return P;
+}
+
+/* y = x * (I + Q / lambda) en double : taux hors diagonale lus dans la CSR de Q,
+ * diagonale diag[j] = 1 - sortie(j) / lambda. Chaque ligne somme à 1 à la
+ * précision du double, l'erreur ne s'accumule donc pas sur lambda * t produits. */
+static void uniformized_step(const t_csr_matrix *Q, const double *diag, double lambda,
+                             const double *x, double *y)
+{
+    for (int j = 0; j < Q->n; ++j) {
+        y[j] = x[j] * diag[j];
+    }
+    for (int i = 0; i < Q->n; ++i) {
+        double xi = x[i] / lambda;
+        if (xi == 0.0) continue;
+        for (int p = Q->row_ptr[i]; p < Q->row_ptr[i + 1]; ++p) {
+            if (Q->col_idx[p] == i) continue;
+            y[Q->col_idx[p]] += xi * (double)Q->values[p];
+        }
+    }
+}
+
+int transientDistribution(const t_graph *Q, const double *pi0, double t,
+                          double eps, double *out)
+{
+    int n = Q->nb_vertices;
+    double *diag = exit_rates(Q);
+    double lambda = rate_from_exits(diag, n);
+    for (int j = 0; j < n; ++j) {
+        diag[j] = 1.0 - diag[j] / lambda;
+    }
+    t_poisson_weights w = foxGlynn(lambda * t, eps);
+    t_csr_matrix A = csrFromGraph(Q);
+    double *v = malloc(sizeof(double) * (size_t)(n > 0 ? n : 1));
+    double *next = malloc(sizeof(double) * (size_t)(n > 0 ? n : 1));
+    if (!v || !next) {
+        perror("malloc transient distribution");
+        exit(EXIT_FAILURE);
+    }
+    for (int j = 0; j < n; ++j) {
+        v[j] = pi0[j];
+        out[j] = 0.0;
+    }
+
+    int products = 0;
+    double applied = 0.0;       /* masse des poids déjà appliqués */
+    for (int k = 0; k <= w.right; ++k) {
+        if (k >= w.left) {
+            double wk = w.weights[k - w.left];
+            for (int j = 0; j < n; ++j) {
+                out[j] += wk * v[j];
+            }
+            applied += wk;
+        }
+        if (k == w.right) break;
+        uniformized_step(&A, diag, lambda, v, next);
+        products++;
+        double *tmp = v;
+        v = next;
+        next = tmp;
+
+        /* Régime stationnaire atteint : les itérés suivants valent v, la masse
+         * restante des poids lui revient sans autre produit. */
+        double diff = 0.0;
+        for (int j = 0; j < n; ++j) {
+            diff += fabs(v[j] - next[j]);
+        }
+        if (diff < eps * STEADY_STATE_FACTOR) {
+            for (int j = 0; j < n; ++j) {
+                out[j] += (1.0 - applied) * v[j];
+            }
+            break;
+        }
+    }
+
+    free(v);
+    free(next);
+    free(diag);
+    freeCsr(&A);
+    freePoissonWeights(&w);
+    return products;
+}
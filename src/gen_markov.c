@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "graph.h"
+#include "synth.h"
+#include "threadpool.h"
+
+#define GEN_CHUNK_STATES 65536
+#define GEN_LINE_MAX 48             /**< Ligne "src dest proba" la plus longue. */
+
+/**
+ * @brief Tranche d'états consécutifs engendrée par une tâche du pool.
+ */
+typedef struct {
+    const t_synth_model *model;
+    int binary;
+    int first;
+    int count;
+    char *buf;
+    size_t len;
+    size_t cap;
+    long long arcs;
+} t_gen_chunk;
+
+static void chunk_reserve(t_gen_chunk *c, size_t extra)
+{
+    if (c->len + extra <= c->cap) return;
+    size_t cap = c->cap ? c->cap : 1 << 20;
+    while (cap < c->len + extra) cap *= 2;
+    char *buf = realloc(c->buf, cap);
+    if (!buf) {
+        perror("realloc generator chunk");
+        exit(EXIT_FAILURE);
+    }
+    c->buf = buf;
+    c->cap = cap;
+}
+
+static char *put_uint(char *p, unsigned x)
+{
+    char tmp[12];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + x % 10);
+        x /= 10;
+    } while (x);
+    while (n > 0) *p++ = tmp[--n];
+    return p;
+}
+
+/* Probabilité à 6 décimales au plus (zéros de fin supprimés), sans printf ;
+ * repli sur %.6g pour les valeurs sous 1e-4. */
+static char *put_proba(char *p, float x)
+{
+    if (x < 1e-4f) return p + sprintf(p, "%.6g", x);
+    long scaled = lround((double)x * 1e6);
+    p = put_uint(p, (unsigned)(scaled / 1000000));
+    long fp = scaled % 1000000;
+    if (fp == 0) return p;
+    char digits[6];
+    for (int i = 5; i >= 0; --i) {
+        digits[i] = (char)('0' + fp % 10);
+        fp /= 10;
+    }
+    int last = 5;
+    while (digits[last] == '0') --last;
+    *p++ = '.';
+    memcpy(p, digits, (size_t)last + 1);
+    return p + last + 1;
+}
+
+static void generate_chunk(void *arg)
+{
+    t_gen_chunk *c = arg;
+    t_synth_arc row[SYNTH_MAX_ROW];
+    c->len = 0;
+    c->arcs = 0;
+    for (int state = c->first; state < c->first + c->count; ++state) {
+        int d = synthRow(c->model, state, row);
+        c->arcs += d;
+        if (c->binary) {
+            chunk_reserve(c, sizeof(uint32_t) + (size_t)d * sizeof(t_binary_arc));
+            uint32_t count = (uint32_t)d;
+            memcpy(c->buf + c->len, &count, sizeof(count));
+            c->len += sizeof(count);
+            for (int k = 0; k < d; ++k) {
+                t_binary_arc a = {(uint32_t)row[k].dest, row[k].proba};
+                memcpy(c->buf + c->len, &a, sizeof(a));
+                c->len += sizeof(a);
+            }
+        } else {
+            chunk_reserve(c, (size_t)d * GEN_LINE_MAX);
+            char *p = c->buf + c->len;
+            for (int k = 0; k < d; ++k) {
+                p = put_uint(p, (unsigned)state);
+                *p++ = ' ';
+                p = put_uint(p, (unsigned)row[k].dest);
+                *p++ = ' ';
+                p = put_proba(p, row[k].proba);
+                *p++ = '\n';
+            }
+            c->len = (size_t)(p - c->buf);
+        }
+    }
+}
+
+/* ================= Options ================= */
+
+typedef struct {
+    t_synth_params params;
+    int binary;
+    int jobs;
+    const char *output;
+} t_gen_options;
+
+static void print_usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage : %s --states N [options]\n"
+            "  --states N         nombre d'etats (jusqu'a 2^31 - 1)\n"
+            "  --degree D         degre sortant moyen (defaut 4, au plus %d)\n"
+            "  --degree-dist LOI  fixed (defaut), uniform (1..2D-1) ou geometric (moyenne D)\n"
+            "  --classes K        classes fortement connexes (defaut 1)\n"
+            "  --closed C         classes persistantes parmi les K, les dernieres (defaut K)\n"
+            "  --period P         periode de chaque classe (defaut 1)\n"
+            "  --absorbing F      fraction d'etats absorbants (defaut 0)\n"
+            "  --leak L           probabilite d'un arc sortant pour un etat transitoire (defaut 0.01)\n"
+            "  --seed S           graine (defaut 42) : meme graine, meme fichier\n"
+            "  --binary           format binaire (voir graph.h), relu par TI301_Markov\n"
+            "  --jobs N           threads (defaut : nombre de processeurs)\n"
+            "  --output FICHIER   fichier de sortie (defaut : sortie standard)\n",
+            program, SYNTH_MAX_DEGREE);
+}
+
+static int parse_gen_options(int argc, char **argv, t_gen_options *opt)
+{
+    t_synth_params *p = &opt->params;
+    p->nb_states = 0;
+    p->degree = 4;
+    p->degree_dist = DEGREE_FIXED;
+    p->nb_classes = 1;
+    p->nb_closed = -1;
+    p->period = 1;
+    p->absorbing = 0.0;
+    p->leak = 0.01;
+    p->seed = 42;
+    opt->binary = 0;
+    opt->jobs = 0;
+    opt->output = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        if (strcmp(a, "--binary") == 0) {
+            opt->binary = 1;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Option inconnue ou incomplete : %s\n", a);
+            return 0;
+        }
+        const char *v = argv[++i];
+        if (strcmp(a, "--states") == 0) {
+            long n = strtol(v, NULL, 10);
+            p->nb_states = n > 0 && n <= 2147483647L ? (int)n : -1;
+        } else if (strcmp(a, "--degree") == 0) {
+            p->degree = atoi(v);
+        } else if (strcmp(a, "--degree-dist") == 0) {
+            if (strcmp(v, "fixed") == 0) p->degree_dist = DEGREE_FIXED;
+            else if (strcmp(v, "uniform") == 0) p->degree_dist = DEGREE_UNIFORM;
+            else if (strcmp(v, "geometric") == 0) p->degree_dist = DEGREE_GEOMETRIC;
+            else {
+                fprintf(stderr, "Loi de degre inconnue : %s\n", v);
+                return 0;
+            }
+        } else if (strcmp(a, "--classes") == 0) {
+            p->nb_classes = atoi(v);
+        } else if (strcmp(a, "--closed") == 0) {
+            p->nb_closed = atoi(v);
+        } else if (strcmp(a, "--period") == 0) {
+            p->period = atoi(v);
+        } else if (strcmp(a, "--absorbing") == 0) {
+            p->absorbing = atof(v);
+        } else if (strcmp(a, "--leak") == 0) {
+            p->leak = atof(v);
+        } else if (strcmp(a, "--seed") == 0) {
+            p->seed = strtoull(v, NULL, 10);
+        } else if (strcmp(a, "--jobs") == 0) {
+            opt->jobs = atoi(v);
+        } else if (strcmp(a, "--output") == 0) {
+            opt->output = v;
+        } else {
+            fprintf(stderr, "Option inconnue ou incomplete : %s\n", a);
+            return 0;
+        }
+    }
+    if (p->nb_states == 0) {
+        fprintf(stderr, "--states est obligatoire\n");
+        return 0;
+    }
+    if (p->nb_closed < 0) p->nb_closed = p->nb_classes;
+    return 1;
+}
+
+/* ================= Ecriture ================= */
+
+static double now_seconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static void write_or_die(const void *data, size_t size, FILE *out, const char *name)
+{
+    if (size && fwrite(data, 1, size, out) != size) {
+        perror(name);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Tranches de la vague wave placées dans slot et soumises au pool. */
+static void submit_wave(t_thread_pool *pool, t_gen_chunk *slot, int per_wave, int wave,
+                        int nb_states, t_task_group *group)
+{
+    for (int k = 0; k < per_wave; ++k) {
+        long long first = ((long long)wave * per_wave + k) * GEN_CHUNK_STATES + 1;
+        slot[k].count = 0;
+        if (first > nb_states) continue;
+        slot[k].first = (int)first;
+        slot[k].count = (int)(nb_states - first + 1 < GEN_CHUNK_STATES ? nb_states - first + 1
+                                                                        : GEN_CHUNK_STATES);
+        pool_submit(pool, generate_chunk, &slot[k], group);
+    }
+}
+
+/* Les threads du pool engendrent une vague de tranches pendant que le thread
+ * principal écrit la précédente, dans l'ordre des états. */
+int main(int argc, char **argv)
+{
+    t_gen_options opt;
+    t_synth_model model;
+    if (!parse_gen_options(argc, argv, &opt)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!initSynthModel(&model, &opt.params)) return EXIT_FAILURE;
+
+    const char *name = opt.output ? opt.output : "stdout";
+    FILE *out = stdout;
+    if (opt.output && !(out = fopen(opt.output, "wb"))) {
+        perror(opt.output);
+        return EXIT_FAILURE;
+    }
+    double t0 = now_seconds();
+    int n = opt.params.nb_states;
+    if (opt.binary) {
+        uint32_t header = (uint32_t)n;
+        write_or_die(GRAPH_BINARY_MAGIC, 4, out, name);
+        write_or_die(&header, sizeof(header), out, name);
+    } else {
+        fprintf(out, "%d\n", n);
+    }
+
+    t_thread_pool *pool = pool_create(opt.jobs);
+    int per_wave = 2 * pool_size(pool);
+    int nb_chunks = (int)(((long long)n + GEN_CHUNK_STATES - 1) / GEN_CHUNK_STATES);
+    int nb_waves = (nb_chunks + per_wave - 1) / per_wave;
+    t_gen_chunk *slots[2];
+    t_task_group groups[2] = {{0}, {0}};
+    for (int s = 0; s < 2; ++s) {
+        slots[s] = calloc((size_t)per_wave, sizeof(t_gen_chunk));
+        if (!slots[s]) {
+            perror("calloc generator chunks");
+            exit(EXIT_FAILURE);
+        }
+        for (int k = 0; k < per_wave; ++k) {
+            slots[s][k].model = &model;
+            slots[s][k].binary = opt.binary;
+        }
+    }
+
+    long long arcs = 0;
+    size_t bytes = 0;
+    submit_wave(pool, slots[0], per_wave, 0, n, &groups[0]);
+    for (int wave = 0; wave < nb_waves; ++wave) {
+        int s = wave & 1;
+        if (wave + 1 < nb_waves) submit_wave(pool, slots[1 - s], per_wave, wave + 1, n, &groups[1 - s]);
+        pool_wait(pool, &groups[s]);
+        for (int k = 0; k < per_wave && slots[s][k].count > 0; ++k) {
+            write_or_die(slots[s][k].buf, slots[s][k].len, out, name);
+            arcs += slots[s][k].arcs;
+            bytes += slots[s][k].len;
+        }
+    }
+    pool_destroy(pool);
+    for (int s = 0; s < 2; ++s) {
+        for (int k = 0; k < per_wave; ++k) {
+            free(slots[s][k].buf);
+        }
+        free(slots[s]);
+    }
+
+    if (fflush(out) != 0 || (out != stdout && fclose(out) != 0)) {
+        perror(name);
+        return EXIT_FAILURE;
+    }
+    double elapsed = now_seconds() - t0;
+    fprintf(stderr, "# %d etats, %lld arcs, %d classes (%d persistantes), periode %d, "
+                    "%d absorbants : %.1f Mo en %.2f s (%.0f Mo/s)\n",
+            n, arcs, opt.params.nb_classes, opt.params.nb_closed, opt.params.period,
+            synthAbsorbingStates(&model), bytes / 1e6, elapsed,
+            elapsed > 0 ? bytes / 1e6 / elapsed : 0.0);
+    return EXIT_SUCCESS;
+}
@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include "graph.h"
 #include "utils.h"
 
@@ -24,12 +26,97 @@ static void add_arc(t_graph *g, int src, int dest, float proba)
     g->array[src - 1].head = new_arc;
 }
 
+t_graph *createGraph(int nb_vertices)
+{
+    t_graph *g = malloc(sizeof(t_graph));
+    if (!g) {
+        perror("malloc graph");
+        exit(EXIT_FAILURE);
+    }
+    g->nb_vertices = nb_vertices;
+    g->continuous = 0;
+    g->array = calloc((size_t)(nb_vertices > 0 ? nb_vertices : 1), sizeof(t_adj_list));
+    if (!g->array) {
+        perror("calloc adjacency lists");
+        exit(EXIT_FAILURE);
+    }
+    return g;
+}
+
+void addArc(t_graph *g, int src, int dest, float proba)
+{
+    add_arc(g, src, dest, proba);
+}
+
+/* Lignes du format binaire, ajoutées dans l'ordre du fichier comme pour le
+ * format texte : les deux formats donnent le même graphe. */
+static t_graph *read_binary_graph(FILE *f, const char *filename)
+{
+    uint32_t n;
+    if (fread(&n, sizeof(n), 1, f) != 1 || n > (uint32_t)INT_MAX) {
+        fprintf(stderr, "%s : en-tete binaire invalide\n", filename);
+        return NULL;
+    }
+    t_graph *g = createGraph((int)n);
+    t_binary_arc *row = NULL;
+    uint32_t capacity = 0;
+    const char *error = NULL;
+    for (int i = 1; !error && i <= (int)n; ++i) {
+        uint32_t d;
+        if (fread(&d, sizeof(d), 1, f) != 1) {
+            error = "fichier binaire tronque";
+            break;
+        }
+        if (d > capacity) {
+            capacity = d;
+            row = realloc(row, (size_t)capacity * sizeof(t_binary_arc));
+            if (!row) {
+                perror("realloc binary row");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (fread(row, sizeof(t_binary_arc), d, f) != d) {
+            error = "fichier binaire tronque";
+            break;
+        }
+        /* Un sommet d'arrivée hors de 1..n ferait lire hors des tableaux de
+         * tous les noyaux : le fichier est refusé. */
+        for (uint32_t k = 0; k < d; ++k) {
+            if (row[k].dest == 0 || row[k].dest > n) {
+                error = "sommet d'arrivee hors de 1..n, fichier binaire corrompu";
+                break;
+            }
+            add_arc(g, i, (int)row[k].dest, row[k].proba);
+        }
+    }
+    free(row);
+    if (error) {
+        fprintf(stderr, "%s : %s\n", filename, error);
+        freeGraph(g);
+        return NULL;
+    }
+    return g;
+}
+
 t_graph *readGraph(const char *filename)
 {
-    FILE *f = fopen(filename, "rt");
+    FILE *f = fopen(filename, "rb");
+    if (!f) {
+        perror(filename);
+        return NULL;
+    }
+
+    char magic[4];
+    if (fread(magic, 1, sizeof(magic), f) == sizeof(magic)
+        && memcmp(magic, GRAPH_BINARY_MAGIC, sizeof(magic)) == 0) {
+        t_graph *g = read_binary_graph(f, filename);
+        fclose(f);
+        return g;
+    }
+    rewind(f);
 
     int n;
-    if (fscanf(f, "%d", &n) != 1) {
+    if (fscanf(f, "%d", &n) != 1 || n < 0) {
         fprintf(stderr, "Erreur lecture nb sommets\n");
         fclose(f);
         return NULL;
@@ -38,6 +125,7 @@ t_graph *readGraph(const char *filename)
     t_graph *g = malloc(sizeof(t_graph));
 
     g->nb_vertices = n;
+    g->continuous = 0;
     g->array = calloc((size_t)n, sizeof(t_adj_list));
 
     int depart, arrivee;
@@ -50,6 +138,15 @@ t_graph *readGraph(const char *filename)
     return g;
 }
 
+int countArcs(const t_graph *g)
+{
+    int nb_arcs = 0;
+    for (int i = 0; i < g->nb_vertices; ++i) {
+        for (t_arc *cur = g->array[i].head; cur; cur = cur->next) nb_arcs++;
+    }
+    return nb_arcs;
+}
+
 void freeGraph(t_graph *g)
 {
     if (!g) return;
@@ -80,25 +177,102 @@ void printAdjList(const t_graph *g)
     }
 }
 
+/* Vérifie la ligne i ; si verbose, affiche les défauts trouvés. */
+static int check_row(const t_graph *g, int i, float eps, int verbose)
+{
+    float target = g->continuous ? 0.0f : 1.0f;
+    int ok = 1;
+    float sum = 0.0f;
+    for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
+        sum += cur->proba;
+        if (g->continuous && cur->dest != i + 1 && cur->proba < 0.0f) {
+            if (verbose) printf("Sommet %d : taux negatif vers %d (%.4f)\n", i + 1, cur->dest, cur->proba);
+            ok = 0;
+        }
+    }
+    if (sum < target - eps || sum > target + eps) {
+        if (verbose) printf("Sommet %d : somme des %s = %.4f (hors [%g-eps,%g+eps])\n",
+                            i + 1, g->continuous ? "taux" : "probabilites", sum, target, target);
+        ok = 0;
+    }
+    return ok;
+}
+
 int checkMarkov(const t_graph *g, float eps)
 {
     if (!g) return 0;
     int ok = 1;
     for (int i = 0; i < g->nb_vertices; ++i) {
+        if (!check_row(g, i, eps, 1)) ok = 0;
+    }
+    const char *kind = g->continuous ? "un generateur de Markov (temps continu)" : "un graphe de Markov";
+    if (ok)
+        printf("Le graphe est %s (eps=%.3f)\n", kind, eps);
+    else
+        printf("Le graphe N'EST PAS %s (eps=%.3f)\n", kind, eps);
+    return ok;
+}
+
+int isMarkovGraph(const t_graph *g, float eps)
+{
+    if (!g) return 0;
+    for (int i = 0; i < g->nb_vertices; ++i) {
+        if (!check_row(g, i, eps, 0)) return 0;
+    }
+    return 1;
+}
+
+t_markov_check verifyMarkov(const t_graph *g, float eps)
+{
+    t_markov_check check = {g != NULL, 0, NULL, NULL};
+    if (!g) return check;
+    for (int i = 0; i < g->nb_vertices; ++i) {
+        if (check_row(g, i, eps, 0)) continue;
+        if (!check.invalid_rows) {
+            check.invalid_rows = malloc(sizeof(int) * (size_t)g->nb_vertices);
+            check.row_sums = malloc(sizeof(float) * (size_t)g->nb_vertices);
+            if (!check.invalid_rows || !check.row_sums) {
+                perror("malloc markov check");
+                exit(EXIT_FAILURE);
+            }
+        }
         float sum = 0.0f;
         for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
             sum += cur->proba;
         }
-        if (sum < 1.0f - eps || sum > 1.0f + eps) {
-            printf("Sommet %d : somme des probabilites = %.4f (hors [1-eps,1+eps])\n",
-                   i + 1, sum);
-            ok = 0;
+        check.invalid_rows[check.nb_invalid] = i + 1;
+        check.row_sums[check.nb_invalid++] = sum;
+        check.valid = 0;
+    }
+    return check;
+}
+
+void freeMarkovCheck(t_markov_check *check)
+{
+    if (!check) return;
+    free(check->invalid_rows);
+    free(check->row_sums);
+    check->invalid_rows = NULL;
+    check->row_sums = NULL;
+    check->nb_invalid = 0;
+}
+
+int saveGraph(const t_graph *g, const char *filename)
+{
+    FILE *f = fopen(filename, "wt");
+    if (!f) {
+        perror(filename);
+        return 0;
+    }
+    fprintf(f, "%d\n", g->nb_vertices);
+    for (int i = 0; i < g->nb_vertices; ++i) {
+        for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
+            fprintf(f, "%d %d %.9g\n", i + 1, cur->dest, cur->proba);
         }
     }
-    if (ok)
-        printf("Le graphe est un graphe de Markov (eps=%.3f)\n", eps);
-    else
-        printf("Le graphe N'EST PAS un graphe de Markov (eps=%.3f)\n", eps);
+    int ok = !ferror(f);
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) perror(filename);
     return ok;
 }
 
@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "hasse.h"
+#include "bitmatrix.h"
 #include "utils.h"
+#include "hwcounters.h"
 
 void init_link_array(t_link_array *arr)
 {
@@ -29,14 +31,15 @@ static int link_exists(const t_link_array *arr, int from, int to)
     return 0;
 }
 
-void add_link_unique(t_link_array *arr, int from, int to)
+static void push_link(t_link_array *arr, int from, int to)
 {
-    if (from == to) return;
-    if (link_exists(arr, from, to)) return;
-
     if (arr->size >= arr->capacity) {
         arr->capacity *= 2;
-        t_link *tmp = realloc(arr->data, sizeof(t_link) * (size_t)arr->capacity)
+        t_link *tmp = realloc(arr->data, sizeof(t_link) * (size_t)arr->capacity);
+        if (!tmp) {
+            perror("realloc links");
+            exit(EXIT_FAILURE);
+        }
         arr->data = tmp;
     }
     arr->data[arr->size].from = from;
@@ -44,58 +47,177 @@ void add_link_unique(t_link_array *arr, int from, int to)
     arr->size++;
 }
 
+void add_link_unique(t_link_array *arr, int from, int to)
+{
+    if (from == to) return;
+    if (link_exists(arr, from, to)) return;
+    push_link(arr, from, to);
+}
+
 void build_class_links(const t_graph *g, const t_partition *part, t_link_array *links)
 {
-    int n = g->nb_vertices;
-    int *vertex_to_class = buildVertexToClass(part, n);
-
-    for (int i = 0; i < n; ++i) {
-        int Ci = vertex_to_class[i];
-        for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
-            int j = cur->dest - 1;
-            int Cj = vertex_to_class[j];
-            if (Ci != Cj) {
-                add_link_unique(links, Ci, Cj);
+    double nb_arcs = hwCountersEnabled() ? countArcs(g) : 0.0;
+    t_hw_probe probe;
+    hwProbeBegin(&probe, KERNEL_CLASS_LINKS);
+    int *vertex_to_class = buildVertexToClass(part, g->nb_vertices);
+    /* seen[Cj] = Ci + 1 si le lien Ci -> Cj est déjà ajouté : les sommets sont
+     * parcourus classe par classe, un lien est donc vu une fois (temps linéaire). */
+    int *seen = calloc_int_array(part->size > 0 ? part->size : 1);
+
+    for (int ci = 0; ci < part->size; ++ci) {
+        const t_class *c = &part->classes[ci];
+        for (int k = 0; k < c->size; ++k) {
+            for (t_arc *cur = g->array[c->vertices[k] - 1].head; cur; cur = cur->next) {
+                int Cj = vertex_to_class[cur->dest - 1];
+                if (Cj != ci && seen[Cj] != ci + 1) {
+                    seen[Cj] = ci + 1;
+                    push_link(links, ci, Cj);
+                }
             }
         }
     }
 
+    free(seen);
     free(vertex_to_class);
+    hwProbeEnd(&probe, 0.0, nb_arcs);
 }
 
-void removeTransitiveLinks(t_link_array *links)
+/* Au-delà de ce nombre de classes, les trois matrices booléennes C x C
+ * (C^2 / 8 octets chacune, fermeture en O(C^3 / 64)) coûtent plus que des
+ * parcours sur les listes de successeurs. */
+#define DENSE_REDUCTION_MAX_CLASSES 4096
+
+static void remove_transitive_dense(t_link_array *links, int nb_classes)
 {
-    int changed = 1;
-    while (changed) {
-        changed = 0;
-        for (int i = 0; i < links->size; ++i) {
-            t_link l1 = links->data[i];
-            if (l1.from == -1) continue;
-
-            for (int j = 0; j < links->size; ++j) {
-                t_link l2 = links->data[j];
-                if (l2.from == -1) continue;
-                if (l1.to == l2.from) {
-                    for (int k = 0; k < links->size; ++k) {
-                        t_link l3 = links->data[k];
-                        if (l3.from == -1) continue;
-                        if (l3.from == l1.from && l3.to == l2.to) {
-                            links->data[k].from = -1;
-                            changed = 1;
-                        }
-                    }
-                }
-            }
-        }
+    t_bitmatrix direct = createBitMatrix(nb_classes, nb_classes);
+    for (int i = 0; i < links->size; ++i) {
+        bitMatrixSet(&direct, links->data[i].from, links->data[i].to);
     }
 
+    /* Un lien a -> b est transitif si b est atteint depuis a par un chemin de
+     * longueur >= 2, c'est-à-dire si (direct * fermeture)[a][b] vaut 1. */
+    t_bitmatrix reach = bitMatrixTransitiveClosure(&direct);
+    t_bitmatrix longer = createBitMatrix(nb_classes, nb_classes);
+    bitMatrixMultiply(&direct, &reach, &longer);
+
     int w = 0;
     for (int i = 0; i < links->size; ++i) {
-        if (links->data[i].from != -1) {
+        if (!bitMatrixGet(&longer, links->data[i].from, links->data[i].to)) {
             links->data[w++] = links->data[i];
         }
     }
     links->size = w;
+
+    freeBitMatrix(&longer);
+    freeBitMatrix(&reach);
+    freeBitMatrix(&direct);
+}
+
+static void remove_transitive_sparse(t_link_array *links, int nb_classes)
+{
+    int nb_links = links->size;
+    /* Successeurs de chaque classe (indices des liens), façon CSR. */
+    int *start = calloc_int_array(nb_classes + 1);
+    for (int i = 0; i < nb_links; ++i) start[links->data[i].from + 1]++;
+    for (int c = 0; c < nb_classes; ++c) start[c + 1] += start[c];
+    int *succ = malloc(sizeof(int) * (size_t)(nb_links > 0 ? nb_links : 1));
+    int *fill = malloc(sizeof(int) * (size_t)nb_classes);
+    int *indegree = calloc_int_array(nb_classes);
+    int *position = malloc(sizeof(int) * (size_t)nb_classes);
+    int *stack = malloc(sizeof(int) * (size_t)(nb_classes + 1));
+    if (!succ || !fill || !position || !stack) {
+        perror("malloc hasse reduction");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < nb_classes; ++c) fill[c] = start[c];
+    for (int i = 0; i < nb_links; ++i) {
+        succ[fill[links->data[i].from]++] = i;
+        indegree[links->data[i].to]++;
+    }
+
+    /* Rang topologique (Kahn) : tout chemin a ->...-> b vérifie
+     * position[a] < position[b], ce qui borne les parcours ci-dessous. Les
+     * classes prises dans un cycle gardent le rang nb_classes (pas d'élagage). */
+    int head = 0, tail = 0;
+    for (int c = 0; c < nb_classes; ++c) {
+        position[c] = nb_classes;
+        if (indegree[c] == 0) fill[tail++] = c;
+    }
+    while (head < tail) {
+        int c = fill[head];
+        position[c] = head++;
+        for (int k = start[c]; k < start[c + 1]; ++k) {
+            int d = links->data[succ[k]].to;
+            if (--indegree[d] == 0) fill[tail++] = d;
+        }
+    }
+
+    /* reached[v] == a + 1 : v est atteint depuis a par un chemin de longueur
+     * >= 2. Le parcours part des successeurs de a et s'arrête au-delà du rang
+     * du plus lointain d'entre eux. */
+    int *reached = indegree;
+    for (int c = 0; c < nb_classes; ++c) reached[c] = 0;
+    char *transitive = calloc((size_t)(nb_links > 0 ? nb_links : 1), 1);
+    if (!transitive) {
+        perror("calloc hasse reduction");
+        exit(EXIT_FAILURE);
+    }
+    for (int a = 0; a < nb_classes; ++a) {
+        if (start[a + 1] - start[a] < 2) continue;
+        int limit = 0;
+        for (int k = start[a]; k < start[a + 1]; ++k) {
+            int b = links->data[succ[k]].to;
+            if (position[b] > limit) limit = position[b];
+        }
+        int top = 0;
+        for (int k = start[a]; k < start[a + 1]; ++k) {
+            stack[top++] = links->data[succ[k]].to;
+            while (top > 0) {
+                int v = stack[--top];
+                for (int q = start[v]; q < start[v + 1]; ++q) {
+                    int d = links->data[succ[q]].to;
+                    if (reached[d] == a + 1 || position[d] > limit) continue;
+                    reached[d] = a + 1;
+                    stack[top++] = d;
+                }
+            }
+        }
+        for (int k = start[a]; k < start[a + 1]; ++k) {
+            if (reached[links->data[succ[k]].to] == a + 1) transitive[succ[k]] = 1;
+        }
+    }
+
+    int w = 0;
+    for (int i = 0; i < nb_links; ++i) {
+        if (!transitive[i]) links->data[w++] = links->data[i];
+    }
+    links->size = w;
+
+    free(transitive);
+    free(stack);
+    free(position);
+    free(indegree);
+    free(fill);
+    free(succ);
+    free(start);
+}
+
+void removeTransitiveLinks(t_link_array *links)
+{
+    t_hw_probe probe;
+    hwProbeBegin(&probe, KERNEL_HASSE_REDUCTION);
+    double nb_links = links->size;
+    int nb_classes = 0;
+    for (int i = 0; i < links->size; ++i) {
+        if (links->data[i].from >= nb_classes) nb_classes = links->data[i].from + 1;
+        if (links->data[i].to >= nb_classes) nb_classes = links->data[i].to + 1;
+    }
+    if (nb_classes <= DENSE_REDUCTION_MAX_CLASSES) {
+        if (nb_classes > 0) remove_transitive_dense(links, nb_classes);
+    } else {
+        remove_transitive_sparse(links, nb_classes);
+    }
+    hwProbeEnd(&probe, 0.0, nb_links);
 }
 
 int export_mermaid_hasse(const t_partition *part, const t_link_array *links, const char *filename)
@@ -129,12 +251,10 @@ int export_mermaid_hasse(const t_partition *part, const t_link_array *links, con
     return 1;
 }
 
-void classify_graph(const t_graph *g, const t_partition *part, const t_link_array *links)
+int *buildTransientFlags(const t_partition *part, const t_link_array *links)
 {
-    if (!g || !part || !links) return;
-
     int nb_classes = part->size;
-    int *has_outgoing = calloc((size_t)nb_classes, sizeof(int));
+    int *has_outgoing = calloc((size_t)(nb_classes > 0 ? nb_classes : 1), sizeof(int));
     if (!has_outgoing) {
         perror("calloc has_outgoing");
         exit(EXIT_FAILURE);
@@ -146,21 +266,44 @@ void classify_graph(const t_graph *g, const t_partition *part, const t_link_arra
             has_outgoing[from] = 1;
         }
     }
+    return has_outgoing;
+}
+
+t_class_kind *classifyClasses(const t_partition *part, const t_link_array *links)
+{
+    int *transient = buildTransientFlags(part, links);
+    t_class_kind *kinds = malloc(sizeof(t_class_kind) * (size_t)(part->size > 0 ? part->size : 1));
+    if (!kinds) {
+        perror("malloc class kinds");
+        exit(EXIT_FAILURE);
+    }
+    for (int ci = 0; ci < part->size; ++ci) {
+        if (transient[ci]) kinds[ci] = CLASS_TRANSIENT;
+        else kinds[ci] = part->classes[ci].size == 1 ? CLASS_ABSORBING : CLASS_PERSISTENT;
+    }
+    free(transient);
+    return kinds;
+}
+
+void classify_graph(const t_graph *g, const t_partition *part, const t_link_array *links)
+{
+    if (!g || !part || !links) return;
+
+    int nb_classes = part->size;
+    t_class_kind *kinds = classifyClasses(part, links);
 
     printf("\n=== Caracteristiques des classes ===\n");
     for (int ci = 0; ci < nb_classes; ++ci) {
         const t_class *c = &part->classes[ci];
-        int transient = has_outgoing[ci];
-        int persistent = !transient;
         printf("%s: {", c->name);
         for (int j = 0; j < c->size; ++j) {
             printf("%d", c->vertices[j]);
             if (j + 1 < c->size) printf(", ");
         }
         printf("} -> ");
-        if (persistent) printf("classe persistante");
-        else printf("classe transitoire");
-        if (persistent && c->size == 1) {
+        if (kinds[ci] == CLASS_TRANSIENT) printf("classe transitoire");
+        else printf("classe persistante");
+        if (kinds[ci] == CLASS_ABSORBING) {
             printf(" (etat absorbant)");
         }
         printf("\n");
@@ -172,5 +315,5 @@ void classify_graph(const t_graph *g, const t_partition *part, const t_link_arra
         printf("\nLe graphe de Markov n'est pas irreductible.\n");
     }
 
-    free(has_outgoing);
+    free(kinds);
 }
@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "hwcounters.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define CACHE_LINE_BYTES 64
+#define MEMORY_BOUND_MPKI 5.0   /* au-delà : noyau considéré limité par la mémoire */
+
+static const char *KERNEL_NAMES[NB_KERNELS] = {
+    "multiplyMatrices",
+    "multiply_rows",
+    "tarjanPartition",
+    "build_class_links",
+    "removeTransitiveLinks",
+};
+
+/**
+ * @brief Mesures cumulées d'un noyau.
+ */
+typedef struct {
+    long calls;
+    long counted_calls;         /**< Appels mesurés avec les compteurs. */
+    double wall;
+    uint64_t values[HW_NB_EVENTS];
+    double flops;
+    double arcs;
+    double counted_arcs;
+} t_kernel_record;
+
+/**
+ * @brief Groupe de compteurs d'un thread (le cycle est le meneur du groupe).
+ */
+typedef struct {
+    int open;
+    int fds[HW_NB_EVENTS];      /**< -1 si l'événement n'a pas pu être ouvert. */
+    int slot[HW_NB_EVENTS];     /**< Rang de l'événement dans la lecture du groupe, -1 si absent. */
+    int nb_slots;
+} t_thread_counters;
+
+static int hw_on = 0;
+static pthread_mutex_t hw_lock = PTHREAD_MUTEX_INITIALIZER;
+static t_kernel_record kernel_records[NB_KERNELS];
+static int event_seen[HW_NB_EVENTS];
+static char unavailable_reason[128] = "";
+
+static pthread_key_t counters_key;
+static pthread_once_t counters_once = PTHREAD_ONCE_INIT;
+
+static double wall_seconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/* ================= Groupe de compteurs par thread ================= */
+
+static void close_counters(void *arg)
+{
+    t_thread_counters *tc = arg;
+#ifdef __linux__
+    for (int e = 0; e < HW_NB_EVENTS; ++e) {
+        if (tc->fds[e] >= 0) close(tc->fds[e]);
+    }
+#endif
+    free(tc);
+}
+
+static void create_key(void)
+{
+    pthread_key_create(&counters_key, close_counters);
+}
+
+static void set_unavailable(const char *reason)
+{
+    pthread_mutex_lock(&hw_lock);
+    if (!unavailable_reason[0]) snprintf(unavailable_reason, sizeof(unavailable_reason), "%s", reason);
+    pthread_mutex_unlock(&hw_lock);
+}
+
+#ifdef __linux__
+static const uint64_t EVENT_CONFIGS[HW_NB_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+static int open_event(uint64_t config, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif
+
+static void open_counters(t_thread_counters *tc)
+{
+    for (int e = 0; e < HW_NB_EVENTS; ++e) {
+        tc->fds[e] = -1;
+        tc->slot[e] = -1;
+    }
+    tc->nb_slots = 0;
+    tc->open = 0;
+#ifdef __linux__
+    tc->fds[HW_CYCLES] = open_event(EVENT_CONFIGS[HW_CYCLES], -1);
+    if (tc->fds[HW_CYCLES] < 0) {
+        char reason[128];
+        snprintf(reason, sizeof(reason), "perf_event_open : %s", strerror(errno));
+        set_unavailable(reason);
+        return;
+    }
+    tc->slot[HW_CYCLES] = tc->nb_slots++;
+    for (int e = HW_CYCLES + 1; e < HW_NB_EVENTS; ++e) {
+        tc->fds[e] = open_event(EVENT_CONFIGS[e], tc->fds[HW_CYCLES]);
+        if (tc->fds[e] >= 0) tc->slot[e] = tc->nb_slots++;
+    }
+    tc->open = 1;
+    pthread_mutex_lock(&hw_lock);
+    for (int e = 0; e < HW_NB_EVENTS; ++e) {
+        if (tc->slot[e] >= 0) event_seen[e] = 1;
+    }
+    pthread_mutex_unlock(&hw_lock);
+#else
+    set_unavailable("perf_event_open absent (Linux seulement)");
+#endif
+}
+
+static t_thread_counters *thread_counters(void)
+{
+    pthread_once(&counters_once, create_key);
+    t_thread_counters *tc = pthread_getspecific(counters_key);
+    if (!tc) {
+        tc = malloc(sizeof(t_thread_counters));
+        if (!tc) {
+            perror("malloc thread counters");
+            exit(EXIT_FAILURE);
+        }
+        open_counters(tc);
+        pthread_setspecific(counters_key, tc);
+    }
+    return tc;
+}
+
+/* Lecture du groupe, valeurs corrigées du multiplexage (temps actif / temps compté). */
+static int read_counters(const t_thread_counters *tc, uint64_t values[HW_NB_EVENTS])
+{
+#ifdef __linux__
+    uint64_t buf[3 + HW_NB_EVENTS];
+    ssize_t n = read(tc->fds[HW_CYCLES], buf, sizeof(buf));
+    if (n < (ssize_t)(3 * sizeof(uint64_t))) return 0;
+    double scale = buf[2] ? (double)buf[1] / (double)buf[2] : 1.0;
+    for (int e = 0; e < HW_NB_EVENTS; ++e) {
+        values[e] = tc->slot[e] >= 0 ? (uint64_t)((double)buf[3 + tc->slot[e]] * scale) : 0;
+    }
+    return 1;
+#else
+    (void)tc;
+    (void)values;
+    return 0;
+#endif
+}
+
+/* ================= Mesures ================= */
+
+void hwCountersEnable(void)
+{
+    hw_on = 1;
+}
+
+int hwCountersEnabled(void)
+{
+    return hw_on;
+}
+
+void hwProbeBegin(t_hw_probe *p, t_kernel kernel)
+{
+    p->active = hw_on;
+    if (!p->active) return;
+    p->kernel = kernel;
+    t_thread_counters *tc = thread_counters();
+    p->counted = tc->open && read_counters(tc, p->values);
+    p->wall = wall_seconds();
+}
+
+void hwProbeEnd(t_hw_probe *p, double flops, double arcs)
+{
+    if (!p->active) return;
+    double wall = wall_seconds() - p->wall;
+    uint64_t end[HW_NB_EVENTS];
+    int counted = p->counted && read_counters(thread_counters(), end);
+
+    pthread_mutex_lock(&hw_lock);
+    t_kernel_record *r = &kernel_records[p->kernel];
+    r->calls++;
+    r->wall += wall;
+    r->flops += flops;
+    r->arcs += arcs;
+    if (counted) {
+        r->counted_calls++;
+        r->counted_arcs += arcs;
+        for (int e = 0; e < HW_NB_EVENTS; ++e) {
+            r->values[e] += end[e] - p->values[e];
+        }
+    }
+    pthread_mutex_unlock(&hw_lock);
+}
+
+/* ================= Rapport ================= */
+
+/**
+ * @brief Métriques dérivées d'un noyau (-1 si non mesurable).
+ */
+typedef struct {
+    double ipc;
+    double gflops;
+    double mpki;
+    double bytes_per_arc;
+    const char *bound;
+} t_kernel_metrics;
+
+static t_kernel_metrics kernel_metrics(const t_kernel_record *r)
+{
+    t_kernel_metrics m = {-1.0, -1.0, -1.0, -1.0, "-"};
+    const uint64_t *v = r->values;
+    if (r->flops > 0.0 && r->wall > 0.0) m.gflops = r->flops / r->wall * 1e-9;
+    if (!r->counted_calls) return m;
+    if (event_seen[HW_CYCLES] && event_seen[HW_INSTRUCTIONS] && v[HW_CYCLES] > 0) {
+        m.ipc = (double)v[HW_INSTRUCTIONS] / (double)v[HW_CYCLES];
+    }
+    if (event_seen[HW_LLC_MISSES] && event_seen[HW_INSTRUCTIONS] && v[HW_INSTRUCTIONS] > 0) {
+        m.mpki = 1e3 * (double)v[HW_LLC_MISSES] / (double)v[HW_INSTRUCTIONS];
+        m.bound = m.mpki >= MEMORY_BOUND_MPKI ? "memoire" : "calcul";
+    }
+    if (event_seen[HW_LLC_MISSES] && r->counted_arcs > 0.0) {
+        m.bytes_per_arc = (double)v[HW_LLC_MISSES] * CACHE_LINE_BYTES / r->counted_arcs;
+    }
+    return m;
+}
+
+static void print_metric(FILE *out, double x, int width, int precision)
+{
+    if (x < 0.0) fprintf(out, " %*s", width, "-");
+    else fprintf(out, " %*.*f", width, precision, x);
+}
+
+static void json_metric(FILE *out, const char *key, double x)
+{
+    if (x < 0.0) fprintf(out, ",\"%s\":null", key);
+    else fprintf(out, ",\"%s\":%.4f", key, x);
+}
+
+void hwCountersReport(FILE *out, int json)
+{
+    static const char *EVENT_KEYS[HW_NB_EVENTS] = {"cycles", "instructions", "llc_misses", "branch_misses"};
+    pthread_mutex_lock(&hw_lock);
+    if (json) {
+        fprintf(out, "{\"counters\":%s", unavailable_reason[0] && !event_seen[HW_CYCLES] ? "false" : "true");
+        if (unavailable_reason[0]) fprintf(out, ",\"reason\":\"%s\"", unavailable_reason);
+        fprintf(out, ",\"kernels\":[");
+        int first = 1;
+        for (int k = 0; k < NB_KERNELS; ++k) {
+            const t_kernel_record *r = &kernel_records[k];
+            if (!r->calls) continue;
+            t_kernel_metrics m = kernel_metrics(r);
+            fprintf(out, "%s{\"name\":\"%s\",\"calls\":%ld,\"wall_ms\":%.3f",
+                    first ? "" : ",", KERNEL_NAMES[k], r->calls, r->wall * 1e3);
+            for (int e = 0; e < HW_NB_EVENTS; ++e) {
+                if (r->counted_calls && event_seen[e]) {
+                    fprintf(out, ",\"%s\":%llu", EVENT_KEYS[e], (unsigned long long)r->values[e]);
+                }
+            }
+            json_metric(out, "ipc", m.ipc);
+            json_metric(out, "gflops", m.gflops);
+            json_metric(out, "llc_mpki", m.mpki);
+            json_metric(out, "bytes_per_arc", m.bytes_per_arc);
+            fprintf(out, ",\"bound\":\"%s\"}", m.bound);
+            first = 0;
+        }
+        fprintf(out, "]}\n");
+        pthread_mutex_unlock(&hw_lock);
+        return;
+    }
+
+    fprintf(out, "\nCompteurs materiels par noyau");
+    if (unavailable_reason[0]) fprintf(out, " (indisponibles : %s ; temps et debits seuls)", unavailable_reason);
+    fprintf(out, "\n%-22s %7s %10s %14s %14s %12s %12s %6s %8s %8s %10s %8s\n", "Noyau", "appels",
+            "mur (ms)", "cycles", "instructions", "defauts LLC", "err. branch", "IPC", "GFLOP/s",
+            "LLC/kins", "octets/arc", "limite");
+    for (int k = 0; k < NB_KERNELS; ++k) {
+        const t_kernel_record *r = &kernel_records[k];
+        if (!r->calls) continue;
+        t_kernel_metrics m = kernel_metrics(r);
+        fprintf(out, "%-22s %7ld %10.3f", KERNEL_NAMES[k], r->calls, r->wall * 1e3);
+        static const int widths[HW_NB_EVENTS] = {14, 14, 12, 12};
+        for (int e = 0; e < HW_NB_EVENTS; ++e) {
+            if (r->counted_calls && event_seen[e]) {
+                fprintf(out, " %*llu", widths[e], (unsigned long long)r->values[e]);
+            } else {
+                fprintf(out, " %*s", widths[e], "-");
+            }
+        }
+        print_metric(out, m.ipc, 6, 2);
+        print_metric(out, m.gflops, 8, 3);
+        print_metric(out, m.mpki, 8, 2);
+        print_metric(out, m.bytes_per_arc, 10, 2);
+        fprintf(out, " %8s\n", m.bound);
+    }
+    pthread_mutex_unlock(&hw_lock);
+}
@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "instrument.h"
+
+/**
+ * @brief Mesures cumulées d'une étape.
+ */
+typedef struct {
+    char name[PROBE_NAME_MAX];
+    long calls;
+    double wall;
+    double cpu;
+    unsigned long long allocs;
+    unsigned long long bytes;
+    long rss_delta_kb;          /**< Somme des variations de mémoire résidente. */
+    long peak_rss_kb;           /**< Pic du processus (ru_maxrss) à la fin de l'étape. */
+} t_stage_record;
+
+static int instrument_on = 0;
+
+static pthread_mutex_t records_lock = PTHREAD_MUTEX_INITIALIZER;
+static t_stage_record *records = NULL;
+static int nb_records = 0;
+static int records_capacity = 0;
+
+/* Compteurs d'allocations : globaux (atomiques) et par thread. */
+static unsigned long long total_allocs = 0;
+static unsigned long long total_bytes = 0;
+static __thread unsigned long long thread_allocs = 0;
+static __thread unsigned long long thread_bytes = 0;
+
+/* Vaut 1 dès que les allocations passent par instrumentCountAllocation. */
+static int allocations_wrapped = 0;
+
+void instrumentCountAllocation(size_t bytes)
+{
+    if (!__atomic_load_n(&allocations_wrapped, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&allocations_wrapped, 1, __ATOMIC_RELAXED);
+    }
+    if (!instrument_on) return;
+    __atomic_fetch_add(&total_allocs, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&total_bytes, (unsigned long long)bytes, __ATOMIC_RELAXED);
+    thread_allocs++;
+    thread_bytes += bytes;
+}
+
+void instrumentEnable(void)
+{
+    instrument_on = 1;
+}
+
+int instrumentEnabled(void)
+{
+    return instrument_on;
+}
+
+static double clock_seconds(clockid_t id)
+{
+    struct timespec t;
+    clock_gettime(id, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/* Mémoire résidente actuelle (2e champ de /proc/self/statm), 0 si indisponible.
+ * Lue par open/read : stdio allouerait un tampon compté dans l'étape. */
+static long current_rss_kb(void)
+{
+    char buf[128];
+    int fd = open("/proc/self/statm", O_RDONLY);
+    if (fd < 0) return 0;
+    ssize_t len = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (len <= 0) return 0;
+    buf[len] = '\0';
+    long size, resident;
+    if (sscanf(buf, "%ld %ld", &size, &resident) != 2) return 0;
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static void probe_start(t_probe *p, const char *name, const char *detail, int thread_scope)
+{
+    p->active = instrument_on;
+    if (!p->active) return;
+    if (detail) snprintf(p->name, sizeof(p->name), "%s %s", name, detail);
+    else snprintf(p->name, sizeof(p->name), "%s", name);
+    p->thread_scope = thread_scope;
+    p->rss_kb = current_rss_kb();
+    p->wall = clock_seconds(CLOCK_MONOTONIC);
+    if (thread_scope) {
+        p->cpu = clock_seconds(CLOCK_THREAD_CPUTIME_ID);
+        p->allocs = thread_allocs;
+        p->bytes = thread_bytes;
+    } else {
+        p->cpu = clock_seconds(CLOCK_PROCESS_CPUTIME_ID);
+        p->allocs = __atomic_load_n(&total_allocs, __ATOMIC_RELAXED);
+        p->bytes = __atomic_load_n(&total_bytes, __ATOMIC_RELAXED);
+    }
+}
+
+void probeBegin(t_probe *p, const char *name)
+{
+    probe_start(p, name, NULL, 0);
+}
+
+void probeBeginThread(t_probe *p, const char *name, const char *detail)
+{
+    probe_start(p, name, detail, 1);
+}
+
+/* Appelée sous records_lock. */
+static t_stage_record *find_record(const char *name)
+{
+    for (int i = 0; i < nb_records; ++i) {
+        if (strcmp(records[i].name, name) == 0) return &records[i];
+    }
+    if (nb_records == records_capacity) {
+        records_capacity = records_capacity ? 2 * records_capacity : 32;
+        t_stage_record *grown = realloc(records, (size_t)records_capacity * sizeof(t_stage_record));
+        if (!grown) {
+            perror("realloc stage records");
+            exit(EXIT_FAILURE);
+        }
+        records = grown;
+    }
+    t_stage_record *r = &records[nb_records++];
+    memset(r, 0, sizeof(*r));
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    return r;
+}
+
+void probeEnd(t_probe *p)
+{
+    if (!p->active) return;
+    double wall = clock_seconds(CLOCK_MONOTONIC) - p->wall;
+    double cpu;
+    unsigned long long allocs, bytes;
+    if (p->thread_scope) {
+        cpu = clock_seconds(CLOCK_THREAD_CPUTIME_ID) - p->cpu;
+        allocs = thread_allocs - p->allocs;
+        bytes = thread_bytes - p->bytes;
+    } else {
+        cpu = clock_seconds(CLOCK_PROCESS_CPUTIME_ID) - p->cpu;
+        allocs = __atomic_load_n(&total_allocs, __ATOMIC_RELAXED) - p->allocs;
+        bytes = __atomic_load_n(&total_bytes, __ATOMIC_RELAXED) - p->bytes;
+    }
+    long rss_delta = current_rss_kb() - p->rss_kb;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    pthread_mutex_lock(&records_lock);
+    t_stage_record *r = find_record(p->name);
+    r->calls++;
+    r->wall += wall;
+    r->cpu += cpu;
+    r->allocs += allocs;
+    r->bytes += bytes;
+    r->rss_delta_kb += rss_delta;
+    if (usage.ru_maxrss > r->peak_rss_kb) r->peak_rss_kb = usage.ru_maxrss;
+    pthread_mutex_unlock(&records_lock);
+}
+
+void instrumentReport(FILE *out, int json)
+{
+    int counted = __atomic_load_n(&allocations_wrapped, __ATOMIC_RELAXED);
+    pthread_mutex_lock(&records_lock);
+    if (json) {
+        fprintf(out, "{\"stages\":[");
+        for (int i = 0; i < nb_records; ++i) {
+            const t_stage_record *r = &records[i];
+            fprintf(out, "%s{\"name\":\"%s\",\"calls\":%ld,\"wall_ms\":%.3f,\"cpu_ms\":%.3f,",
+                    i ? "," : "", r->name, r->calls, r->wall * 1e3, r->cpu * 1e3);
+            if (counted) fprintf(out, "\"allocs\":%llu,\"bytes\":%llu,", r->allocs, r->bytes);
+            fprintf(out, "\"rss_delta_kb\":%ld,\"peak_rss_kb\":%ld}", r->rss_delta_kb, r->peak_rss_kb);
+        }
+        fprintf(out, "]}\n");
+    } else {
+        fprintf(out, "\n%-28s %7s %11s %11s %12s %14s %12s %12s\n", "Etape", "appels", "mur (ms)",
+                "cpu (ms)", "allocations", "octets", "RSS +/- (Ko)", "RSS max (Ko)");
+        for (int i = 0; i < nb_records; ++i) {
+            const t_stage_record *r = &records[i];
+            fprintf(out, "%-28s %7ld %11.3f %11.3f ", r->name, r->calls, r->wall * 1e3, r->cpu * 1e3);
+            if (counted) fprintf(out, "%12llu %14llu", r->allocs, r->bytes);
+            else fprintf(out, "%12s %14s", "-", "-");
+            fprintf(out, " %12ld %12ld\n", r->rss_delta_kb, r->peak_rss_kb);
+        }
+    }
+    pthread_mutex_unlock(&records_lock);
+}
@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kstep.h"
+#include "threadpool.h"
+#include "utils.h"
+
+#define COLUMNS_PER_TASK 1024
+
+typedef struct {
+    const float *X;
+    int batch;
+    const t_csr_matrix *AT;
+    float *Y;
+    int begin;
+    int end;
+} t_spmm_job;
+
+static int compare_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* Horizons triés sans doublon ni valeur négative ; renvoie leur nombre. */
+static int normalize_horizons(const int *horizons, int nb_horizons, int *out)
+{
+    int m = 0;
+    for (int h = 0; h < nb_horizons; ++h) {
+        if (horizons[h] >= 0) out[m++] = horizons[h];
+    }
+    qsort(out, (size_t)m, sizeof(int), compare_int);
+    int w = 0;
+    for (int h = 0; h < m; ++h) {
+        if (w == 0 || out[w - 1] != out[h]) out[w++] = out[h];
+    }
+    return w;
+}
+
+/* Bloc de count floats nuls ; count = n * batch dépasse souvent INT_MAX. */
+static float *calloc_block(size_t count)
+{
+    float *block = calloc(count > 0 ? count : 1, sizeof(float));
+    if (!block) {
+        perror("calloc kstep block");
+        exit(EXIT_FAILURE);
+    }
+    return block;
+}
+
+static void spmm_task(void *arg)
+{
+    t_spmm_job *job = arg;
+    csrBlockMultiply(job->X, job->batch, job->AT, job->Y, job->begin, job->end);
+}
+
+/* Passage de la disposition état par état (X[i * batch + b]) aux lignes. */
+static void emit(const float *X, int batch, int n, float *rows, int k,
+                 t_kstep_callback callback, void *user)
+{
+    for (int i = 0; i < n; ++i) {
+        for (int b = 0; b < batch; ++b) {
+            rows[(size_t)b * (size_t)n + i] = X[(size_t)i * (size_t)batch + b];
+        }
+    }
+    callback(k, rows, batch, n, user);
+}
+
+void batchDistributionsStream(const t_csr_matrix *P, const float *initial, int batch,
+                              const int *horizons, int nb_horizons, int nb_threads,
+                              t_kstep_callback callback, void *user)
+{
+    int n = P->n;
+    if (n == 0 || batch <= 0 || nb_horizons <= 0) return;
+
+    int *ks = calloc_int_array(nb_horizons);
+    int nb_ks = normalize_horizons(horizons, nb_horizons, ks);
+
+    size_t block = (size_t)n * (size_t)batch;
+    float *X = calloc_block(block);
+    float *Y = calloc_block(block);
+    float *rows = calloc_block(block);
+    for (int b = 0; b < batch; ++b) {
+        for (int i = 0; i < n; ++i) {
+            X[(size_t)i * (size_t)batch + b] = initial[(size_t)b * (size_t)n + i];
+        }
+    }
+
+    t_csr_matrix AT = csrTranspose(P);
+    int nb_jobs = (n + COLUMNS_PER_TASK - 1) / COLUMNS_PER_TASK;
+    t_spmm_job *jobs = calloc((size_t)nb_jobs, sizeof(t_spmm_job));
+    if (!jobs) {
+        perror("calloc spmm jobs");
+        exit(EXIT_FAILURE);
+    }
+    t_thread_pool *pool = nb_jobs > 1 && nb_threads != 1 ? pool_create(nb_threads) : NULL;
+
+    int next = 0;
+    for (int k = 0; next < nb_ks; ++k) {
+        if (k > 0) {
+            t_task_group group = {0};
+            for (int j = 0; j < nb_jobs; ++j) {
+                jobs[j].X = X;
+                jobs[j].batch = batch;
+                jobs[j].AT = &AT;
+                jobs[j].Y = Y;
+                jobs[j].begin = j * COLUMNS_PER_TASK;
+                jobs[j].end = (j + 1) * COLUMNS_PER_TASK < n ? (j + 1) * COLUMNS_PER_TASK : n;
+                if (pool) pool_submit(pool, spmm_task, &jobs[j], &group);
+                else spmm_task(&jobs[j]);
+            }
+            if (pool) pool_wait(pool, &group);
+            float *t = X;
+            X = Y;
+            Y = t;
+        }
+        if (ks[next] == k) {
+            emit(X, batch, n, rows, k, callback, user);
+            next++;
+        }
+    }
+
+    if (pool) pool_destroy(pool);
+    free(jobs);
+    freeCsr(&AT);
+    free(rows);
+    free(Y);
+    free(X);
+    free(ks);
+}
+
+static void store_callback(int k, const float *block, int batch, int n, void *user)
+{
+    t_kstep_result *res = user;
+    for (int h = 0; h < res->nb_horizons; ++h) {
+        if (res->horizons[h] != k) continue;
+        memcpy(res->distributions[h], block, sizeof(float) * (size_t)batch * (size_t)n);
+        return;
+    }
+}
+
+t_kstep_result batchDistributions(const t_csr_matrix *P, const float *initial, int batch,
+                                  const int *horizons, int nb_horizons, int nb_threads)
+{
+    t_kstep_result res;
+    res.n = P->n;
+    res.batch = batch;
+    res.horizons = calloc_int_array(nb_horizons > 0 ? nb_horizons : 1);
+    res.nb_horizons = normalize_horizons(horizons, nb_horizons, res.horizons);
+    res.distributions = malloc(sizeof(float *) * (size_t)(res.nb_horizons > 0 ? res.nb_horizons : 1));
+    if (!res.distributions) {
+        perror("malloc kstep distributions");
+        exit(EXIT_FAILURE);
+    }
+    for (int h = 0; h < res.nb_horizons; ++h) {
+        res.distributions[h] = calloc_block((size_t)batch * (size_t)P->n);
+    }
+
+    batchDistributionsStream(P, initial, batch, res.horizons, res.nb_horizons, nb_threads,
+                             store_callback, &res);
+    return res;
+}
+
+void freeKStepResult(t_kstep_result *res)
+{
+    if (!res || !res->distributions) return;
+    for (int h = 0; h < res->nb_horizons; ++h) {
+        free(res->distributions[h]);
+    }
+    free(res->distributions);
+    free(res->horizons);
+    res->distributions = NULL;
+    res->horizons = NULL;
+    res->nb_horizons = 0;
+}
@@ -0,0 +1,440 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lumping.h"
+#include "period.h"
+#include "hasse.h"
+#include "sparse.h"
+#include "utils.h"
+
+/* Etat de l'algorithme de raffinement. Les blocs occupent des plages
+ * contiguës [first[b], end[b]) du tableau elems. */
+typedef struct {
+    int n;
+    int nb;             /* Nombre de blocs courant. */
+    int *elems;
+    int *loc;           /* Position de chaque sommet dans elems. */
+    int *blk;           /* Bloc de chaque sommet. */
+    int *first;
+    int *end;
+    int *work;          /* Pile des blocs séparateurs à traiter. */
+    int nb_work;
+    int *in_work;
+} t_refiner;
+
+typedef struct {
+    int v;
+    int block;
+    double w;
+} t_weighted;
+
+static int compare_weighted(const void *a, const void *b)
+{
+    const t_weighted *x = a;
+    const t_weighted *y = b;
+    if (x->block != y->block) return x->block < y->block ? -1 : 1;
+    if (x->w != y->w) return x->w < y->w ? -1 : 1;
+    return x->v - y->v;
+}
+
+typedef struct {
+    int v;
+    int cls;
+    int phase;
+} t_initial_key;
+
+static int compare_initial(const void *a, const void *b)
+{
+    const t_initial_key *x = a;
+    const t_initial_key *y = b;
+    if (x->cls != y->cls) return x->cls - y->cls;
+    if (x->phase != y->phase) return x->phase - y->phase;
+    return x->v - y->v;
+}
+
+static void push_work(t_refiner *R, int b)
+{
+    if (R->in_work[b]) return;
+    R->in_work[b] = 1;
+    R->work[R->nb_work++] = b;
+}
+
+/* Découpe le bloc b selon group[] (0..nb_groups-1) de ses sommets ; le plus
+ * grand morceau garde l'identifiant b, les autres sont mis en file. */
+static void split_block(t_refiner *R, int b, const int *group, int nb_groups, int *count, int *buffer)
+{
+    int lo = R->first[b], hi = R->end[b];
+    for (int g = 0; g < nb_groups; ++g) {
+        count[g] = 0;
+    }
+    for (int i = lo; i < hi; ++i) {
+        count[group[R->elems[i]]]++;
+    }
+    int largest = 0;
+    for (int g = 1; g < nb_groups; ++g) {
+        if (count[g] > count[largest]) largest = g;
+    }
+
+    /* count[] devient la position de départ de chaque groupe. */
+    int pos = lo;
+    for (int g = 0; g < nb_groups; ++g) {
+        int c = count[g];
+        count[g] = pos;
+        pos += c;
+    }
+    for (int i = lo; i < hi; ++i) {
+        int v = R->elems[i];
+        buffer[count[group[v]]++ - lo] = v;
+    }
+    for (int i = lo; i < hi; ++i) {
+        R->elems[i] = buffer[i - lo];
+        R->loc[R->elems[i]] = i;
+    }
+
+    /* Après le placement, count[g] est la fin du groupe g. */
+    int start = lo;
+    for (int g = 0; g < nb_groups; ++g) {
+        int stop = count[g];
+        if (stop > start) {
+            int id = b;
+            if (g != largest) {
+                id = R->nb++;
+                R->in_work[id] = 0;
+            }
+            R->first[id] = start;
+            R->end[id] = stop;
+            for (int i = start; i < stop; ++i) {
+                R->blk[R->elems[i]] = id;
+            }
+            if (g != largest) push_work(R, id);
+        }
+        start = stop;
+    }
+}
+
+t_lumping computeLumping(const t_graph *g, const t_partition *part, const t_link_array *links,
+                         float tol)
+{
+    int n = g->nb_vertices;
+    int cap = n > 0 ? n : 1;
+    t_refiner R;
+    R.n = n;
+    R.nb = 0;
+    R.elems = calloc_int_array(cap);
+    R.loc = calloc_int_array(cap);
+    R.blk = calloc_int_array(cap);
+    R.first = calloc_int_array(cap);
+    R.end = calloc_int_array(cap);
+    R.work = calloc_int_array(cap);
+    R.in_work = calloc_int_array(cap);
+    R.nb_work = 0;
+
+    /* Partition initiale : un bloc pour tous les états transitoires, puis un
+     * bloc par (classe persistante, sous-classe cyclique). Les classes
+     * persistantes et leurs périodes sont ainsi conservées dans le quotient. */
+    t_initial_key *keys = malloc(sizeof(t_initial_key) * (size_t)cap);
+    if (!keys) {
+        perror("malloc lumping keys");
+        exit(EXIT_FAILURE);
+    }
+    int *vertex_to_class = buildVertexToClass(part, n);
+    int *phase = calloc_int_array(cap);
+    int *transient = buildTransientFlags(part, links);
+    for (int ci = 0; ci < part->size; ++ci) {
+        const t_class *c = &part->classes[ci];
+        if (!transient[ci]) getClassPeriod(g, part, vertex_to_class, ci, phase);
+        for (int i = 0; i < c->size; ++i) {
+            int v = c->vertices[i] - 1;
+            keys[v].v = v;
+            keys[v].cls = transient[ci] ? -1 : ci;
+            keys[v].phase = transient[ci] ? 0 : phase[i];
+        }
+    }
+    free(transient);
+    qsort(keys, (size_t)n, sizeof(t_initial_key), compare_initial);
+    for (int i = 0; i < n; ++i) {
+        if (i == 0 || keys[i].cls != keys[i - 1].cls || keys[i].phase != keys[i - 1].phase) {
+            R.first[R.nb] = i;
+            R.nb++;
+        }
+        R.elems[i] = keys[i].v;
+        R.loc[keys[i].v] = i;
+        R.blk[keys[i].v] = R.nb - 1;
+        R.end[R.nb - 1] = i + 1;
+    }
+    for (int b = 0; b < R.nb; ++b) {
+        push_work(&R, b);
+    }
+    free(keys);
+    free(phase);
+    free(vertex_to_class);
+
+    /* Arcs entrants : la transposée donne, pour chaque t, les (s, P(s,t)). */
+    t_csr_matrix P = csrFromGraph(g);
+    t_csr_matrix PT = csrTranspose(&P);
+    freeCsr(&P);
+
+    double *weight = malloc(sizeof(double) * (size_t)cap);
+    t_weighted *touched = malloc(sizeof(t_weighted) * (size_t)cap);
+    if (!weight || !touched) {
+        perror("malloc lumping weights");
+        exit(EXIT_FAILURE);
+    }
+    int *is_touched = calloc_int_array(cap);
+    int *group = calloc_int_array(cap);
+    int *splitter = calloc_int_array(cap);
+    int *count = calloc_int_array(cap + 1);
+    int *buffer = calloc_int_array(cap);
+
+    while (R.nb_work > 0) {
+        int S = R.work[--R.nb_work];
+        R.in_work[S] = 0;
+
+        /* Copie du séparateur : il peut lui-même être découpé. */
+        int ns = R.end[S] - R.first[S];
+        memcpy(splitter, R.elems + R.first[S], sizeof(int) * (size_t)ns);
+
+        int nt = 0;
+        for (int i = 0; i < ns; ++i) {
+            int t = splitter[i];
+            for (int k = PT.row_ptr[t]; k < PT.row_ptr[t + 1]; ++k) {
+                int s = PT.col_idx[k];
+                if (!is_touched[s]) {
+                    is_touched[s] = 1;
+                    weight[s] = 0.0;
+                    touched[nt++].v = s;
+                }
+                weight[s] += PT.values[k];
+            }
+        }
+        for (int i = 0; i < nt; ++i) {
+            touched[i].block = R.blk[touched[i].v];
+            touched[i].w = weight[touched[i].v];
+        }
+        qsort(touched, (size_t)nt, sizeof(t_weighted), compare_weighted);
+
+        for (int lo = 0; lo < nt;) {
+            int b = touched[lo].block;
+            int hi = lo;
+            while (hi < nt && touched[hi].block == b) ++hi;
+
+            /* Groupe 0 : poids nul (états non touchés compris), puis un groupe
+             * par valeur de poids, à tol près du premier poids du groupe. */
+            int size = R.end[b] - R.first[b];
+            int nb_groups = 1;
+            int has_zero = hi - lo < size;
+            double start_w = 0.0;
+            for (int i = lo; i < hi; ++i) {
+                if (touched[i].w <= tol) {
+                    group[touched[i].v] = 0;
+                    has_zero = 1;
+                    continue;
+                }
+                if (nb_groups == 1 || touched[i].w - start_w > tol) {
+                    start_w = touched[i].w;
+                    nb_groups++;
+                }
+                group[touched[i].v] = nb_groups - 1;
+            }
+            int distinct = nb_groups - 1 + has_zero;
+            if (distinct > 1) {
+                split_block(&R, b, group, nb_groups, count, buffer);
+            }
+            for (int i = lo; i < hi; ++i) {
+                group[touched[i].v] = 0;
+            }
+            lo = hi;
+        }
+        for (int i = 0; i < nt; ++i) {
+            is_touched[touched[i].v] = 0;
+        }
+    }
+
+    freeCsr(&PT);
+    free(weight);
+    free(touched);
+    free(is_touched);
+    free(group);
+    free(splitter);
+    free(count);
+    free(buffer);
+
+    /* Renumérotation des blocs par plus petit état. */
+    t_lumping L;
+    L.nb_vertices = n;
+    L.nb_blocks = 0;
+    L.block_of = calloc_int_array(cap);
+    L.block_start = calloc_int_array(R.nb + 1);
+    L.members = calloc_int_array(cap);
+    int *renum = R.first;   /* réutilisé : plus nécessaire */
+    for (int b = 0; b < R.nb; ++b) {
+        renum[b] = 0;
+    }
+    for (int v = 0; v < n; ++v) {
+        int b = R.blk[v];
+        if (!renum[b]) renum[b] = ++L.nb_blocks;
+        L.block_of[v] = renum[b];
+        L.block_start[renum[b]]++;
+    }
+    for (int b = 0; b < L.nb_blocks; ++b) {
+        L.block_start[b + 1] += L.block_start[b];
+    }
+    int *fill = R.end;
+    for (int b = 0; b < L.nb_blocks; ++b) {
+        fill[b] = L.block_start[b];
+    }
+    for (int v = 0; v < n; ++v) {
+        L.members[fill[L.block_of[v] - 1]++] = v + 1;
+    }
+
+    free(R.elems);
+    free(R.loc);
+    free(R.blk);
+    free(R.first);
+    free(R.end);
+    free(R.work);
+    free(R.in_work);
+    return L;
+}
+
+static int compare_int_desc(const void *a, const void *b)
+{
+    return *(const int *)b - *(const int *)a;
+}
+
+t_graph *buildQuotientGraph(const t_graph *g, const t_lumping *L)
+{
+    int nb = L->nb_blocks;
+    t_graph *q = createGraph(nb);
+    double *acc = malloc(sizeof(double) * (size_t)(nb > 0 ? nb : 1));
+    if (!acc) {
+        perror("malloc quotient row");
+        exit(EXIT_FAILURE);
+    }
+    int *seen = calloc_int_array(nb > 0 ? nb : 1);
+    int *cols = calloc_int_array(nb > 0 ? nb : 1);
+
+    for (int b = 0; b < nb; ++b) {
+        int nc = 0;
+        int size = L->block_start[b + 1] - L->block_start[b];
+        for (int i = L->block_start[b]; i < L->block_start[b + 1]; ++i) {
+            int v = L->members[i] - 1;
+            for (t_arc *cur = g->array[v].head; cur; cur = cur->next) {
+                int c = L->block_of[cur->dest - 1] - 1;
+                if (!seen[c]) {
+                    seen[c] = 1;
+                    acc[c] = 0.0;
+                    cols[nc++] = c;
+                }
+                acc[c] += cur->proba;
+            }
+        }
+        /* Insertion en tête : ordre décroissant pour des listes croissantes. */
+        qsort(cols, (size_t)nc, sizeof(int), compare_int_desc);
+        for (int k = 0; k < nc; ++k) {
+            int c = cols[k];
+            addArc(q, b + 1, c + 1, (float)(acc[c] / size));
+            seen[c] = 0;
+        }
+    }
+
+    free(acc);
+    free(seen);
+    free(cols);
+    return q;
+}
+
+int *mapQuotientClasses(const t_lumping *L, t_partition *qpart, const t_partition *part,
+                        const t_link_array *links)
+{
+    int *vertex_to_class = buildVertexToClass(part, L->nb_vertices);
+    int *map = calloc_int_array(qpart->size > 0 ? qpart->size : 1);
+    int *transient = buildTransientFlags(part, links);
+    int nb_transient = 0;
+    for (int qc = 0; qc < qpart->size; ++qc) {
+        int block = qpart->classes[qc].vertices[0];
+        int v = L->members[L->block_start[block - 1]];
+        int ci = vertex_to_class[v - 1];
+        if (transient[ci]) {
+            map[qc] = -1;
+            snprintf(qpart->classes[qc].name, sizeof(qpart->classes[qc].name), "T%d", ++nb_transient);
+        } else {
+            map[qc] = ci;
+            strcpy(qpart->classes[qc].name, part->classes[ci].name);
+        }
+    }
+    free(transient);
+    free(vertex_to_class);
+    return map;
+}
+
+t_absorption expandAbsorption(const t_absorption *q, const t_lumping *L, const int *class_map)
+{
+    int *source = calloc_int_array(L->nb_vertices > 0 ? L->nb_vertices : 1);
+    for (int v = 0; v < L->nb_vertices; ++v) {
+        source[v] = L->block_of[v] - 1;
+    }
+    t_absorption abs = remapAbsorption(q, L->nb_vertices, source);
+    for (int p = 0; p < abs.nb_persistent; ++p) {
+        abs.persistent_classes[p] = class_map[q->persistent_classes[p]];
+    }
+    free(source);
+    return abs;
+}
+
+t_partition expandQuotientClasses(const t_partition *qpart, const t_lumping *L,
+                                  const t_partition *part)
+{
+    /* Classe du quotient de chaque bloc. */
+    int *block_class = calloc_int_array(L->nb_blocks > 0 ? L->nb_blocks : 1);
+    for (int qc = 0; qc < qpart->size; ++qc) {
+        for (int i = 0; i < qpart->classes[qc].size; ++i) {
+            block_class[qpart->classes[qc].vertices[i] - 1] = qc;
+        }
+    }
+
+    t_partition epart;
+    epart.size = qpart->size;
+    epart.capacity = qpart->size > 0 ? qpart->size : 1;
+    epart.classes = malloc(sizeof(t_class) * (size_t)epart.capacity);
+    if (!epart.classes) {
+        perror("malloc quotient classes");
+        exit(EXIT_FAILURE);
+    }
+    for (int qc = 0; qc < qpart->size; ++qc) {
+        t_class *c = &epart.classes[qc];
+        memcpy(c->name, qpart->classes[qc].name, sizeof(c->name));
+        c->size = 0;
+        for (int i = 0; i < qpart->classes[qc].size; ++i) {
+            int b = qpart->classes[qc].vertices[i] - 1;
+            c->size += L->block_start[b + 1] - L->block_start[b];
+        }
+        c->capacity = c->size > 0 ? c->size : 1;
+        c->vertices = calloc_int_array(c->capacity);
+        c->size = 0;
+    }
+
+    /* Parcours de la partition d'origine : les états gardent l'ordre de la partie 2. */
+    for (int ci = 0; ci < part->size; ++ci) {
+        const t_class *orig = &part->classes[ci];
+        for (int i = 0; i < orig->size; ++i) {
+            int v = orig->vertices[i];
+            t_class *c = &epart.classes[block_class[L->block_of[v - 1] - 1]];
+            c->vertices[c->size++] = v;
+        }
+    }
+    free(block_class);
+    return epart;
+}
+
+void freeLumping(t_lumping *L)
+{
+    if (!L) return;
+    free(L->block_of);
+    free(L->block_start);
+    free(L->members);
+    L->block_of = NULL;
+    L->block_start = NULL;
+    L->members = NULL;
+    L->nb_vertices = L->nb_blocks = 0;
+}
@@ -1,82 +1,43 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
-#include "graph.h"
-#include "tarjan.h"
-#include "hasse.h"
-#include "matrix.h"
+#include "options.h"
+#include "writer.h"
+#include "analysis.h"
+#include "batch.h"
+#include "server.h"
+#include "instrument.h"
+#include "hwcounters.h"
 
 int main(int argc, char **argv)
 {
-    const char *filename = argv[1];
-    t_graph *g = readGraph(filename);
-
-    printf("=== PARTIE 1 : GRAPHE / MARKOV / MERMAID ===\n");
-    printAdjList(g);
-    checkMarkov(g, 0.01f);
-    exportMermaidGraph(g, "graph_mermaid.mmd");
-    printf("pour visualiser graphe : graph_mermaid.mmd\n");
-
-    printf("\n=== PARTIE 2 : TARJAN / PARTITION / HASSE ===\n");
-    t_partition part = tarjanPartition(g);
-    printPartition(&part);
-
-    t_link_array links;
-    init_link_array(&links);
-    build_class_links(g, &part, &links);
-    removeTransitiveLinks(&links);
-    export_mermaid_hasse(&part, &links, "hasse_mermaid.mmd");
-    printf("Pour visualiser diagramme de Hasse : hasse_mermaid.mmd\n");
-
-    classify_graph(g, &part, &links);
-
-    printf("\n=== PARTIE 3 : MATRICES / DISTRIBUTIONS / PERIODE ===\n");
-
-    t_matrix M = createMatrixFromGraph(g);
-    printMatrix(&M, "M");
-
-    t_matrix M3 = matrixPower(&M, 3);
-    printMatrix(&M3, "M^3");
-
-    t_matrix M7 = matrixPower(&M, 7);
-    printMatrix(&M7, "M^7");
-
-    int power_limit = 0;
-    t_matrix Mlim = iterateUntilStationary(&M, 0.01f, 50, &power_limit);
-    printf("\nPuissance n telle que diff(M^n, M^(n-1)) < 0.01 : n = %d\n", power_limit);
-    printMatrix(&Mlim, "M^n (limite approx)");
-
-    printf("\nDistributions stationnaires par classe (approx) :\n");
-    for (int ci = 0; ci < part.size; ++ci) {
-        t_matrix sub = subMatrix(M, part, ci);
-        if (sub.rows == 0) continue;
-        int kclass = 0;
-        t_matrix sub_lim = iterateUntilStationary(&sub, 0.01f, 50, &kclass);
-        printf("\nClasse %s (puissance n=%d): distribution stationnaire approx (ligne 1):\n",
-               part.classes[ci].name, kclass);
-        for (int j = 0; j < sub_lim.cols; ++j) {
-            printf("  p[%d] = %.4f\n", j + 1, sub_lim.data[0][j]);
-        }
-        freeMatrix(&sub_lim);
-        freeMatrix(&sub);
+    t_options opt;
+    if (!parseOptions(argc, argv, &opt)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
     }
-
-    printf("\nPeriode de chaque classe :\n");
-    for (int ci = 0; ci < part.size; ++ci) {
-        t_matrix sub = subMatrix(M, part, ci);
-        if (sub.rows == 0) continue;
-        int period = getPeriod(sub);
-        printf("  Classe %s : periode = %d\n", part.classes[ci].name, period);
-        freeMatrix(&sub);
+    if (opt.output && !freopen(opt.output, "w", stdout)) {
+        perror("open output file");
+        return EXIT_FAILURE;
     }
 
-    freeMatrix(&M);
-    freeMatrix(&M3);
-    freeMatrix(&M7);
-    freeMatrix(&Mlim);
-    free_link_array(&links);
-    freePartition(&part);
-    freeGraph(g);
+    if (opt.stats) instrumentEnable();
+    if (opt.counters) hwCountersEnable();
+
+    int ok;
+    if (opt.serve) {
+        ok = runServer(&opt) == 0;
+    } else if (opt.batch) {
+        ok = runBatch(&opt) == 0;
+    } else {
+        t_analysis_env env = {"graph_mermaid.mmd", "hasse_mermaid.mmd", 0};
+        t_markov_context *ctx = markovCreate();
+        t_writer *w = createWriter(stdout, opt.format, &opt.print);
+        ok = analyzeFile(ctx, opt.filename, &opt, &env, w, NULL);
+        freeWriter(w);
+        markovFree(ctx);
+    }
 
-    return EXIT_SUCCESS;
+    if (opt.stats) instrumentReport(stderr, opt.stats == 2);
+    if (opt.counters) hwCountersReport(stderr, opt.counters == 2);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,320 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "markov.h"
+#include "period.h"
+#include "powercache.h"
+#include "ctmc.h"
+#include "instrument.h"
+
+struct s_markov_context {
+    t_graph *g;
+    int ready;                  /**< Résultats calculés (combinaison de t_markov_result). */
+    t_partition part;
+    t_link_array links;
+    t_class_kind *kinds;
+    int *periods;
+    float **stationary;
+    t_absorption abs;
+    t_matrix M;
+    t_csr_matrix P;
+    t_power_cache powers;
+    int powers_ready;
+    size_t power_cache_bytes;   /**< Plafond du cache de puissances (0 : aucun). */
+    /* Tampons conservés d'une chaîne à l'autre. */
+    int *vertex_class;
+    int *index_in_class;        /**< Rang de chaque sommet dans sa classe. */
+    int vertex_capacity;
+    double *x;
+    double *y;
+    int vector_capacity;
+};
+
+t_markov_context *markovCreate(void)
+{
+    t_markov_context *ctx = calloc(1, sizeof(t_markov_context));
+    if (!ctx) {
+        perror("calloc markov context");
+        exit(EXIT_FAILURE);
+    }
+    return ctx;
+}
+
+void markovClear(t_markov_context *ctx)
+{
+    if (ctx->stationary) {
+        for (int ci = 0; ci < ctx->part.size; ++ci) {
+            free(ctx->stationary[ci]);
+        }
+        free(ctx->stationary);
+        ctx->stationary = NULL;
+    }
+    if (ctx->powers_ready) freePowerCache(&ctx->powers);
+    ctx->powers_ready = 0;
+    free(ctx->kinds);
+    ctx->kinds = NULL;
+    free(ctx->periods);
+    ctx->periods = NULL;
+    freeAbsorption(&ctx->abs);
+    freeMatrix(&ctx->M);
+    freeCsr(&ctx->P);
+    free_link_array(&ctx->links);
+    freePartition(&ctx->part);
+    freeGraph(ctx->g);
+    ctx->g = NULL;
+    ctx->ready = 0;
+}
+
+void markovFree(t_markov_context *ctx)
+{
+    if (!ctx) return;
+    markovClear(ctx);
+    free(ctx->vertex_class);
+    free(ctx->index_in_class);
+    free(ctx->x);
+    free(ctx->y);
+    free(ctx);
+}
+
+void markovSetGraph(t_markov_context *ctx, t_graph *g)
+{
+    markovClear(ctx);
+    ctx->g = g;
+}
+
+int markovLoadFile(t_markov_context *ctx, const char *filename, int continuous)
+{
+    markovClear(ctx);
+    ctx->g = readGraph(filename);
+    if (!ctx->g) return 0;
+    ctx->g->continuous = continuous;
+    return 1;
+}
+
+double markovUniformize(t_markov_context *ctx)
+{
+    if (!ctx->g || !ctx->g->continuous) return 0.0;
+    double lambda;
+    t_graph *P = uniformize(ctx->g, &lambda);
+    markovSetGraph(ctx, P);
+    return lambda;
+}
+
+const t_graph *markovGraph(const t_markov_context *ctx)
+{
+    return ctx->g;
+}
+
+/* ================= Résultats à la demande ================= */
+
+/* Les tableaux par sommet sont réalloués seulement si la chaîne grandit. */
+static void compute_classes(t_markov_context *ctx)
+{
+    int n = ctx->g->nb_vertices;
+    t_probe probe;
+    probeBegin(&probe, "tarjanPartition");
+    ctx->part = tarjanPartition(ctx->g);
+    probeEnd(&probe);
+    init_link_array(&ctx->links);
+    probeBegin(&probe, "build_class_links");
+    build_class_links(ctx->g, &ctx->part, &ctx->links);
+    probeEnd(&probe);
+    probeBegin(&probe, "removeTransitiveLinks");
+    removeTransitiveLinks(&ctx->links);
+    probeEnd(&probe);
+    ctx->kinds = classifyClasses(&ctx->part, &ctx->links);
+
+    if (n > ctx->vertex_capacity) {
+        free(ctx->vertex_class);
+        free(ctx->index_in_class);
+        ctx->vertex_class = malloc(sizeof(int) * (size_t)n);
+        ctx->index_in_class = malloc(sizeof(int) * (size_t)n);
+        if (!ctx->vertex_class || !ctx->index_in_class) {
+            perror("malloc vertex classes");
+            exit(EXIT_FAILURE);
+        }
+        ctx->vertex_capacity = n;
+    }
+    for (int ci = 0; ci < ctx->part.size; ++ci) {
+        const t_class *c = &ctx->part.classes[ci];
+        for (int i = 0; i < c->size; ++i) {
+            ctx->vertex_class[c->vertices[i] - 1] = ci;
+            ctx->index_in_class[c->vertices[i] - 1] = i;
+        }
+    }
+    ctx->ready |= MARKOV_CLASSES;
+}
+
+static int need(t_markov_context *ctx, int result)
+{
+    if (!ctx->g) return 0;
+    if (ctx->ready & result) return 1;
+    if ((result & (MARKOV_PERIODS | MARKOV_STATIONARY | MARKOV_ABSORPTION)) && !(ctx->ready & MARKOV_CLASSES)) {
+        compute_classes(ctx);
+    }
+    switch (result) {
+        case MARKOV_CLASSES:
+            compute_classes(ctx);
+            break;
+        case MARKOV_PERIODS:
+            ctx->periods = getAllPeriods(ctx->g, &ctx->part);
+            break;
+        case MARKOV_STATIONARY:
+            ctx->stationary = calloc((size_t)(ctx->part.size > 0 ? ctx->part.size : 1), sizeof(float *));
+            if (!ctx->stationary) {
+                perror("calloc stationary");
+                exit(EXIT_FAILURE);
+            }
+            for (int ci = 0; ci < ctx->part.size; ++ci) {
+                if (ctx->kinds[ci] != CLASS_TRANSIENT) {
+                    ctx->stationary[ci] = computeClassStationary(ctx->g, &ctx->part, ci);
+                }
+            }
+            break;
+        case MARKOV_ABSORPTION:
+            ctx->abs = computeAbsorption(ctx->g, &ctx->part, &ctx->links);
+            break;
+        case MARKOV_MATRIX:
+            ctx->M = createMatrixFromGraph(ctx->g);
+            break;
+        case MARKOV_CSR:
+            ctx->P = csrFromGraph(ctx->g);
+            break;
+        default:
+            return 0;
+    }
+    ctx->ready |= result;
+    return 1;
+}
+
+void markovPrepare(t_markov_context *ctx, int results)
+{
+    for (int r = MARKOV_CLASSES; r < MARKOV_ALL; r <<= 1) {
+        if (results & r) need(ctx, r);
+    }
+}
+
+void markovSummary(t_markov_context *ctx, t_markov_summary *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    if (!need(ctx, MARKOV_CLASSES)) return;
+    summary->nb_vertices = ctx->g->nb_vertices;
+    summary->nb_arcs = countArcs(ctx->g);
+    summary->valid = isMarkovGraph(ctx->g, 0.01f);
+    summary->nb_classes = ctx->part.size;
+    for (int ci = 0; ci < ctx->part.size; ++ci) {
+        summary->nb_transient += ctx->kinds[ci] == CLASS_TRANSIENT;
+    }
+    summary->irreducible = ctx->part.size == 1;
+}
+
+const t_partition *markovPartition(t_markov_context *ctx)
+{
+    return need(ctx, MARKOV_CLASSES) ? &ctx->part : NULL;
+}
+
+const t_link_array *markovLinks(t_markov_context *ctx)
+{
+    return need(ctx, MARKOV_CLASSES) ? &ctx->links : NULL;
+}
+
+const t_class_kind *markovClassKinds(t_markov_context *ctx)
+{
+    return need(ctx, MARKOV_CLASSES) ? ctx->kinds : NULL;
+}
+
+const int *markovVertexClass(t_markov_context *ctx)
+{
+    return need(ctx, MARKOV_CLASSES) ? ctx->vertex_class : NULL;
+}
+
+const int *markovPeriods(t_markov_context *ctx)
+{
+    return need(ctx, MARKOV_PERIODS) ? ctx->periods : NULL;
+}
+
+const float *markovStationary(t_markov_context *ctx, int ci)
+{
+    if (!need(ctx, MARKOV_STATIONARY) || ci < 0 || ci >= ctx->part.size) return NULL;
+    return ctx->stationary[ci];
+}
+
+float markovStationaryAt(t_markov_context *ctx, int v)
+{
+    if (!need(ctx, MARKOV_STATIONARY) || v < 1 || v > ctx->g->nb_vertices) return 0.0f;
+    const float *pi = ctx->stationary[ctx->vertex_class[v - 1]];
+    return pi ? pi[ctx->index_in_class[v - 1]] : 0.0f;
+}
+
+const t_absorption *markovAbsorption(t_markov_context *ctx)
+{
+    return need(ctx, MARKOV_ABSORPTION) ? &ctx->abs : NULL;
+}
+
+const t_matrix *markovMatrix(t_markov_context *ctx)
+{
+    return need(ctx, MARKOV_MATRIX) ? &ctx->M : NULL;
+}
+
+const t_csr_matrix *markovCsr(t_markov_context *ctx)
+{
+    return need(ctx, MARKOV_CSR) ? &ctx->P : NULL;
+}
+
+void markovSetPowerCacheLimit(t_markov_context *ctx, size_t max_bytes)
+{
+    ctx->power_cache_bytes = max_bytes;
+    if (ctx->powers_ready) ctx->powers.max_bytes = max_bytes;
+}
+
+t_matrix markovPower(t_markov_context *ctx, int k)
+{
+    t_matrix empty = {0, 0, NULL};
+    if (!need(ctx, MARKOV_MATRIX)) return empty;
+    if (!ctx->powers_ready) {
+        initPowerCache(&ctx->powers, &ctx->M, ctx->power_cache_bytes);
+        ctx->powers_ready = 1;
+    }
+    return powerCacheGet(&ctx->powers, k);
+}
+
+void markovDistribution(t_markov_context *ctx, const double *pi0, long k, double *out)
+{
+    if (!need(ctx, MARKOV_CSR)) return;
+    int n = ctx->g->nb_vertices;
+    if (n > ctx->vector_capacity) {
+        free(ctx->x);
+        free(ctx->y);
+        ctx->x = malloc(sizeof(double) * (size_t)n);
+        ctx->y = malloc(sizeof(double) * (size_t)n);
+        if (!ctx->x || !ctx->y) {
+            perror("malloc distribution vectors");
+            exit(EXIT_FAILURE);
+        }
+        ctx->vector_capacity = n;
+    }
+    memcpy(ctx->x, pi0, sizeof(double) * (size_t)n);
+    for (long s = 0; s < k; ++s) {
+        csrLeftMultiply(ctx->x, &ctx->P, ctx->y);
+        double *tmp = ctx->x;
+        ctx->x = ctx->y;
+        ctx->y = tmp;
+    }
+    memcpy(out, ctx->x, sizeof(double) * (size_t)n);
+}
+
+void markovBatchDistributionsStream(t_markov_context *ctx, const float *initial, int batch,
+                                    const int *horizons, int nb_horizons, int nb_threads,
+                                    t_kstep_callback callback, void *user)
+{
+    if (!need(ctx, MARKOV_CSR)) return;
+    batchDistributionsStream(&ctx->P, initial, batch, horizons, nb_horizons, nb_threads, callback, user);
+}
+
+t_kstep_result markovBatchDistributions(t_markov_context *ctx, const float *initial, int batch,
+                                        const int *horizons, int nb_horizons, int nb_threads)
+{
+    t_kstep_result empty = {0, 0, 0, NULL, NULL};
+    if (!need(ctx, MARKOV_CSR)) return empty;
+    return batchDistributions(&ctx->P, initial, batch, horizons, nb_horizons, nb_threads);
+}
@@ -3,6 +3,7 @@
 #include <math.h>
 #include "matrix.h"
 #include "utils.h"
+#include "hwcounters.h"
 
 static float **alloc_matrix_data(int n)
 {
@@ -63,6 +64,8 @@ void copyMatrix(t_matrix *dst, const t_matrix *src)
 void multiplyMatrices(const t_matrix *A, const t_matrix *B, t_matrix *C)
 {
     int n = A->rows;
+    t_hw_probe probe;
+    hwProbeBegin(&probe, KERNEL_MULTIPLY);
 
     for (int i = 0; i < n; ++i) {
         for (int j = 0; j < n; ++j) {
@@ -73,6 +76,7 @@ void multiplyMatrices(const t_matrix *A, const t_matrix *B, t_matrix *C)
             C->data[i][j] = sum;
         }
     }
+    hwProbeEnd(&probe, 2.0 * n * n * n, 0.0);
 }
 
 float diffMatrices(const t_matrix *M, const t_matrix *N)
@@ -102,137 +106,214 @@ void printMatrix(const t_matrix *M, const char *name)
     }
 }
 
-t_matrix matrixPower(const t_matrix *M, int power)
+/* ================= Vues sur sous-matrices ================= */
+
+t_matrix_view fullMatrixView(const t_matrix *M)
 {
-    int n = M->rows;
-    t_matrix result = createEmptyMatrix(n);
-    t_matrix tmp = createEmptyMatrix(n);
+    t_matrix_view V = {M, NULL, M->rows};
+    return V;
+}
 
-    for (int i = 0; i < n; ++i) {
-        result.data[i][i] = 1.0f;
+t_matrix_view classMatrixView(const t_matrix *M, const t_partition *part, int compo_index)
+{
+    if (compo_index < 0 || compo_index >= part->size) {
+        fprintf(stderr, "classMatrixView: indice de composante invalide\n");
+        t_matrix_view empty = {M, NULL, 0};
+        return empty;
     }
+    const t_class *c = &part->classes[compo_index];
+    t_matrix_view V = {M, c->vertices, c->size};
+    return V;
+}
 
-    t_matrix base = createEmptyMatrix(n);
-    copyMatrix(&base, M);
-
-    for (int p = 0; p < power; ++p) {
-        multiplyMatrices(&result, &base, &tmp);
-        copyMatrix(&result, &tmp);
+t_matrix gatherView(const t_matrix_view *V)
+{
+    int k = V->size;
+    t_matrix sub = createEmptyMatrix(k);
+    for (int i = 0; i < k; ++i) {
+        const float *row = viewRow(V, i);
+        if (!V->vertices) {
+            for (int j = 0; j < k; ++j) {
+                sub.data[i][j] = row[j];
+            }
+        } else {
+            for (int j = 0; j < k; ++j) {
+                sub.data[i][j] = row[V->vertices[j] - 1];
+            }
+        }
     }
-
-    freeMatrix(&base);
-    freeMatrix(&tmp);
-    return result;
+    return sub;
 }
 
-t_matrix subMatrix(t_matrix matrix, t_partition part, int compo_index)
+t_matrix subMatrix(const t_matrix *matrix, const t_partition *part, int compo_index)
 {
-    if (compo_index < 0 || compo_index >= part.size) {
+    if (compo_index < 0 || compo_index >= part->size) {
         fprintf(stderr, "subMatrix: indice de composante invalide\n");
         t_matrix empty = {0, 0, NULL};
         return empty;
     }
+    t_matrix_view V = classMatrixView(matrix, part, compo_index);
+    return gatherView(&V);
+}
 
-    t_class *c = &part.classes[compo_index];
-    int k = c->size;
-    t_matrix sub = createEmptyMatrix(k);
+/*
+ * Calcule les lignes [row_begin, row_end) de C = A * B ; si with_diff, accumule
+ * dans le même balayage la somme des |a_ij - c_ij| pendant que la ligne est en cache.
+ */
+static float multiply_rows(const t_matrix *A, const t_matrix_view *B, t_matrix *C,
+                           int row_begin, int row_end, int with_diff)
+{
+    int n = B->size;
+    const int *cols = B->vertices;
+    float diff = 0.0f;
+    t_hw_probe probe;
+    hwProbeBegin(&probe, KERNEL_MULTIPLY_ROWS);
 
-    for (int i = 0; i < k; ++i) {
-        int vi = c->vertices[i] - 1;
-        for (int j = 0; j < k; ++j) {
-            int vj = c->vertices[j] - 1;
-            sub.data[i][j] = matrix.data[vi][vj];
+    /* Ordre i-k-j : même ordre de sommation sur k que multiplyMatrices. */
+    for (int i = row_begin; i < row_end; ++i) {
+        const float *a_row = A->data[i];
+        float *c_row = C->data[i];
+        for (int j = 0; j < n; ++j) {
+            c_row[j] = 0.0f;
+        }
+        for (int k = 0; k < n; ++k) {
+            float a = a_row[k];
+            if (a == 0.0f) continue;
+            const float *b_row = viewRow(B, k);
+            if (!cols) {
+                for (int j = 0; j < n; ++j) {
+                    c_row[j] += a * b_row[j];
+                }
+            } else {
+                for (int j = 0; j < n; ++j) {
+                    c_row[j] += a * b_row[cols[j] - 1];
+                }
+            }
+        }
+        if (!with_diff) continue;
+        for (int j = 0; j < n; ++j) {
+            diff += fabsf(a_row[j] - c_row[j]);
         }
     }
-    return sub;
+    /* Opérations nominales : les coefficients nuls de A sont sautés. */
+    hwProbeEnd(&probe, 2.0 * (row_end - row_begin) * n * n, 0.0);
+    return diff;
 }
 
-t_matrix iterateUntilStationary(const t_matrix *M, float eps, int max_iter, int *power_out)
+float multiplyAndDiffRowsView(const t_matrix *A, const t_matrix_view *B, t_matrix *C,
+                              int row_begin, int row_end)
+{
+    return multiply_rows(A, B, C, row_begin, row_end, 1);
+}
+
+float multiplyAndDiffRows(const t_matrix *A, const t_matrix *B, t_matrix *C,
+                          int row_begin, int row_end)
+{
+    t_matrix_view V = fullMatrixView(B);
+    return multiplyAndDiffRowsView(A, &V, C, row_begin, row_end);
+}
+
+void multiplyMatrixView(const t_matrix *A, const t_matrix_view *B, t_matrix *C)
+{
+    multiply_rows(A, B, C, 0, B->size, 0);
+}
+
+t_matrix matrixPowerView(const t_matrix_view *V, int power)
+{
+    int n = V->size;
+    t_matrix result = createEmptyMatrix(n);
+    t_matrix tmp = createEmptyMatrix(n);
+
+    for (int i = 0; i < n; ++i) {
+        result.data[i][i] = 1.0f;
+    }
+
+    for (int p = 0; p < power; ++p) {
+        multiplyMatrixView(&result, V, &tmp);
+        t_matrix sw = result;
+        result = tmp;
+        tmp = sw;
+    }
+
+    freeMatrix(&tmp);
+    return result;
+}
+
+t_matrix matrixPower(const t_matrix *M, int power)
+{
+    t_matrix_view V = fullMatrixView(M);
+    return matrixPowerView(&V, power);
+}
+
+t_matrix iterateUntilStationaryView(const t_matrix_view *V, float eps, int max_iter, int *power_out)
 {
-    int n = M->rows;
-    t_matrix Mk = createEmptyMatrix(n);
-    t_matrix Mprev = createEmptyMatrix(n);
-    copyMatrix(&Mk, M);
-    copyMatrix(&Mprev, M);
+    int n = V->size;
+    t_matrix Mk = gatherView(V);
+    t_matrix next = createEmptyMatrix(n);
 
-    float d = 0.0f;
     int k;
     for (k = 2; k <= max_iter; ++k) {
-        t_matrix next = createEmptyMatrix(n);
-        multiplyMatrices(&Mk, M, &next);
-        d = diffMatrices(&Mk, &next);
-        freeMatrix(&Mprev);
-        Mprev = Mk;
+        float d = multiplyAndDiffRowsView(&Mk, V, &next, 0, n);
+        t_matrix tmp = Mk;
         Mk = next;
+        next = tmp;
         if (d < eps) {
             break;
         }
     }
     if (power_out) *power_out = k;
-    freeMatrix(&Mprev);
+    freeMatrix(&next);
     return Mk;
 }
 
-/* ================= Périodicité (bonus) ================= */
-
-static int gcd_int(int a, int b)
+t_matrix iterateUntilStationary(const t_matrix *M, float eps, int max_iter, int *power_out)
 {
-    while (b != 0) {
-        int temp = b;
-        b = a % b;
-        a = temp;
-    }
-    return a;
+    t_matrix_view V = fullMatrixView(M);
+    return iterateUntilStationaryView(&V, eps, max_iter, power_out);
 }
 
-static int gcd_array(int *vals, int nbvals)
-{
-    if (nbvals == 0) return 0;
-    int result = vals[0];
-    for (int i = 1; i < nbvals; ++i) {
-        result = gcd_int(result, vals[i]);
-    }
-    return result;
-}
+/* ================= Périodicité (bonus) ================= */
 
-int getPeriod(t_matrix sub_matrix)
+int getPeriodView(const t_matrix_view *V)
 {
-    int n = sub_matrix.rows;
-    int *periods = malloc((size_t)n * sizeof(int));
-    if (!periods) {
-        perror("malloc periods");
+    int n = V->size;
+    if (n == 0) return 0;
+
+    int *level = malloc((size_t)n * sizeof(int));
+    int *queue = malloc((size_t)n * sizeof(int));
+    if (!level || !queue) {
+        perror("malloc period bfs");
         exit(EXIT_FAILURE);
     }
-    int period_count = 0;
-    int cpt;
-
-    t_matrix power_matrix = createEmptyMatrix(n);
-    t_matrix result_matrix = createEmptyMatrix(n);
-    copyMatrix(&power_matrix, &sub_matrix);
-
-    for (cpt = 1; cpt <= n; cpt++)
-    {
-        int diag_nonzero = 0;
-        for (int i = 0; i < n; i++)
-        {
-            if (power_matrix.data[i][i] > 0.0f)
-            {
-                diag_nonzero = 1;
-                break;
+    for (int i = 0; i < n; ++i) {
+        level[i] = -1;
+    }
+
+    int head = 0, tail = 0;
+    level[0] = 0;
+    queue[tail++] = 0;
+    int period = 0;
+
+    while (head < tail) {
+        int u = queue[head++];
+        for (int v = 0; v < n; ++v) {
+            if (viewAt(V, u, v) == 0.0f) continue;
+            if (level[v] == -1) {
+                level[v] = level[u] + 1;
+                queue[tail++] = v;
+            } else {
+                period = gcd_int(period, level[u] + 1 - level[v]);
             }
         }
-        if (diag_nonzero) {
-            periods[period_count] = cpt;
-            period_count++;
-        }
-        multiplyMatrices(&power_matrix, &sub_matrix, &result_matrix);
-        copyMatrix(&power_matrix, &result_matrix);
     }
 
-    int period = gcd_array(periods, period_count);
-
-    free(periods);
-    freeMatrix(&power_matrix);
-    freeMatrix(&result_matrix);
+    free(level);
+    free(queue);
     return period;
 }
+
+int getPeriod(const t_matrix *sub_matrix)
+{
+    t_matrix_view V = fullMatrixView(sub_matrix);
+    return getPeriodView(&V);
+}
@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "options.h"
+
+typedef struct {
+    const char *name;
+    int stage;
+} t_stage_name;
+
+static const t_stage_name STAGE_NAMES[] = {
+    {"graph", STAGE_GRAPH},
+    {"classes", STAGE_CLASSES},
+    {"powers", STAGE_POWERS},
+    {"limit", STAGE_LIMIT},
+    {"distributions", STAGE_DISTRIBUTIONS},
+    {"absorption", STAGE_ABSORPTION},
+    {"simulation", STAGE_SIMULATION},
+    {"kstep", STAGE_KSTEP},
+    {"all", STAGE_ALL},
+};
+
+void printUsage(const char *program)
+{
+    fprintf(stderr,
+            "Usage : %s fichier [options]\n"
+            "        %s --batch REPERTOIRE|LISTE [--batch-dir DIR] [--jobs N] [options]\n"
+            "        %s --serve SOCKET [fichier] [--jobs N]\n"
+            "  --stages LISTE     etapes a executer, separees par des virgules :\n"
+            "                     graph,classes,powers,limit,distributions,absorption,simulation,kstep,all\n"
+            "                     (defaut : toutes sauf simulation et kstep)\n"
+            "  --print MODE       full (defaut), top-k (voir --top) ou summary\n"
+            "  --top K            nombre de coefficients affiches en mode top-k (defaut 10)\n"
+            "  --powers LISTE     puissances de M affichees (defaut 3,7)\n"
+            "  --power-cache MO   plafond du cache des puissances de M, en Mo (defaut : aucun)\n"
+            "  --format FORMAT    text (defaut), jsonl ou binary\n"
+            "  --output FICHIER   ecrit les resultats dans FICHIER\n"
+            "  --lump             analyse la chaine quotient (agregation)\n"
+            "  --ctmc [--time T]  le fichier donne les taux d'un generateur\n"
+            "  --sim-start S      etat initial de la simulation (defaut 1)\n"
+            "  --sim-walks N      nombre de trajectoires simulees (defaut 10000)\n"
+            "  --sim-steps L      longueur maximale d'une trajectoire (defaut 1000)\n"
+            "  --sim-seed S       graine de la simulation (defaut 42)\n"
+            "  --sim-bins B       classes de l'histogramme des temps d'atteinte (defaut 10)\n"
+            "  --kstep LISTE      distributions apres k pas pour chaque k de LISTE (defaut 1,10,100),\n"
+            "                     calculees ensemble pour tous les etats initiaux (active l'etape kstep)\n"
+            "  --kstep-from LISTE etats initiaux des distributions a k pas (defaut 1)\n"
+            "  --out-of-core DIR  puissances calculees sur des matrices tuilees dans DIR\n"
+            "  --batch SOURCE     analyse les fichiers *.txt d'un repertoire, ou ceux listes\n"
+            "                     dans SOURCE (un chemin par ligne) ; rapport sur la sortie\n"
+            "  --batch-dir DIR    resultats du mode --batch (defaut batch_out)\n"
+            "  --jobs N           threads des modes --batch et --serve (defaut : nombre de processeurs)\n"
+            "  --serve SOCKET     serveur resident sur la socket Unix SOCKET (protocole : server.h)\n"
+            "  --stats FORMAT     temps, memoire et allocations par etape sur stderr : text ou json\n"
+            "  --counters FORMAT  compteurs materiels des noyaux (perf_event_open) : text ou json\n",
+            program, program, program);
+}
+
+static int parse_stages(const char *list, int *stages)
+{
+    *stages = 0;
+    char *copy = strdup(list);
+    if (!copy) {
+        perror("strdup stages");
+        exit(EXIT_FAILURE);
+    }
+    int ok = 1;
+    for (char *tok = strtok(copy, ","); tok; tok = strtok(NULL, ",")) {
+        int found = 0;
+        for (size_t i = 0; i < sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]); ++i) {
+            if (strcmp(tok, STAGE_NAMES[i].name) == 0) {
+                *stages |= STAGE_NAMES[i].stage;
+                found = 1;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "Etape inconnue : %s\n", tok);
+            ok = 0;
+        }
+    }
+    free(copy);
+    return ok;
+}
+
+/* Liste d'entiers >= min separes par des virgules, au plus max valeurs ; what nomme la liste. */
+static int parse_int_list(const char *what, const char *list, int min, int max, int *values, int *count)
+{
+    *count = 0;
+    const char *p = list;
+    while (*p) {
+        char *end;
+        long k = strtol(p, &end, 10);
+        if (end == p || k < min || k > INT_MAX || *count == max) {
+            fprintf(stderr, "Liste de %s invalide : %s\n", what, list);
+            return 0;
+        }
+        values[(*count)++] = (int)k;
+        p = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') {
+            fprintf(stderr, "Liste de %s invalide : %s\n", what, list);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Entier strictement positif tenant dans un int. */
+static int parse_positive(const char *option, const char *text, long *value)
+{
+    char *end;
+    *value = strtol(text, &end, 10);
+    if (end == text || *end || *value <= 0 || *value > INT_MAX) {
+        fprintf(stderr, "%s attend un entier positif\n", option);
+        return 0;
+    }
+    return 1;
+}
+
+/* Réel fini et positif ou nul (durée). */
+static int parse_duration(const char *option, const char *text, double *value)
+{
+    char *end;
+    *value = strtod(text, &end);
+    if (end == text || *end || !isfinite(*value) || *value < 0.0) {
+        fprintf(stderr, "%s attend un reel positif ou nul\n", option);
+        return 0;
+    }
+    return 1;
+}
+
+int parseOptions(int argc, char **argv, t_options *opt)
+{
+    opt->filename = NULL;
+    opt->stages = STAGE_DEFAULT;
+    opt->print.mode = PRINT_FULL;
+    opt->print.topk = 10;
+    opt->format = FORMAT_TEXT;
+    opt->output = NULL;
+    opt->powers[0] = 3;
+    opt->powers[1] = 7;
+    opt->nb_powers = 2;
+    opt->power_cache_bytes = 0;
+    opt->lump = 0;
+    opt->ctmc = 0;
+    opt->horizon = 1.0;
+    opt->sim_start = 1;
+    opt->sim_walks = 10000;
+    opt->sim_steps = 1000;
+    opt->sim_seed = 42;
+    opt->sim_bins = 10;
+    opt->kstep[0] = 1;
+    opt->kstep[1] = 10;
+    opt->kstep[2] = 100;
+    opt->nb_kstep = 3;
+    opt->kstep_from[0] = 1;
+    opt->nb_kstep_from = 1;
+    int kstep_given = 0;
+    opt->out_of_core = NULL;
+    opt->batch = NULL;
+    opt->batch_dir = "batch_out";
+    opt->jobs = 0;
+    opt->serve = NULL;
+    opt->stats = 0;
+    opt->counters = 0;
+
+    long value;
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        int has_value = i + 1 < argc;
+        if (strcmp(a, "--lump") == 0) {
+            opt->lump = 1;
+        } else if (strcmp(a, "--ctmc") == 0) {
+            opt->ctmc = 1;
+        } else if (strcmp(a, "--time") == 0 && has_value) {
+            if (!parse_duration(a, argv[++i], &opt->horizon)) return 0;
+        } else if (strcmp(a, "--sim-start") == 0 && has_value) {
+            if (!parse_positive(a, argv[++i], &value)) return 0;
+            opt->sim_start = (int)value;
+        } else if (strcmp(a, "--sim-walks") == 0 && has_value) {
+            if (!parse_positive(a, argv[++i], &value)) return 0;
+            opt->sim_walks = value;
+        } else if (strcmp(a, "--sim-steps") == 0 && has_value) {
+            if (!parse_positive(a, argv[++i], &value)) return 0;
+            opt->sim_steps = (int)value;
+        } else if (strcmp(a, "--sim-seed") == 0 && has_value) {
+            opt->sim_seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(a, "--sim-bins") == 0 && has_value) {
+            if (!parse_positive(a, argv[++i], &value)) return 0;
+            opt->sim_bins = (int)value;
+        } else if (strcmp(a, "--stages") == 0 && has_value) {
+            if (!parse_stages(argv[++i], &opt->stages)) return 0;
+        } else if (strcmp(a, "--print") == 0 && has_value) {
+            const char *m = argv[++i];
+            if (strcmp(m, "full") == 0) opt->print.mode = PRINT_FULL;
+            else if (strcmp(m, "top-k") == 0) opt->print.mode = PRINT_TOPK;
+            else if (strcmp(m, "summary") == 0) opt->print.mode = PRINT_SUMMARY;
+            else {
+                fprintf(stderr, "Mode d'affichage inconnu : %s\n", m);
+                return 0;
+            }
+        } else if (strcmp(a, "--format") == 0 && has_value) {
+            const char *f = argv[++i];
+            if (strcmp(f, "text") == 0) opt->format = FORMAT_TEXT;
+            else if (strcmp(f, "jsonl") == 0) opt->format = FORMAT_JSONL;
+            else if (strcmp(f, "binary") == 0) opt->format = FORMAT_BINARY;
+            else {
+                fprintf(stderr, "Format inconnu : %s\n", f);
+                return 0;
+            }
+        } else if (strcmp(a, "--top") == 0 && has_value) {
+            opt->print.topk = atoi(argv[++i]);
+            if (opt->print.topk <= 0) {
+                fprintf(stderr, "--top attend un entier positif\n");
+                return 0;
+            }
+        } else if (strcmp(a, "--powers") == 0 && has_value) {
+            if (!parse_int_list("puissances", argv[++i], 0, MAX_POWERS, opt->powers, &opt->nb_powers)) return 0;
+        } else if (strcmp(a, "--power-cache") == 0 && has_value) {
+            if (!parse_positive(a, argv[++i], &value)) return 0;
+            opt->power_cache_bytes = (size_t)value << 20;
+        } else if (strcmp(a, "--kstep") == 0 && has_value) {
+            if (!parse_int_list("horizons", argv[++i], 0, MAX_KSTEP, opt->kstep, &opt->nb_kstep)) return 0;
+            kstep_given = 1;
+        } else if (strcmp(a, "--kstep-from") == 0 && has_value) {
+            if (!parse_int_list("etats", argv[++i], 1, MAX_KSTEP, opt->kstep_from, &opt->nb_kstep_from)) return 0;
+        } else if (strcmp(a, "--output") == 0 && has_value) {
+            opt->output = argv[++i];
+        } else if (strcmp(a, "--out-of-core") == 0 && has_value) {
+            opt->out_of_core = argv[++i];
+        } else if (strcmp(a, "--batch") == 0 && has_value) {
+            opt->batch = argv[++i];
+        } else if (strcmp(a, "--batch-dir") == 0 && has_value) {
+            opt->batch_dir = argv[++i];
+        } else if ((strcmp(a, "--stats") == 0 || strcmp(a, "--counters") == 0) && has_value) {
+            const char *f = argv[++i];
+            int *report = strcmp(a, "--stats") == 0 ? &opt->stats : &opt->counters;
+            if (strcmp(f, "text") == 0) *report = 1;
+            else if (strcmp(f, "json") == 0) *report = 2;
+            else {
+                fprintf(stderr, "Format de mesures inconnu : %s\n", f);
+                return 0;
+            }
+        } else if (strcmp(a, "--serve") == 0 && has_value) {
+            opt->serve = argv[++i];
+        } else if (strcmp(a, "--jobs") == 0 && has_value) {
+            opt->jobs = atoi(argv[++i]);
+        } else if (a[0] == '-' && a[1] == '-') {
+            fprintf(stderr, "Option inconnue ou incomplete : %s\n", a);
+            return 0;
+        } else if (!opt->filename) {
+            opt->filename = a;
+        } else {
+            fprintf(stderr, "Fichier en trop : %s\n", a);
+            return 0;
+        }
+    }
+    if (kstep_given) opt->stages |= STAGE_KSTEP;
+    if (opt->batch && opt->filename) {
+        fprintf(stderr, "--batch et un fichier de graphe sont incompatibles\n");
+        return 0;
+    }
+    if (!opt->filename && !opt->batch && !opt->serve) {
+        fprintf(stderr, "Aucun fichier de graphe donne\n");
+        return 0;
+    }
+    return 1;
+}
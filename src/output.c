@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "output.h"
+#include "utils.h"
+
+typedef struct {
+    float value;
+    long index;
+} t_heap_item;
+
+/* Tas binaire min de taille bornée : la racine est la plus petite des k valeurs retenues. */
+typedef struct {
+    t_heap_item *items;
+    int size;
+    int capacity;
+} t_top_heap;
+
+static void heap_sift_down(t_top_heap *h, int i)
+{
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < h->size && h->items[l].value < h->items[m].value) m = l;
+        if (r < h->size && h->items[r].value < h->items[m].value) m = r;
+        if (m == i) return;
+        t_heap_item t = h->items[i];
+        h->items[i] = h->items[m];
+        h->items[m] = t;
+        i = m;
+    }
+}
+
+static void heap_offer(t_top_heap *h, float value, long index)
+{
+    if (h->capacity == 0) return;
+    if (h->size < h->capacity) {
+        int i = h->size++;
+        h->items[i].value = value;
+        h->items[i].index = index;
+        while (i > 0 && h->items[(i - 1) / 2].value > h->items[i].value) {
+            t_heap_item t = h->items[i];
+            h->items[i] = h->items[(i - 1) / 2];
+            h->items[(i - 1) / 2] = t;
+            i = (i - 1) / 2;
+        }
+    } else if (value > h->items[0].value) {
+        h->items[0].value = value;
+        h->items[0].index = index;
+        heap_sift_down(h, 0);
+    }
+}
+
+static int compare_items_desc(const void *a, const void *b)
+{
+    const t_heap_item *x = a;
+    const t_heap_item *y = b;
+    if (x->value != y->value) return x->value < y->value ? 1 : -1;
+    return x->index < y->index ? -1 : (x->index > y->index);
+}
+
+static t_top_heap heap_create(int k)
+{
+    t_top_heap h;
+    h.size = 0;
+    h.capacity = k > 0 ? k : 0;
+    h.items = malloc(sizeof(t_heap_item) * (size_t)(h.capacity > 0 ? h.capacity : 1));
+    if (!h.items) {
+        perror("malloc top-k heap");
+        exit(EXIT_FAILURE);
+    }
+    return h;
+}
+
+int topKIndices(const float *values, int n, int k, int *out)
+{
+    t_top_heap h = heap_create(k < n ? k : n);
+    for (int i = 0; i < n; ++i) {
+        heap_offer(&h, values[i], i);
+    }
+    qsort(h.items, (size_t)h.size, sizeof(t_heap_item), compare_items_desc);
+    for (int i = 0; i < h.size; ++i) {
+        out[i] = (int)h.items[i].index;
+    }
+    int count = h.size;
+    free(h.items);
+    return count;
+}
+
+int topKRowEntries(t_row_reader read, void *arg, int rows, int cols, int k,
+                   int *row, int *col, float *value)
+{
+    t_top_heap h = heap_create(k);
+    for (int i = 0; i < rows; ++i) {
+        const float *r = read(arg, i);
+        for (int j = 0; j < cols; ++j) {
+            if (r[j] != 0.0f) heap_offer(&h, r[j], (long)i * cols + j);
+        }
+    }
+    qsort(h.items, (size_t)h.size, sizeof(t_heap_item), compare_items_desc);
+    for (int t = 0; t < h.size; ++t) {
+        row[t] = (int)(h.items[t].index / cols);
+        col[t] = (int)(h.items[t].index % cols);
+        value[t] = h.items[t].value;
+    }
+    int count = h.size;
+    free(h.items);
+    return count;
+}
+
+t_matrix_summary summarizeRows(t_row_reader read, void *arg, int rows, int cols)
+{
+    t_matrix_summary s = {0, 0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < rows; ++i) {
+        const float *r = read(arg, i);
+        float sum = 0.0f;
+        for (int j = 0; j < cols; ++j) {
+            float x = r[j];
+            if (x == 0.0f) continue;
+            s.nnz++;
+            sum += x;
+            if (x > s.max) s.max = x;
+        }
+        if (i == 0 || sum < s.min_row_sum) s.min_row_sum = sum;
+        if (i == 0 || sum > s.max_row_sum) s.max_row_sum = sum;
+    }
+    return s;
+}
@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "period.h"
+#include "utils.h"
+
+/*
+ * level et queue sont des tableaux de travail : level est indexé par sommet
+ * (taille nb_vertices), seules les cases de la classe sont lues ou écrites ;
+ * queue doit pouvoir contenir tous les sommets de la classe.
+ */
+static int class_period_bfs(const t_graph *g, const t_class *c, const int *vertex_to_class,
+                            int compo_index, int *level, int *queue)
+{
+    if (c->size == 0) return 0;
+
+    for (int i = 0; i < c->size; ++i) {
+        level[c->vertices[i] - 1] = -1;
+    }
+
+    int head = 0, tail = 0;
+    int start = c->vertices[0] - 1;
+    level[start] = 0;
+    queue[tail++] = start;
+    int period = 0;
+
+    while (head < tail) {
+        int u = queue[head++];
+        for (t_arc *cur = g->array[u].head; cur; cur = cur->next) {
+            int v = cur->dest - 1;
+            if (vertex_to_class[v] != compo_index) continue;
+            if (level[v] == -1) {
+                level[v] = level[u] + 1;
+                queue[tail++] = v;
+            } else {
+                period = gcd_int(period, level[u] + 1 - level[v]);
+            }
+        }
+    }
+    return period;
+}
+
+int getClassPeriod(const t_graph *g, const t_partition *part, const int *vertex_to_class,
+                   int compo_index, int *phase_out)
+{
+    if (compo_index < 0 || compo_index >= part->size) {
+        fprintf(stderr, "getClassPeriod: indice de composante invalide\n");
+        return 0;
+    }
+    const t_class *c = &part->classes[compo_index];
+    int *level = malloc(sizeof(int) * (size_t)g->nb_vertices);
+    int *queue = malloc(sizeof(int) * (size_t)(c->size > 0 ? c->size : 1));
+    if (!level || !queue) {
+        perror("malloc class period");
+        exit(EXIT_FAILURE);
+    }
+
+    int period = class_period_bfs(g, c, vertex_to_class, compo_index, level, queue);
+
+    if (phase_out) {
+        for (int i = 0; i < c->size; ++i) {
+            int lv = level[c->vertices[i] - 1];
+            phase_out[i] = period > 0 ? lv % period : 0;
+        }
+    }
+
+    free(level);
+    free(queue);
+    return period;
+}
+
+int *getAllPeriods(const t_graph *g, const t_partition *part)
+{
+    int n = g->nb_vertices;
+    int *periods = calloc_int_array(part->size > 0 ? part->size : 1);
+    int *vertex_to_class = buildVertexToClass(part, n);
+    int *level = malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    int *queue = malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    if (!level || !queue) {
+        perror("malloc periods");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int ci = 0; ci < part->size; ++ci) {
+        periods[ci] = class_period_bfs(g, &part->classes[ci], vertex_to_class, ci, level, queue);
+    }
+
+    free(level);
+    free(queue);
+    free(vertex_to_class);
+    return periods;
+}
+
+/* ================= Sous-classes cycliques ================= */
+
+/* out = x * V (vecteurs ligne de taille V->size). */
+static void vector_times_view(const float *x, const t_matrix_view *V, float *out)
+{
+    int k = V->size;
+    for (int j = 0; j < k; ++j) {
+        out[j] = 0.0f;
+    }
+    for (int m = 0; m < k; ++m) {
+        if (x[m] == 0.0f) continue;
+        const float *row = viewRow(V, m);
+        for (int j = 0; j < k; ++j) {
+            out[j] += x[m] * row[V->vertices ? V->vertices[j] - 1 : j];
+        }
+    }
+}
+
+t_cyclic_analysis analyzeCyclicView(const t_matrix_view *V, const int *phase, int period,
+                                    int origin, float eps, int max_iter)
+{
+    t_cyclic_analysis a = {0, 0, NULL, 0, NULL, NULL};
+    int k = V->size;
+    a.size = k;
+    a.period = period;
+    a.phase = calloc_int_array(k > 0 ? k : 1);
+    /* Sous-classes renumérotées pour que origin soit dans la sous-classe 0. */
+    int shift = period > 1 && k > 0 ? phase[origin] : 0;
+    for (int i = 0; i < k; ++i) {
+        a.phase[i] = period > 1 ? (phase[i] - shift + period) % period : phase[i];
+    }
+    if (period <= 1) return a;
+
+    int d = period;
+
+    /* origin en tête : sa ligne du bloc donne la limite depuis la sous-classe 0. */
+    int *phase0 = calloc_int_array(k);
+    int k0 = 0;
+    phase0[k0++] = origin;
+    for (int i = 0; i < k; ++i) {
+        if (a.phase[i] == 0 && i != origin) phase0[k0++] = i;
+    }
+
+    /* Lignes de la sous-classe 0 dans P^d : k0 lignes multipliées d-1 fois par P. */
+    float *rows = calloc_float_array(k0 * k);
+    float *next = calloc_float_array(k0 * k);
+    for (int r = 0; r < k0; ++r) {
+        for (int j = 0; j < k; ++j) {
+            rows[r * k + j] = viewAt(V, phase0[r], j);
+        }
+    }
+    for (int step = 1; step < d; ++step) {
+        for (int r = 0; r < k0; ++r) {
+            vector_times_view(&rows[r * k], V, &next[r * k]);
+        }
+        float *tmp = rows;
+        rows = next;
+        next = tmp;
+    }
+
+    t_matrix block = createEmptyMatrix(k0);
+    for (int r = 0; r < k0; ++r) {
+        for (int c = 0; c < k0; ++c) {
+            block.data[r][c] = rows[r * k + phase0[c]];
+        }
+    }
+    t_matrix block_lim = iterateUntilStationary(&block, eps, max_iter, &a.power);
+
+    a.phase_limits = malloc(sizeof(float *) * (size_t)d);
+    if (!a.phase_limits) {
+        perror("malloc phase limits");
+        exit(EXIT_FAILURE);
+    }
+    a.phase_limits[0] = calloc_float_array(k);
+    for (int c = 0; c < k0; ++c) {
+        a.phase_limits[0][phase0[c]] = block_lim.data[0][c];
+    }
+    for (int s = 1; s < d; ++s) {
+        a.phase_limits[s] = calloc_float_array(k);
+        vector_times_view(a.phase_limits[s - 1], V, a.phase_limits[s]);
+    }
+
+    a.cesaro = calloc_float_array(k);
+    for (int s = 0; s < d; ++s) {
+        for (int j = 0; j < k; ++j) {
+            a.cesaro[j] += a.phase_limits[s][j] / (float)d;
+        }
+    }
+
+    freeMatrix(&block_lim);
+    freeMatrix(&block);
+    free(rows);
+    free(next);
+    free(phase0);
+    return a;
+}
+
+t_cyclic_analysis analyzeCyclicClass(const t_graph *g, const t_matrix *M, const t_partition *part,
+                                     const int *vertex_to_class, int compo_index,
+                                     float eps, int max_iter)
+{
+    if (compo_index < 0 || compo_index >= part->size) {
+        fprintf(stderr, "analyzeCyclicClass: indice de composante invalide\n");
+        t_cyclic_analysis empty = {0, 0, NULL, 0, NULL, NULL};
+        return empty;
+    }
+
+    int k = part->classes[compo_index].size;
+    int *phase = calloc_int_array(k > 0 ? k : 1);
+    int period = getClassPeriod(g, part, vertex_to_class, compo_index, phase);
+    t_matrix_view V = classMatrixView(M, part, compo_index);
+
+    t_cyclic_analysis a = analyzeCyclicView(&V, phase, period, 0, eps, max_iter);
+
+    free(phase);
+    return a;
+}
+
+void freeCyclicAnalysis(t_cyclic_analysis *a)
+{
+    if (!a) return;
+    if (a->phase_limits) {
+        for (int s = 0; s < a->period; ++s) {
+            free(a->phase_limits[s]);
+        }
+        free(a->phase_limits);
+    }
+    free(a->phase);
+    free(a->cesaro);
+    a->phase = NULL;
+    a->cesaro = NULL;
+    a->phase_limits = NULL;
+    a->period = a->size = a->power = 0;
+}
@@ -0,0 +1,298 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pipeline.h"
+#include "threadpool.h"
+#include "sparse.h"
+#include "spectral.h"
+#include "utils.h"
+#include "instrument.h"
+
+#define SMALL_CLASS_SIZE 16     /* en dessous : classe traitée dans un lot */
+#define BATCH_MAX_CLASSES 64    /* nombre maximal de classes par lot */
+#define BIG_CLASS_SIZE 128      /* à partir de là : produits découpés par lignes */
+#define ROWS_PER_TASK 32
+#define SPECTRAL_MAX_ITER 500   /* itérations de l'estimateur spectral */
+#define SPECTRAL_TOL 1e-4
+/* Plafond de sécurité du budget prédit : au-delà, la classe est déclarée non
+ * convergée plutôt que d'itérer sans fin (trou spectral quasi nul). */
+#define ITERATION_CEILING 10000
+
+typedef struct s_pipeline t_pipeline;
+
+typedef struct {
+    t_pipeline *pl;
+    int ci;
+    t_matrix block;
+    t_matrix_view view;
+    int *phase;
+} t_class_job;
+
+struct s_pipeline {
+    const t_graph *g;
+    const t_partition *part;
+    const int *origin;          /* NULL : premier sommet de chaque classe */
+    int *vertex_to_class;
+    int *index_in_class;
+    float eps;
+    int max_iter;
+    t_thread_pool *pool;
+    t_task_group group;
+    t_class_job *jobs;
+    t_class_result *results;
+};
+
+typedef struct {
+    t_pipeline *pl;
+    int first;
+    int count;
+    const int *classes;
+} t_batch_job;
+
+typedef struct {
+    const t_matrix *A;
+    const t_matrix_view *B;
+    t_matrix *C;
+    int begin;
+    int end;
+    float diff;
+} t_rows_job;
+
+/* ================= Étapes d'une classe ================= */
+
+/* Bloc dense de la classe, lu directement dans le graphe : la matrice n x n
+ * n'est jamais construite. Comme createMatrixFromGraph, le dernier arc l'emporte. */
+static void extract_class(t_class_job *job)
+{
+    const t_pipeline *pl = job->pl;
+    const t_class *c = &pl->part->classes[job->ci];
+    job->block = createEmptyMatrix(c->size);
+    for (int i = 0; i < c->size; ++i) {
+        for (t_arc *cur = pl->g->array[c->vertices[i] - 1].head; cur; cur = cur->next) {
+            int v = cur->dest - 1;
+            if (pl->vertex_to_class[v] != job->ci) continue;
+            job->block.data[i][pl->index_in_class[v]] = cur->proba;
+        }
+    }
+    job->view = fullMatrixView(&job->block);
+    job->phase = calloc_int_array(job->view.size > 0 ? job->view.size : 1);
+}
+
+static void compute_period(t_class_job *job)
+{
+    const t_pipeline *pl = job->pl;
+    t_probe probe;
+    probeBeginThread(&probe, "periode", pl->part->classes[job->ci].name);
+    pl->results[job->ci].period = getClassPeriod(pl->g, pl->part, pl->vertex_to_class,
+                                                 job->ci, job->phase);
+    probeEnd(&probe);
+}
+
+static void rows_task(void *arg)
+{
+    t_rows_job *r = arg;
+    r->diff = multiplyAndDiffRowsView(r->A, r->B, r->C, r->begin, r->end);
+}
+
+/* Même boucle que iterateUntilStationaryView, produit découpé en blocs de lignes. */
+static t_matrix iterate_parallel(t_thread_pool *pool, const t_matrix_view *V, float eps,
+                                 int max_iter, int *power_out)
+{
+    int n = V->size;
+    int nb_chunks = (n + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    t_rows_job *chunks = malloc(sizeof(t_rows_job) * (size_t)nb_chunks);
+    if (!chunks) {
+        perror("malloc rows jobs");
+        exit(EXIT_FAILURE);
+    }
+
+    t_matrix Mk = gatherView(V);
+    t_matrix next = createEmptyMatrix(n);
+
+    int k;
+    for (k = 2; k <= max_iter; ++k) {
+        t_task_group rows_group = {0};
+        for (int c = 0; c < nb_chunks; ++c) {
+            chunks[c].A = &Mk;
+            chunks[c].B = V;
+            chunks[c].C = &next;
+            chunks[c].begin = c * ROWS_PER_TASK;
+            chunks[c].end = (c + 1) * ROWS_PER_TASK < n ? (c + 1) * ROWS_PER_TASK : n;
+            pool_submit(pool, rows_task, &chunks[c], &rows_group);
+        }
+        pool_wait(pool, &rows_group);
+
+        float d = 0.0f;
+        for (int c = 0; c < nb_chunks; ++c) {
+            d += chunks[c].diff;
+        }
+        t_matrix tmp = Mk;
+        Mk = next;
+        next = tmp;
+        if (d < eps) {
+            break;
+        }
+    }
+    if (power_out) *power_out = k;
+    freeMatrix(&next);
+    free(chunks);
+    return Mk;
+}
+
+static void compute_distribution(t_class_job *job, int split)
+{
+    const t_pipeline *pl = job->pl;
+    t_class_result *res = &pl->results[job->ci];
+    int k = job->view.size;
+    res->size = k;
+    res->converged = 1;
+    if (k == 0) {
+        freeMatrix(&job->block);
+        return;
+    }
+    t_probe probe;
+    probeBeginThread(&probe, "distribution", pl->part->classes[job->ci].name);
+
+    int origin = pl->origin ? pl->origin[job->ci] : 0;
+    if (res->period > 1) {
+        res->cyclic = analyzeCyclicView(&job->view, job->phase, res->period, origin,
+                                        pl->eps, pl->max_iter);
+        res->power = res->cyclic.power;
+        res->budget = pl->max_iter;
+        res->distribution = calloc_float_array(k);
+        for (int j = 0; j < k; ++j) {
+            res->distribution[j] = res->cyclic.cesaro[j];
+        }
+    } else {
+        t_csr_matrix csr = csrFromView(&job->view);
+        t_spectral_estimate est = estimateSpectralGap(&csr, SPECTRAL_MAX_ITER, SPECTRAL_TOL);
+        freeCsr(&csr);
+        res->rate = est.rate;
+        /* max_iter par défaut ; une classe qui mélange lentement reçoit le
+         * budget prédit, jusqu'à ITERATION_CEILING. */
+        res->budget = predictIterations(&est, k, pl->eps, ITERATION_CEILING);
+        if (res->budget < pl->max_iter) res->budget = pl->max_iter;
+
+        t_matrix lim = split
+            ? iterate_parallel(pl->pool, &job->view, pl->eps, res->budget, &res->power)
+            : iterateUntilStationaryView(&job->view, pl->eps, res->budget, &res->power);
+        res->distribution = calloc_float_array(k);
+        for (int j = 0; j < k; ++j) {
+            res->distribution[j] = lim.data[origin][j];
+        }
+        freeMatrix(&lim);
+    }
+
+    /* Les boucles sortent avec n = budget + 1 quand d < eps n'est jamais atteint. */
+    res->converged = res->power <= res->budget;
+
+    free(job->phase);
+    job->phase = NULL;
+    freeMatrix(&job->block);
+    probeEnd(&probe);
+}
+
+/* ================= Tâches ================= */
+
+static void distribution_task(void *arg)
+{
+    t_class_job *job = arg;
+    compute_distribution(job, job->view.size >= BIG_CLASS_SIZE);
+}
+
+static void period_task(void *arg)
+{
+    t_class_job *job = arg;
+    compute_period(job);
+    pool_submit(job->pl->pool, distribution_task, job, &job->pl->group);
+}
+
+static void extract_task(void *arg)
+{
+    t_class_job *job = arg;
+    extract_class(job);
+    pool_submit(job->pl->pool, period_task, job, &job->pl->group);
+}
+
+static void batch_task(void *arg)
+{
+    t_batch_job *batch = arg;
+    for (int i = 0; i < batch->count; ++i) {
+        t_class_job *job = &batch->pl->jobs[batch->classes[batch->first + i]];
+        extract_class(job);
+        compute_period(job);
+        compute_distribution(job, 0);
+    }
+}
+
+t_class_result *runClassPipeline(const t_graph *g, const t_partition *part, const int *origin,
+                                 int nb_threads, float eps, int max_iter)
+{
+    int nb_classes = part->size;
+    t_class_result *results = calloc((size_t)(nb_classes > 0 ? nb_classes : 1), sizeof(t_class_result));
+    t_class_job *jobs = calloc((size_t)(nb_classes > 0 ? nb_classes : 1), sizeof(t_class_job));
+    int *small = calloc_int_array(nb_classes > 0 ? nb_classes : 1);
+    t_batch_job *batches = calloc((size_t)(nb_classes > 0 ? nb_classes : 1), sizeof(t_batch_job));
+    if (!results || !jobs || !batches) {
+        perror("calloc pipeline");
+        exit(EXIT_FAILURE);
+    }
+
+    t_pipeline pl;
+    pl.g = g;
+    pl.part = part;
+    pl.origin = origin;
+    pl.vertex_to_class = buildVertexToClass(part, g->nb_vertices);
+    pl.index_in_class = calloc_int_array(g->nb_vertices > 0 ? g->nb_vertices : 1);
+    for (int ci = 0; ci < nb_classes; ++ci) {
+        for (int i = 0; i < part->classes[ci].size; ++i) {
+            pl.index_in_class[part->classes[ci].vertices[i] - 1] = i;
+        }
+    }
+    pl.eps = eps;
+    pl.max_iter = max_iter;
+    pl.pool = pool_create(nb_threads);
+    pl.group.pending = 0;
+    pl.jobs = jobs;
+    pl.results = results;
+
+    int nb_small = 0;
+    for (int ci = 0; ci < nb_classes; ++ci) {
+        jobs[ci].pl = &pl;
+        jobs[ci].ci = ci;
+        if (part->classes[ci].size < SMALL_CLASS_SIZE) {
+            small[nb_small++] = ci;
+        } else {
+            pool_submit(pl.pool, extract_task, &jobs[ci], &pl.group);
+        }
+    }
+
+    int nb_batches = 0;
+    for (int first = 0; first < nb_small; first += BATCH_MAX_CLASSES) {
+        t_batch_job *b = &batches[nb_batches++];
+        b->pl = &pl;
+        b->first = first;
+        b->count = nb_small - first < BATCH_MAX_CLASSES ? nb_small - first : BATCH_MAX_CLASSES;
+        b->classes = small;
+        pool_submit(pl.pool, batch_task, b, &pl.group);
+    }
+
+    pool_wait(pl.pool, &pl.group);
+    pool_destroy(pl.pool);
+
+    free(batches);
+    free(small);
+    free(jobs);
+    free(pl.vertex_to_class);
+    free(pl.index_in_class);
+    return results;
+}
+
+void freeClassResults(t_class_result *results, int nb_classes)
+{
+    if (!results) return;
+    for (int ci = 0; ci < nb_classes; ++ci) {
+        free(results[ci].distribution);
+        freeCyclicAnalysis(&results[ci].cyclic);
+    }
+    free(results);
+}
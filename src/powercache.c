@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "powercache.h"
+#include "utils.h"
+
+static size_t matrix_bytes(const t_matrix *M)
+{
+    return (size_t)M->rows * (size_t)M->cols * sizeof(float);
+}
+
+void initPowerCache(t_power_cache *cache, const t_matrix *M, size_t max_bytes)
+{
+    cache->base = M;
+    cache->size = 0;
+    cache->capacity = 4;
+    cache->entries = malloc(sizeof(t_power_entry *) * (size_t)cache->capacity);
+    if (!cache->entries) {
+        perror("malloc power cache");
+        exit(EXIT_FAILURE);
+    }
+    cache->max_bytes = max_bytes;
+    cache->bytes = 0;
+    cache->clock = 0;
+    cache->multiplications = 0;
+}
+
+void freePowerCache(t_power_cache *cache)
+{
+    if (!cache || !cache->entries) return;
+    for (int i = 0; i < cache->size; ++i) {
+        freeMatrix(&cache->entries[i]->m);
+        free(cache->entries[i]);
+    }
+    free(cache->entries);
+    cache->entries = NULL;
+    cache->size = cache->capacity = 0;
+    cache->bytes = 0;
+}
+
+static t_power_entry *find_entry(t_power_cache *cache, int k)
+{
+    for (int i = 0; i < cache->size; ++i) {
+        if (cache->entries[i]->exponent == k) {
+            cache->entries[i]->last_use = ++cache->clock;
+            return cache->entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void evict_if_needed(t_power_cache *cache)
+{
+    while (cache->max_bytes > 0 && cache->bytes > cache->max_bytes) {
+        int victim = -1;
+        for (int i = 0; i < cache->size; ++i) {
+            if (cache->entries[i]->pinned) continue;
+            if (victim < 0 || cache->entries[i]->last_use < cache->entries[victim]->last_use) {
+                victim = i;
+            }
+        }
+        if (victim < 0) return;
+        cache->bytes -= matrix_bytes(&cache->entries[victim]->m);
+        freeMatrix(&cache->entries[victim]->m);
+        free(cache->entries[victim]);
+        cache->entries[victim] = cache->entries[--cache->size];
+    }
+}
+
+/* Prend possession de m. L'entrée renvoyée est épinglée. */
+static t_power_entry *insert_entry(t_power_cache *cache, int k, t_matrix m)
+{
+    if (cache->size >= cache->capacity) {
+        cache->capacity *= 2;
+        t_power_entry **tmp = realloc(cache->entries, sizeof(t_power_entry *) * (size_t)cache->capacity);
+        if (!tmp) {
+            perror("realloc power cache");
+            exit(EXIT_FAILURE);
+        }
+        cache->entries = tmp;
+    }
+    t_power_entry *e = malloc(sizeof(t_power_entry));
+    if (!e) {
+        perror("malloc power entry");
+        exit(EXIT_FAILURE);
+    }
+    e->exponent = k;
+    e->m = m;
+    e->pinned = 1;
+    e->last_use = ++cache->clock;
+    cache->entries[cache->size++] = e;
+    cache->bytes += matrix_bytes(&m);
+    evict_if_needed(cache);
+    return e;
+}
+
+/* Les produits passent par multiply_rows (multiplyMatrixView), qui saute les
+ * coefficients nuls ; même ordre de sommation que multiplyMatrices. */
+
+/* Renvoie M^(2^i), épinglé, en calculant les carrés manquants. M^1 n'est pas stocké. */
+static const t_matrix *get_square(t_power_cache *cache, int i, t_power_entry **pinned)
+{
+    *pinned = NULL;
+    if (i == 0) return cache->base;
+    t_power_entry *e = find_entry(cache, 1 << i);
+    if (e) {
+        e->pinned = 1;
+        *pinned = e;
+        return &e->m;
+    }
+    t_power_entry *half_entry;
+    const t_matrix *half = get_square(cache, i - 1, &half_entry);
+    t_matrix sq = createEmptyMatrix(cache->base->rows);
+    t_matrix_view half_view = fullMatrixView(half);
+    multiplyMatrixView(half, &half_view, &sq);
+    cache->multiplications++;
+    if (half_entry) half_entry->pinned = 0;
+    *pinned = insert_entry(cache, 1 << i, sq);
+    return &(*pinned)->m;
+}
+
+t_matrix powerCacheGet(t_power_cache *cache, int k)
+{
+    int n = cache->base->rows;
+    t_matrix result = createEmptyMatrix(n);
+    if (k <= 0) {
+        for (int i = 0; i < n; ++i) {
+            result.data[i][i] = 1.0f;
+        }
+        return result;
+    }
+
+    /* Point de départ : la plus grande puissance connue <= k. */
+    int start = 1;
+    t_power_entry *best = NULL;
+    for (int i = 0; i < cache->size; ++i) {
+        int e = cache->entries[i]->exponent;
+        if (e <= k && e > start) {
+            start = e;
+            best = cache->entries[i];
+        }
+    }
+    if (best) {
+        best->last_use = ++cache->clock;
+        copyMatrix(&result, &best->m);
+    } else {
+        copyMatrix(&result, cache->base);
+    }
+    if (start == k) return result;
+
+    t_matrix tmp = createEmptyMatrix(n);
+    int rest = k - start;
+    for (int bit = 0; rest > 0; ++bit, rest >>= 1) {
+        if (!(rest & 1)) continue;
+        t_power_entry *sq_entry;
+        const t_matrix *sq = get_square(cache, bit, &sq_entry);
+        t_matrix_view sq_view = fullMatrixView(sq);
+        multiplyMatrixView(&result, &sq_view, &tmp);
+        cache->multiplications++;
+        if (sq_entry) sq_entry->pinned = 0;
+        t_matrix sw = result;
+        result = tmp;
+        tmp = sw;
+    }
+    freeMatrix(&tmp);
+
+    if (!find_entry(cache, k)) {
+        t_matrix keep = createEmptyMatrix(n);
+        copyMatrix(&keep, &result);
+        insert_entry(cache, k, keep)->pinned = 0;
+    }
+    return result;
+}
@@ -0,0 +1,295 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "reorder.h"
+#include "utils.h"
+
+/* Voisinage non orienté restreint aux arcs internes à une classe (format CSR). */
+typedef struct {
+    int *xadj;
+    int *adj;
+} t_class_adjacency;
+
+static t_class_adjacency build_class_adjacency(const t_graph *g, const int *vertex_to_class)
+{
+    int n = g->nb_vertices;
+    t_class_adjacency A;
+    A.xadj = calloc_int_array(n + 1);
+    for (int u = 0; u < n; ++u) {
+        for (t_arc *cur = g->array[u].head; cur; cur = cur->next) {
+            int v = cur->dest - 1;
+            if (v == u || vertex_to_class[v] != vertex_to_class[u]) continue;
+            A.xadj[u + 1]++;
+            A.xadj[v + 1]++;
+        }
+    }
+    for (int u = 0; u < n; ++u) {
+        A.xadj[u + 1] += A.xadj[u];
+    }
+    A.adj = calloc_int_array(A.xadj[n] > 0 ? A.xadj[n] : 1);
+    int *fill = calloc_int_array(n > 0 ? n : 1);
+    for (int u = 0; u < n; ++u) {
+        fill[u] = A.xadj[u];
+    }
+    for (int u = 0; u < n; ++u) {
+        for (t_arc *cur = g->array[u].head; cur; cur = cur->next) {
+            int v = cur->dest - 1;
+            if (v == u || vertex_to_class[v] != vertex_to_class[u]) continue;
+            A.adj[fill[u]++] = v;
+            A.adj[fill[v]++] = u;
+        }
+    }
+    free(fill);
+    return A;
+}
+
+static int compare_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* Sommet de la file de Cuthill-McKee avec sa clé de tri. */
+typedef struct {
+    int degree;
+    int vertex;
+} t_degree_key;
+
+static int compare_degree_keys(const void *a, const void *b)
+{
+    const t_degree_key *x = a, *y = b;
+    if (x->degree != y->degree) return (x->degree > y->degree) - (x->degree < y->degree);
+    return (x->vertex > y->vertex) - (x->vertex < y->vertex);
+}
+
+/* Trie les sommets a[0..k) par degré croissant (puis identifiant) ; keys : k cases de travail. */
+static void sort_by_degree(int *a, int k, const int *degree, t_degree_key *keys)
+{
+    if (k < 2) return;
+    for (int i = 0; i < k; ++i) {
+        keys[i].degree = degree[a[i]];
+        keys[i].vertex = a[i];
+    }
+    qsort(keys, (size_t)k, sizeof(t_degree_key), compare_degree_keys);
+    for (int i = 0; i < k; ++i) {
+        a[i] = keys[i].vertex;
+    }
+}
+
+/* Cuthill-McKee inverse sur les sommets (0..n-1) d'une classe ; écrit l'ordre dans out. */
+static void rcm_class(const t_class *c, const t_class_adjacency *A, const int *degree,
+                      int *visited, int *out, t_degree_key *keys)
+{
+    int k = c->size;
+    int head = 0, tail = 0;
+    while (tail < k) {
+        /* Nouvelle racine : sommet non visité de degré minimal. */
+        int root = -1;
+        for (int i = 0; i < k; ++i) {
+            int v = c->vertices[i] - 1;
+            if (visited[v]) continue;
+            if (root < 0 || degree[v] < degree[root] || (degree[v] == degree[root] && v < root)) {
+                root = v;
+            }
+        }
+        visited[root] = 1;
+        out[tail++] = root;
+        while (head < tail) {
+            int u = out[head++];
+            int first = tail;
+            for (int e = A->xadj[u]; e < A->xadj[u + 1]; ++e) {
+                int v = A->adj[e];
+                if (visited[v]) continue;
+                visited[v] = 1;
+                out[tail++] = v;
+            }
+            sort_by_degree(out + first, tail - first, degree, keys);
+        }
+    }
+    for (int i = 0; i < k / 2; ++i) {
+        int t = out[i];
+        out[i] = out[k - 1 - i];
+        out[k - 1 - i] = t;
+    }
+}
+
+t_permutation blockTriangularOrder(const t_graph *g, const t_partition *part)
+{
+    int n = g->nb_vertices;
+    t_permutation p;
+    p.n = n;
+    p.order = calloc_int_array(n > 0 ? n : 1);
+    p.position = calloc_int_array(n > 0 ? n : 1);
+
+    int *vertex_to_class = buildVertexToClass(part, n);
+    t_class_adjacency A = build_class_adjacency(g, vertex_to_class);
+    int *degree = calloc_int_array(n > 0 ? n : 1);
+    for (int u = 0; u < n; ++u) {
+        degree[u] = A.xadj[u + 1] - A.xadj[u];
+    }
+    int *visited = calloc_int_array(n > 0 ? n : 1);
+    int *local = calloc_int_array(n > 0 ? n : 1);
+    t_degree_key *keys = malloc(sizeof(t_degree_key) * (size_t)(n > 0 ? n : 1));
+    if (!keys) {
+        perror("malloc degree keys");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Tarjan produit les classes puits d'abord : on les parcourt à l'envers. */
+    int pos = 0;
+    for (int ci = part->size - 1; ci >= 0; --ci) {
+        const t_class *c = &part->classes[ci];
+        rcm_class(c, &A, degree, visited, local, keys);
+        for (int i = 0; i < c->size; ++i) {
+            p.order[pos] = local[i] + 1;
+            p.position[local[i]] = pos + 1;
+            pos++;
+        }
+    }
+
+    free(keys);
+    free(local);
+    free(visited);
+    free(degree);
+    free(A.xadj);
+    free(A.adj);
+    free(vertex_to_class);
+    return p;
+}
+
+void freePermutation(t_permutation *p)
+{
+    if (!p) return;
+    free(p->order);
+    free(p->position);
+    p->order = NULL;
+    p->position = NULL;
+    p->n = 0;
+}
+
+t_graph *permuteGraph(const t_graph *g, const t_permutation *p)
+{
+    t_graph *pg = createGraph(g->nb_vertices);
+    for (int i = 0; i < p->n; ++i) {
+        int u = p->order[i] - 1;
+        for (t_arc *cur = g->array[u].head; cur; cur = cur->next) {
+            addArc(pg, i + 1, p->position[cur->dest - 1], cur->proba);
+        }
+        /* addArc insère en tête : la liste est retournée pour garder l'ordre d'origine. */
+        t_arc *prev = NULL, *cur = pg->array[i].head;
+        while (cur) {
+            t_arc *next = cur->next;
+            cur->next = prev;
+            prev = cur;
+            cur = next;
+        }
+        pg->array[i].head = prev;
+    }
+    return pg;
+}
+
+t_partition permutePartition(const t_partition *part, const t_permutation *p)
+{
+    t_partition q;
+    q.size = part->size;
+    q.capacity = part->size > 0 ? part->size : 1;
+    q.classes = malloc(sizeof(t_class) * (size_t)q.capacity);
+    if (!q.classes) {
+        perror("malloc permuted partition");
+        exit(EXIT_FAILURE);
+    }
+    for (int ci = 0; ci < part->size; ++ci) {
+        const t_class *c = &part->classes[ci];
+        t_class *d = &q.classes[ci];
+        memcpy(d->name, c->name, sizeof(d->name));
+        d->size = c->size;
+        d->capacity = c->size > 0 ? c->size : 1;
+        d->vertices = calloc_int_array(d->capacity);
+        for (int i = 0; i < c->size; ++i) {
+            d->vertices[i] = p->position[c->vertices[i] - 1];
+        }
+        qsort(d->vertices, (size_t)d->size, sizeof(int), compare_int);
+    }
+    return q;
+}
+
+t_absorption unpermuteAbsorption(const t_absorption *abs, const t_permutation *p)
+{
+    int *source = calloc_int_array(p->n > 0 ? p->n : 1);
+    for (int v = 0; v < p->n; ++v) {
+        source[v] = p->position[v] - 1;
+    }
+    t_absorption r = remapAbsorption(abs, p->n, source);
+    free(source);
+    return r;
+}
+
+/* Indice de l'état v (nouvel identifiant) dans la classe c triée par permutePartition. */
+static int index_in_sorted_class(const t_class *c, int v)
+{
+    const int *found = bsearch(&v, c->vertices, (size_t)c->size, sizeof(int), compare_int);
+    return found ? (int)(found - c->vertices) : 0;
+}
+
+int *permutedClassOrigins(const t_partition *part, const t_partition *ppart, const t_permutation *p)
+{
+    int *origin = calloc_int_array(part->size > 0 ? part->size : 1);
+    for (int ci = 0; ci < part->size; ++ci) {
+        const t_class *c = &part->classes[ci];
+        if (c->size > 0) origin[ci] = index_in_sorted_class(&ppart->classes[ci], p->position[c->vertices[0] - 1]);
+    }
+    return origin;
+}
+
+/* v[i] = v[map[i]] pour i < k ; tmp : k cases de travail. */
+static void gather_floats(float *v, const int *map, int k, float *tmp)
+{
+    if (!v) return;
+    for (int i = 0; i < k; ++i) {
+        tmp[i] = v[map[i]];
+    }
+    memcpy(v, tmp, sizeof(float) * (size_t)k);
+}
+
+static void gather_ints(int *v, const int *map, int k, int *tmp)
+{
+    if (!v) return;
+    for (int i = 0; i < k; ++i) {
+        tmp[i] = v[map[i]];
+    }
+    memcpy(v, tmp, sizeof(int) * (size_t)k);
+}
+
+void unpermuteClassResults(t_class_result *results, const t_partition *part,
+                           const t_partition *ppart, const t_permutation *p)
+{
+    int max_size = 1;
+    for (int ci = 0; ci < part->size; ++ci) {
+        if (part->classes[ci].size > max_size) max_size = part->classes[ci].size;
+    }
+    int *map = calloc_int_array(max_size);
+    int *itmp = calloc_int_array(max_size);
+    float *tmp = calloc_float_array(max_size);
+
+    for (int ci = 0; ci < part->size; ++ci) {
+        const t_class *c = &part->classes[ci];
+        t_class_result *res = &results[ci];
+        if (res->size != c->size) continue;
+        for (int i = 0; i < c->size; ++i) {
+            map[i] = index_in_sorted_class(&ppart->classes[ci], p->position[c->vertices[i] - 1]);
+        }
+        gather_floats(res->distribution, map, c->size, tmp);
+        t_cyclic_analysis *a = &res->cyclic;
+        if (a->size != c->size) continue;
+        gather_ints(a->phase, map, c->size, itmp);
+        gather_floats(a->cesaro, map, c->size, tmp);
+        if (!a->phase_limits) continue;
+        for (int s = 0; s < a->period; ++s) {
+            gather_floats(a->phase_limits[s], map, c->size, tmp);
+        }
+    }
+
+    free(tmp);
+    free(itmp);
+    free(map);
+}
@@ -0,0 +1,614 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "server.h"
+#include "markov.h"
+#include "threadpool.h"
+
+#define MODEL_NAME_MAX 64
+#define SERVER_BACKLOG 16
+#define CLIENT_READ_BYTES 4096
+#define SERVER_MAX_STEPS 10000      /* borne de k pour KSTEP */
+
+/**
+ * @brief Chaîne chargée : contexte dont les résultats utiles aux requêtes sont
+ * calculés au chargement (lecture seule ensuite). La liste des chaînes en
+ * détient une référence, chaque requête en cours une autre : une chaîne
+ * retirée est libérée par la dernière requête qui la lit.
+ */
+typedef struct s_model {
+    char name[MODEL_NAME_MAX];
+    t_markov_context *ctx;
+    t_markov_summary summary;
+    int refs;
+    struct s_model *next;
+} t_model;
+
+typedef struct {
+    t_model *models;
+    pthread_rwlock_t lock;      /**< Lecture : recherche d'une chaîne ; écriture : publication et retrait. */
+    pthread_mutex_t state_lock; /**< Protège stopping et l'état busy des clients. */
+    int listen_fd;
+    int wake[2];                /**< Tube qui réveille la boucle principale à la fin d'une requête. */
+    int stopping;
+} t_server;
+
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t cap;
+} t_reply;
+
+/**
+ * @brief Connexion : octets reçus en attente de traitement. Une seule requête
+ * par connexion est confiée au pool à la fois (les réponses restent dans
+ * l'ordre) ; pendant ce temps la boucle principale ne lit plus la socket.
+ */
+typedef struct s_client {
+    t_server *server;
+    int fd;
+    char *in;
+    size_t in_len;
+    size_t in_cap;
+    int eof;                    /**< Le client a fermé son côté de la connexion. */
+    int busy;                   /**< Requête en cours dans le pool. */
+    int closing;                /**< QUIT, SHUTDOWN ou erreur d'envoi : à fermer. */
+    t_reply reply;
+    struct s_client *next;
+} t_client;
+
+/* ================= Chaînes ================= */
+
+static void free_model(t_model *m)
+{
+    if (!m) return;
+    markovFree(m->ctx);
+    free(m);
+}
+
+static void free_models(t_model *m)
+{
+    while (m) {
+        t_model *next = m->next;
+        free_model(m);
+        m = next;
+    }
+}
+
+static void release_model(t_model *m)
+{
+    if (m && __atomic_sub_fetch(&m->refs, 1, __ATOMIC_ACQ_REL) == 0) free_model(m);
+}
+
+/* Lecture et analyse complète, sans verrou : les requêtes en cours continuent. */
+static t_model *load_model(const char *name, const char *filename)
+{
+    t_markov_context *ctx = markovCreate();
+    if (!markovLoadFile(ctx, filename, 0)) {
+        markovFree(ctx);
+        return NULL;
+    }
+
+    t_model *m = calloc(1, sizeof(t_model));
+    if (!m) {
+        perror("calloc model");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(m->name, sizeof(m->name), "%s", name);
+    m->ctx = ctx;
+    m->refs = 1;
+    markovPrepare(ctx, MARKOV_CLASSES | MARKOV_STATIONARY | MARKOV_ABSORPTION | MARKOV_CSR);
+    markovSummary(ctx, &m->summary);
+    return m;
+}
+
+/* Appelée sous verrou (lecture ou écriture). */
+static t_model *find_model(t_server *s, const char *name)
+{
+    for (t_model *m = s->models; m; m = m->next) {
+        if (strcmp(m->name, name) == 0) return m;
+    }
+    return NULL;
+}
+
+/* Prend une référence sur la chaîne name (NULL si inconnue) ; le verrou n'est
+ * tenu que le temps de la recherche. À rendre avec release_model. */
+static t_model *acquire_model(t_server *s, const char *name)
+{
+    pthread_rwlock_rdlock(&s->lock);
+    t_model *m = find_model(s, name);
+    if (m) __atomic_add_fetch(&m->refs, 1, __ATOMIC_RELAXED);
+    pthread_rwlock_unlock(&s->lock);
+    return m;
+}
+
+/* Publie m (remplace une chaîne de même nom) ; renvoie l'ancienne, à rendre avec release_model. */
+static t_model *publish_model(t_server *s, t_model *m)
+{
+    pthread_rwlock_wrlock(&s->lock);
+    t_model **link = &s->models;
+    while (*link && strcmp((*link)->name, m->name) != 0) link = &(*link)->next;
+    t_model *old = *link;
+    m->next = old ? old->next : NULL;
+    *link = m;
+    pthread_rwlock_unlock(&s->lock);
+    return old;
+}
+
+static t_model *remove_model(t_server *s, const char *name)
+{
+    pthread_rwlock_wrlock(&s->lock);
+    t_model **link = &s->models;
+    while (*link && strcmp((*link)->name, name) != 0) link = &(*link)->next;
+    t_model *old = *link;
+    if (old) *link = old->next;
+    pthread_rwlock_unlock(&s->lock);
+    return old;
+}
+
+/* ================= Réponses ================= */
+
+static void reply_printf(t_reply *r, const char *fmt, ...)
+{
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(r->buf + r->len, r->cap - r->len, fmt, ap);
+        va_end(ap);
+        if (n < 0) return;
+        if ((size_t)n < r->cap - r->len) {
+            r->len += (size_t)n;
+            return;
+        }
+        size_t cap = 2 * r->cap + (size_t)n;
+        char *buf = realloc(r->buf, cap);
+        if (!buf) {
+            perror("realloc reply");
+            exit(EXIT_FAILURE);
+        }
+        r->buf = buf;
+        r->cap = cap;
+    }
+}
+
+static int send_all(int fd, const char *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+        if (n <= 0) return 0;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 1;
+}
+
+/* ================= Requêtes ================= */
+
+/* Lit l'état (1..n) du jeton tok ; 0 s'il est invalide. */
+static int parse_state(const t_model *m, const char *tok)
+{
+    if (!tok) return 0;
+    char *end;
+    long v = strtol(tok, &end, 10);
+    if (*end || v < 1 || v > m->summary.nb_vertices) return 0;
+    return (int)v;
+}
+
+static void query_info(const t_model *m, t_reply *r)
+{
+    const t_markov_summary *s = &m->summary;
+    reply_printf(r, "OK etats=%d arcs=%d markov=%d classes=%d transitoires=%d irreductible=%d\n",
+                 s->nb_vertices, s->nb_arcs, s->valid, s->nb_classes, s->nb_transient,
+                 s->irreducible);
+}
+
+static void query_class(const t_model *m, int v, t_reply *r)
+{
+    int ci = markovVertexClass(m->ctx)[v - 1];
+    t_class_kind kind = markovClassKinds(m->ctx)[ci];
+    const char *label = kind == CLASS_TRANSIENT ? "transitoire" : kind == CLASS_ABSORBING ? "absorbant" : "persistante";
+    reply_printf(r, "OK %s %s\n", markovPartition(m->ctx)->classes[ci].name, label);
+}
+
+static void query_stationary(const t_model *m, int v, t_reply *r)
+{
+    reply_printf(r, "OK %.6g\n", markovStationaryAt(m->ctx, v));
+}
+
+/* Un seul thread par requête : les requêtes sont déjà réparties sur le pool du serveur. */
+static void query_kstep(const t_model *m, int v, int k, t_reply *r)
+{
+    int n = m->summary.nb_vertices;
+    float *initial = calloc((size_t)n, sizeof(float));
+    if (!initial) {
+        perror("calloc kstep");
+        exit(EXIT_FAILURE);
+    }
+    initial[v - 1] = 1.0f;
+    t_kstep_result res = markovBatchDistributions(m->ctx, initial, 1, &k, 1, 1);
+    reply_printf(r, "OK");
+    for (int i = 0; i < n; ++i) {
+        if (res.distributions[0][i] != 0.0f) reply_printf(r, " %d:%.6g", i + 1, res.distributions[0][i]);
+    }
+    reply_printf(r, "\n");
+    freeKStepResult(&res);
+    free(initial);
+}
+
+static void query_absorb(const t_model *m, int v, t_reply *r)
+{
+    const t_absorption *abs = markovAbsorption(m->ctx);
+    const t_partition *part = markovPartition(m->ctx);
+    reply_printf(r, "OK pas=%.6g", abs->expected_steps[v - 1]);
+    for (size_t e = abs->row_start[v - 1]; e < abs->row_start[v - 1] + (size_t)abs->row_size[v - 1]; ++e) {
+        reply_printf(r, " %s:%.6g", part->classes[abs->persistent_classes[abs->columns[e]]].name,
+                     abs->values[e]);
+    }
+    reply_printf(r, "\n");
+}
+
+/* Requêtes de lecture : la chaîne est tenue par une référence, sans verrou
+ * pendant le calcul (un KSTEP long ne retarde ni LOAD ni UNLOAD). */
+static void answer_query(t_server *s, const char *cmd, char **save, t_reply *r)
+{
+    const char *name = strtok_r(NULL, " \t\r\n", save);
+    if (!name) {
+        reply_printf(r, "ERR nom de chaine manquant\n");
+        return;
+    }
+    const char *arg1 = strtok_r(NULL, " \t\r\n", save);
+    const char *arg2 = strtok_r(NULL, " \t\r\n", save);
+
+    t_model *m = acquire_model(s, name);
+    if (!m) {
+        reply_printf(r, "ERR chaine inconnue : %s\n", name);
+        return;
+    }
+    if (strcmp(cmd, "INFO") == 0) {
+        query_info(m, r);
+    } else {
+        int v = parse_state(m, arg1);
+        if (!v) {
+            reply_printf(r, "ERR etat invalide\n");
+        } else if (strcmp(cmd, "CLASS") == 0) {
+            query_class(m, v, r);
+        } else if (strcmp(cmd, "STATIONARY") == 0) {
+            query_stationary(m, v, r);
+        } else if (strcmp(cmd, "ABSORB") == 0) {
+            query_absorb(m, v, r);
+        } else {
+            char *end = NULL;
+            long k = arg2 ? strtol(arg2, &end, 10) : -1;
+            if (k < 0 || (end && *end)) reply_printf(r, "ERR nombre de pas invalide\n");
+            else if (k > SERVER_MAX_STEPS) reply_printf(r, "ERR nombre de pas trop grand (max %d)\n", SERVER_MAX_STEPS);
+            else query_kstep(m, v, (int)k, r);
+        }
+    }
+    release_model(m);
+}
+
+static void wake_server(t_server *s)
+{
+    if (write(s->wake[1], "", 1) < 0) perror("write wake");
+}
+
+static void stop_server(t_server *s)
+{
+    pthread_mutex_lock(&s->state_lock);
+    s->stopping = 1;
+    pthread_mutex_unlock(&s->state_lock);
+}
+
+/* Traite une ligne ; renvoie 0 si la connexion doit être fermée. */
+static int handle_line(t_server *s, char *line, t_reply *r)
+{
+    char *save = NULL;
+    const char *cmd = strtok_r(line, " \t\r\n", &save);
+    if (!cmd) return 1;
+
+    if (strcmp(cmd, "QUIT") == 0) return 0;
+    if (strcmp(cmd, "SHUTDOWN") == 0) {
+        stop_server(s);
+        reply_printf(r, "OK\n");
+        return 0;
+    }
+    if (strcmp(cmd, "LIST") == 0) {
+        reply_printf(r, "OK");
+        pthread_rwlock_rdlock(&s->lock);
+        for (const t_model *m = s->models; m; m = m->next) {
+            reply_printf(r, " %s", m->name);
+        }
+        pthread_rwlock_unlock(&s->lock);
+        reply_printf(r, "\n");
+        return 1;
+    }
+    if (strcmp(cmd, "LOAD") == 0) {
+        const char *name = strtok_r(NULL, " \t\r\n", &save);
+        const char *file = strtok_r(NULL, "\r\n", &save);
+        if (!name || !file || strlen(name) >= MODEL_NAME_MAX) {
+            reply_printf(r, "ERR usage : LOAD nom fichier\n");
+            return 1;
+        }
+        while (*file == ' ' || *file == '\t') file++;
+        t_model *m = load_model(name, file);
+        if (!m) {
+            reply_printf(r, "ERR lecture impossible : %s\n", file);
+            return 1;
+        }
+        int n = m->summary.nb_vertices, nb_classes = m->summary.nb_classes;
+        release_model(publish_model(s, m));
+        reply_printf(r, "OK %s %d %d\n", name, n, nb_classes);
+        return 1;
+    }
+    if (strcmp(cmd, "UNLOAD") == 0) {
+        const char *name = strtok_r(NULL, " \t\r\n", &save);
+        t_model *old = name ? remove_model(s, name) : NULL;
+        if (!old) {
+            reply_printf(r, "ERR chaine inconnue : %s\n", name ? name : "");
+            return 1;
+        }
+        release_model(old);
+        reply_printf(r, "OK\n");
+        return 1;
+    }
+    if (strcmp(cmd, "INFO") == 0 || strcmp(cmd, "CLASS") == 0 || strcmp(cmd, "STATIONARY") == 0
+        || strcmp(cmd, "KSTEP") == 0 || strcmp(cmd, "ABSORB") == 0) {
+        answer_query(s, cmd, &save, r);
+        return 1;
+    }
+    reply_printf(r, "ERR commande inconnue : %s\n", cmd);
+    return 1;
+}
+
+/* Longueur de la première ligne complète de client->in (fin de ligne comprise),
+ * 0 s'il n'y en a pas ; après la fermeture par le client, le reste compte pour une ligne. */
+static size_t pending_line(const t_client *c)
+{
+    const char *nl = memchr(c->in, '\n', c->in_len);
+    if (nl) return (size_t)(nl - c->in) + 1;
+    return c->eof ? c->in_len : 0;
+}
+
+/* Une requête : la première ligne reçue du client. */
+static void request_task(void *arg)
+{
+    t_client *c = arg;
+    size_t len = pending_line(c);
+    char *line = malloc(len + 1);
+    if (!line) {
+        perror("malloc request");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(line, c->in, len);
+    line[len] = '\0';
+    c->in_len -= len;
+    memmove(c->in, c->in + len, c->in_len);
+
+    c->reply.len = 0;
+    int open = handle_line(c->server, line, &c->reply);
+    if (c->reply.len > 0 && !send_all(c->fd, c->reply.buf, c->reply.len)) open = 0;
+    free(line);
+
+    pthread_mutex_lock(&c->server->state_lock);
+    c->closing = !open;
+    c->busy = 0;
+    pthread_mutex_unlock(&c->server->state_lock);
+    wake_server(c->server);
+}
+
+static t_client *create_client(t_server *s, int fd)
+{
+    t_client *c = calloc(1, sizeof(t_client));
+    if (!c) {
+        perror("calloc client");
+        exit(EXIT_FAILURE);
+    }
+    c->server = s;
+    c->fd = fd;
+    c->in_cap = CLIENT_READ_BYTES;
+    c->in = malloc(c->in_cap);
+    c->reply.cap = 256;
+    c->reply.buf = malloc(c->reply.cap);
+    if (!c->in || !c->reply.buf) {
+        perror("malloc client");
+        exit(EXIT_FAILURE);
+    }
+    return c;
+}
+
+static void free_client(t_client *c)
+{
+    close(c->fd);
+    free(c->in);
+    free(c->reply.buf);
+    free(c);
+}
+
+/* Lit ce qui est disponible sur la socket ; marque eof à la fermeture. */
+static void read_client(t_client *c)
+{
+    if (c->in_cap - c->in_len < CLIENT_READ_BYTES) {
+        c->in_cap = 2 * c->in_cap + CLIENT_READ_BYTES;
+        char *in = realloc(c->in, c->in_cap);
+        if (!in) {
+            perror("realloc client");
+            exit(EXIT_FAILURE);
+        }
+        c->in = in;
+    }
+    ssize_t n = recv(c->fd, c->in + c->in_len, c->in_cap - c->in_len, 0);
+    if (n <= 0) c->eof = 1;
+    else c->in_len += (size_t)n;
+}
+
+/* ================= Boucle principale ================= */
+
+static int open_socket(const char *path)
+{
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Chemin de socket trop long : %s\n", path);
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, SERVER_BACKLOG) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void file_stem(const char *path, char *stem, size_t size)
+{
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    snprintf(stem, size, "%s", base);
+    char *dot = strrchr(stem, '.');
+    if (dot && dot != stem) *dot = '\0';
+}
+
+int runServer(const t_options *opt)
+{
+    t_server s;
+    s.models = NULL;
+    s.stopping = 0;
+    pthread_rwlock_init(&s.lock, NULL);
+    pthread_mutex_init(&s.state_lock, NULL);
+
+    if (opt->filename) {
+        char name[MODEL_NAME_MAX];
+        file_stem(opt->filename, name, sizeof(name));
+        t_model *m = load_model(name, opt->filename);
+        if (!m) return -1;
+        publish_model(&s, m);
+        fprintf(stderr, "Chaine %s chargee (%d etats, %d classes)\n",
+                name, m->summary.nb_vertices, m->summary.nb_classes);
+    }
+
+    s.listen_fd = open_socket(opt->serve);
+    if (s.listen_fd < 0 || pipe(s.wake) != 0) {
+        if (s.listen_fd >= 0) {
+            perror("pipe");
+            close(s.listen_fd);
+        }
+        free_models(s.models);
+        return -1;
+    }
+    fprintf(stderr, "En ecoute sur %s\n", opt->serve);
+
+    /* Boucle principale : attend les connexions et les requêtes des clients
+     * inactifs ; chaque ligne complète devient une tâche du pool. */
+    t_thread_pool *pool = pool_create(opt->jobs);
+    t_client *clients = NULL;
+    struct pollfd *fds = NULL;
+    t_client **polled = NULL;
+    int fds_cap = 0;
+    for (;;) {
+        pthread_mutex_lock(&s.state_lock);
+        int stopping = s.stopping;
+        pthread_mutex_unlock(&s.state_lock);
+        if (stopping) break;
+
+        /* Clients libres : fermeture, ou requête suivante déjà reçue. */
+        int nb_polled = 0;
+        for (t_client **link = &clients; *link;) {
+            t_client *c = *link;
+            pthread_mutex_lock(&s.state_lock);
+            int busy = c->busy;
+            pthread_mutex_unlock(&s.state_lock);
+            if (!busy && (c->closing || (c->eof && c->in_len == 0))) {
+                *link = c->next;
+                free_client(c);
+                continue;
+            }
+            if (!busy && pending_line(c) > 0) {
+                pthread_mutex_lock(&s.state_lock);
+                c->busy = busy = 1;
+                pthread_mutex_unlock(&s.state_lock);
+                pool_submit(pool, request_task, c, NULL);
+            }
+            if (!busy) nb_polled++;
+            link = &c->next;
+        }
+
+        if (nb_polled + 2 > fds_cap) {
+            fds_cap = 2 * (nb_polled + 2);
+            fds = realloc(fds, sizeof(struct pollfd) * (size_t)fds_cap);
+            polled = realloc(polled, sizeof(t_client *) * (size_t)fds_cap);
+            if (!fds || !polled) {
+                perror("realloc poll");
+                exit(EXIT_FAILURE);
+            }
+        }
+        fds[0].fd = s.listen_fd;
+        fds[1].fd = s.wake[0];
+        int nb_fds = 2;
+        for (t_client *c = clients; c; c = c->next) {
+            pthread_mutex_lock(&s.state_lock);
+            int busy = c->busy;
+            pthread_mutex_unlock(&s.state_lock);
+            if (busy) continue;
+            polled[nb_fds] = c;
+            fds[nb_fds++].fd = c->fd;
+        }
+        for (int i = 0; i < nb_fds; ++i) {
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+        if (poll(fds, (nfds_t)nb_fds, -1) < 0) {
+            perror("poll");
+            continue;
+        }
+
+        if (fds[1].revents) {
+            char drain[64];
+            if (read(s.wake[0], drain, sizeof(drain)) < 0) perror("read wake");
+        }
+        for (int i = 2; i < nb_fds; ++i) {
+            if (fds[i].revents) read_client(polled[i]);
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(s.listen_fd, NULL, NULL);
+            if (fd < 0) {
+                perror("accept");
+                continue;
+            }
+            t_client *c = create_client(&s, fd);
+            c->next = clients;
+            clients = c;
+        }
+    }
+    /* Les requêtes en cours se terminent ; les connexions ouvertes sont fermées. */
+    pool_destroy(pool);
+    while (clients) {
+        t_client *next = clients->next;
+        free_client(clients);
+        clients = next;
+    }
+    free(fds);
+    free(polled);
+    close(s.wake[0]);
+    close(s.wake[1]);
+
+    close(s.listen_fd);
+    unlink(opt->serve);
+    free_models(s.models);
+    pthread_mutex_destroy(&s.state_lock);
+    pthread_rwlock_destroy(&s.lock);
+    return 0;
+}
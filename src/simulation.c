@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simulation.h"
+#include "threadpool.h"
+#include "utils.h"
+
+#define WALKS_PER_TASK 4096
+
+/* ================= Tables d'alias ================= */
+
+t_alias_tables buildAliasTables(const t_graph *g)
+{
+    t_alias_tables t;
+    int n = g->nb_vertices;
+    t.n = n;
+    t.row_ptr = calloc_int_array(n + 1);
+
+    int total = 0;
+    int max_deg = 0;
+    for (int i = 0; i < n; ++i) {
+        int deg = 0;
+        for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
+            deg++;
+        }
+        t.row_ptr[i] = total;
+        total += deg;
+        if (deg > max_deg) max_deg = deg;
+    }
+    t.row_ptr[n] = total;
+
+    t.threshold = calloc_float_array(total > 0 ? total : 1);
+    t.dest = calloc_int_array(total > 0 ? total : 1);
+    t.alias = calloc_int_array(total > 0 ? total : 1);
+    double *scaled = calloc((size_t)(max_deg > 0 ? max_deg : 1), sizeof(double));
+    int *small = calloc_int_array(max_deg > 0 ? max_deg : 1);
+    int *large = calloc_int_array(max_deg > 0 ? max_deg : 1);
+    if (!scaled) {
+        perror("calloc alias scaled");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < n; ++i) {
+        int base = t.row_ptr[i];
+        int deg = t.row_ptr[i + 1] - base;
+        if (deg == 0) continue;
+
+        double sum = 0.0;
+        int k = 0;
+        for (t_arc *cur = g->array[i].head; cur; cur = cur->next, ++k) {
+            t.dest[base + k] = cur->dest - 1;
+            t.alias[base + k] = cur->dest - 1;
+            scaled[k] = cur->proba;
+            sum += cur->proba;
+        }
+
+        /* Vose : les colonnes sous la moyenne sont complétées par une colonne au-dessus. */
+        int nb_small = 0, nb_large = 0;
+        for (k = 0; k < deg; ++k) {
+            scaled[k] = sum > 0.0 ? scaled[k] * deg / sum : 1.0;
+            if (scaled[k] < 1.0) small[nb_small++] = k;
+            else large[nb_large++] = k;
+        }
+        while (nb_small > 0 && nb_large > 0) {
+            int s = small[--nb_small];
+            int l = large[--nb_large];
+            t.threshold[base + s] = (float)scaled[s];
+            t.alias[base + s] = t.dest[base + l];
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) small[nb_small++] = l;
+            else large[nb_large++] = l;
+        }
+        while (nb_large > 0) {
+            t.threshold[base + large[--nb_large]] = 1.0f;
+        }
+        while (nb_small > 0) {
+            t.threshold[base + small[--nb_small]] = 1.0f;
+        }
+    }
+
+    free(scaled);
+    free(small);
+    free(large);
+    return t;
+}
+
+void freeAliasTables(t_alias_tables *t)
+{
+    if (!t) return;
+    free(t->row_ptr);
+    free(t->threshold);
+    free(t->dest);
+    free(t->alias);
+    t->row_ptr = t->dest = t->alias = NULL;
+    t->threshold = NULL;
+    t->n = 0;
+}
+
+/* ================= Générateur à compteur ================= */
+
+static uint64_t mix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Tirage numéro counter du flux stream : fonction pure, sans état partagé. */
+static uint64_t counter_rng(uint64_t seed, uint64_t stream, uint64_t counter)
+{
+    uint64_t key = mix64(seed ^ mix64(stream + 0x9e3779b97f4a7c15ULL));
+    return mix64(key + counter * 0x9e3779b97f4a7c15ULL);
+}
+
+/* ================= Simulation ================= */
+
+typedef struct {
+    const t_alias_tables *tables;
+    const t_simulation_params *params;
+    long first;
+    long count;
+    int bin_width;
+    uint64_t *visits;
+    uint64_t *histogram;
+    uint64_t total_steps;
+    long nb_hits;
+    double sum_hitting;
+} t_walk_chunk;
+
+static int sample_next(const t_alias_tables *t, int state, uint64_t r)
+{
+    int base = t->row_ptr[state];
+    int deg = t->row_ptr[state + 1] - base;
+    int column = (int)(((r >> 32) * (uint64_t)deg) >> 32);
+    float u = (float)(r & 0xffffffu) / 16777216.0f;
+    return u < t->threshold[base + column] ? t->dest[base + column] : t->alias[base + column];
+}
+
+static void walk_task(void *arg)
+{
+    t_walk_chunk *c = arg;
+    const t_alias_tables *t = c->tables;
+    const t_simulation_params *p = c->params;
+
+    for (long w = c->first; w < c->first + c->count; ++w) {
+        int state = p->start - 1;
+        int hit = -1;
+        c->visits[state]++;
+        c->total_steps++;
+        if (p->targets && p->targets[state]) hit = 0;
+
+        for (int step = 1; step <= p->max_steps; ++step) {
+            if (hit >= 0 && p->stop_on_hit) break;
+            if (t->row_ptr[state + 1] == t->row_ptr[state]) break;
+            state = sample_next(t, state, counter_rng(p->seed, (uint64_t)w, (uint64_t)step));
+            c->visits[state]++;
+            c->total_steps++;
+            if (hit < 0 && p->targets && p->targets[state]) hit = step;
+        }
+
+        if (hit >= 0) {
+            int bin = hit / c->bin_width;
+            if (bin >= p->nb_bins) bin = p->nb_bins - 1;
+            c->histogram[bin]++;
+            c->nb_hits++;
+            c->sum_hitting += hit;
+        }
+    }
+}
+
+t_simulation_result simulateWalks(const t_alias_tables *tables, const t_simulation_params *params)
+{
+    t_simulation_result res;
+    int n = tables->n;
+    res.n = n;
+    res.nb_walks = params->nb_walks;
+    res.nb_bins = params->nb_bins > 0 ? params->nb_bins : 1;
+    res.bin_width = (params->max_steps + res.nb_bins - 1) / res.nb_bins;
+    if (res.bin_width < 1) res.bin_width = 1;
+    res.visits = calloc((size_t)(n > 0 ? n : 1), sizeof(uint64_t));
+    res.histogram = calloc((size_t)res.nb_bins, sizeof(uint64_t));
+    res.total_steps = 0;
+    res.nb_hits = 0;
+    res.mean_hitting_time = 0.0;
+    if (!res.visits || !res.histogram) {
+        perror("calloc simulation result");
+        exit(EXIT_FAILURE);
+    }
+    if (params->start < 1 || params->start > n || params->nb_walks <= 0) return res;
+
+    t_simulation_params p = *params;
+    p.nb_bins = res.nb_bins;
+
+    long nb_chunks = (params->nb_walks + WALKS_PER_TASK - 1) / WALKS_PER_TASK;
+    t_thread_pool *pool = pool_create(params->nb_threads);
+    if (nb_chunks > 4L * pool_size(pool)) nb_chunks = 4L * pool_size(pool);
+    long per_chunk = (params->nb_walks + nb_chunks - 1) / nb_chunks;
+
+    t_walk_chunk *chunks = calloc((size_t)nb_chunks, sizeof(t_walk_chunk));
+    if (!chunks) {
+        perror("calloc walk chunks");
+        exit(EXIT_FAILURE);
+    }
+    t_task_group group = {0};
+    for (long c = 0; c < nb_chunks; ++c) {
+        chunks[c].tables = tables;
+        chunks[c].params = &p;
+        chunks[c].first = c * per_chunk;
+        chunks[c].count = params->nb_walks - chunks[c].first < per_chunk
+                          ? params->nb_walks - chunks[c].first : per_chunk;
+        if (chunks[c].count < 0) chunks[c].count = 0;
+        chunks[c].bin_width = res.bin_width;
+        chunks[c].visits = calloc((size_t)(n > 0 ? n : 1), sizeof(uint64_t));
+        chunks[c].histogram = calloc((size_t)res.nb_bins, sizeof(uint64_t));
+        if (!chunks[c].visits || !chunks[c].histogram) {
+            perror("calloc walk counters");
+            exit(EXIT_FAILURE);
+        }
+        pool_submit(pool, walk_task, &chunks[c], &group);
+    }
+    pool_wait(pool, &group);
+    pool_destroy(pool);
+
+    double sum_hitting = 0.0;
+    for (long c = 0; c < nb_chunks; ++c) {
+        for (int v = 0; v < n; ++v) {
+            res.visits[v] += chunks[c].visits[v];
+        }
+        for (int b = 0; b < res.nb_bins; ++b) {
+            res.histogram[b] += chunks[c].histogram[b];
+        }
+        res.total_steps += chunks[c].total_steps;
+        res.nb_hits += chunks[c].nb_hits;
+        sum_hitting += chunks[c].sum_hitting;
+        free(chunks[c].visits);
+        free(chunks[c].histogram);
+    }
+    free(chunks);
+    if (res.nb_hits > 0) res.mean_hitting_time = sum_hitting / (double)res.nb_hits;
+    return res;
+}
+
+void freeSimulationResult(t_simulation_result *res)
+{
+    if (!res) return;
+    free(res->visits);
+    free(res->histogram);
+    res->visits = NULL;
+    res->histogram = NULL;
+    res->n = 0;
+}
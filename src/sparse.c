@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "sparse.h"
+#include "utils.h"
+
+static void csr_alloc(t_csr_matrix *A, int n, int nnz)
+{
+    A->n = n;
+    A->nnz = nnz;
+    A->row_ptr = calloc_int_array(n + 1);
+    A->col_idx = calloc_int_array(nnz > 0 ? nnz : 1);
+    A->values = calloc_float_array(nnz > 0 ? nnz : 1);
+}
+
+t_csr_matrix csrFromGraph(const t_graph *g)
+{
+    int n = g->nb_vertices;
+    int nnz = 0;
+    for (int i = 0; i < n; ++i) {
+        for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
+            nnz++;
+        }
+    }
+
+    t_csr_matrix A;
+    csr_alloc(&A, n, nnz);
+    int pos = 0;
+    for (int i = 0; i < n; ++i) {
+        A.row_ptr[i] = pos;
+        for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
+            A.col_idx[pos] = cur->dest - 1;
+            A.values[pos] = cur->proba;
+            pos++;
+        }
+    }
+    A.row_ptr[n] = pos;
+    return A;
+}
+
+t_csr_matrix csrFromView(const t_matrix_view *V)
+{
+    int n = V->size;
+    int nnz = 0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            if (viewAt(V, i, j) != 0.0f) nnz++;
+        }
+    }
+
+    t_csr_matrix A;
+    csr_alloc(&A, n, nnz);
+    int pos = 0;
+    for (int i = 0; i < n; ++i) {
+        A.row_ptr[i] = pos;
+        for (int j = 0; j < n; ++j) {
+            float v = viewAt(V, i, j);
+            if (v == 0.0f) continue;
+            A.col_idx[pos] = j;
+            A.values[pos] = v;
+            pos++;
+        }
+    }
+    A.row_ptr[n] = pos;
+    return A;
+}
+
+void freeCsr(t_csr_matrix *A)
+{
+    if (!A) return;
+    free(A->row_ptr);
+    free(A->col_idx);
+    free(A->values);
+    A->row_ptr = NULL;
+    A->col_idx = NULL;
+    A->values = NULL;
+    A->n = A->nnz = 0;
+}
+
+void csrLeftMultiply(const double *x, const t_csr_matrix *A, double *y)
+{
+    for (int j = 0; j < A->n; ++j) {
+        y[j] = 0.0;
+    }
+    for (int i = 0; i < A->n; ++i) {
+        double xi = x[i];
+        if (xi == 0.0) continue;
+        for (int p = A->row_ptr[i]; p < A->row_ptr[i + 1]; ++p) {
+            y[A->col_idx[p]] += xi * (double)A->values[p];
+        }
+    }
+}
+
+void csrRightMultiply(const t_csr_matrix *A, const double *x, double *y)
+{
+    for (int i = 0; i < A->n; ++i) {
+        double sum = 0.0;
+        for (int p = A->row_ptr[i]; p < A->row_ptr[i + 1]; ++p) {
+            sum += (double)A->values[p] * x[A->col_idx[p]];
+        }
+        y[i] = sum;
+    }
+}
+
+t_csr_matrix csrTranspose(const t_csr_matrix *A)
+{
+    int n = A->n;
+    t_csr_matrix T;
+    csr_alloc(&T, n, A->nnz);
+
+    for (int p = 0; p < A->nnz; ++p) {
+        T.row_ptr[A->col_idx[p] + 1]++;
+    }
+    for (int j = 0; j < n; ++j) {
+        T.row_ptr[j + 1] += T.row_ptr[j];
+    }
+    int *fill = calloc_int_array(n > 0 ? n : 1);
+    for (int i = 0; i < n; ++i) {
+        for (int p = A->row_ptr[i]; p < A->row_ptr[i + 1]; ++p) {
+            int j = A->col_idx[p];
+            int dst = T.row_ptr[j] + fill[j]++;
+            T.col_idx[dst] = i;
+            T.values[dst] = A->values[p];
+        }
+    }
+    free(fill);
+    return T;
+}
+
+void csrBlockMultiply(const float *X, int batch, const t_csr_matrix *AT, float *Y,
+                      int col_begin, int col_end)
+{
+    for (int j = col_begin; j < col_end; ++j) {
+        float *y = &Y[(size_t)j * (size_t)batch];
+        for (int b = 0; b < batch; ++b) {
+            y[b] = 0.0f;
+        }
+        for (int p = AT->row_ptr[j]; p < AT->row_ptr[j + 1]; ++p) {
+            float a = AT->values[p];
+            const float *x = &X[(size_t)AT->col_idx[p] * (size_t)batch];
+            for (int b = 0; b < batch; ++b) {
+                y[b] += a * x[b];
+            }
+        }
+    }
+}
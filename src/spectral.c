@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "spectral.h"
+
+#define DEFLATION_WINDOW 8      /* nombre de rapports moyennés pour lambda2 */
+#define STOCHASTIC_TOL 1e-6
+
+static double *alloc_vector(int n)
+{
+    double *v = calloc((size_t)(n > 0 ? n : 1), sizeof(double));
+    if (!v) {
+        perror("calloc spectral vector");
+        exit(EXIT_FAILURE);
+    }
+    return v;
+}
+
+static double norm1(const double *x, int n)
+{
+    double s = 0.0;
+    for (int i = 0; i < n; ++i) {
+        s += fabs(x[i]);
+    }
+    return s;
+}
+
+/*
+ * Itération de la puissance (à gauche si left, à droite sinon) depuis le vecteur
+ * uniforme ; v reçoit le vecteur propre dominant normalisé (norme 1), la valeur
+ * renvoyée est le rayon spectral estimé.
+ */
+static double dominant_eigenvector(const t_csr_matrix *P, int left, int max_iter, double tol,
+                                   double *v, int *iterations)
+{
+    int n = P->n;
+    double *y = alloc_vector(n);
+    double rho = 0.0;
+
+    for (int i = 0; i < n; ++i) {
+        v[i] = 1.0 / n;
+    }
+    for (int it = 0; it < max_iter; ++it) {
+        if (left) csrLeftMultiply(v, P, y);
+        else csrRightMultiply(P, v, y);
+        (*iterations)++;
+        double s = norm1(y, n);
+        rho = s;
+        if (s == 0.0) break;
+        double delta = 0.0;
+        for (int i = 0; i < n; ++i) {
+            y[i] /= s;
+            delta += fabs(y[i] - v[i]);
+            v[i] = y[i];
+        }
+        if (delta < tol) break;
+    }
+    free(y);
+    return rho;
+}
+
+t_spectral_estimate estimateSpectralGap(const t_csr_matrix *P, int max_iter, double tol)
+{
+    t_spectral_estimate est = {0.0, 0.0, 0.0, 0};
+    int n = P->n;
+    if (n == 0) return est;
+
+    double *u = alloc_vector(n);    /* vecteur propre à gauche (pi si stochastique) */
+    double *v = alloc_vector(n);    /* vecteur propre à droite (1 si stochastique) */
+    est.rho = dominant_eigenvector(P, 1, max_iter, tol, u, &est.iterations);
+    if (est.rho == 0.0) {
+        free(u);
+        free(v);
+        return est;
+    }
+    dominant_eigenvector(P, 0, max_iter, tol, v, &est.iterations);
+    double uv = 0.0;
+    for (int i = 0; i < n; ++i) {
+        uv += u[i] * v[i];
+    }
+
+    /* Itération déflatée : on retire à z sa composante (z.v / u.v) u, il reste
+     * alors une combinaison des autres vecteurs propres, dominée par lambda2. */
+    double *z = alloc_vector(n);
+    double *y = alloc_vector(n);
+    unsigned int seed = 12345u;
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        z[i] = (double)((seed >> 16) & 0x7fff) / 32768.0 - 0.5;
+    }
+
+    double ratios[DEFLATION_WINDOW];
+    int window = 0;
+    for (int it = 0; it < max_iter && uv != 0.0; ++it) {
+        double zv = 0.0;
+        for (int i = 0; i < n; ++i) {
+            zv += z[i] * v[i];
+        }
+        for (int i = 0; i < n; ++i) {
+            z[i] -= zv / uv * u[i];
+        }
+        double before = norm1(z, n);
+        if (before == 0.0) break;
+        for (int i = 0; i < n; ++i) {
+            z[i] /= before;
+        }
+        csrLeftMultiply(z, P, y);
+        est.iterations++;
+        double *t = z;
+        z = y;
+        y = t;
+
+        double r = norm1(z, n);
+        ratios[window % DEFLATION_WINDOW] = r > 0.0 ? r : 1e-300;
+        window++;
+        if (r == 0.0) {
+            est.lambda2 = 0.0;
+            break;
+        }
+        if (window < DEFLATION_WINDOW) {
+            est.lambda2 = r;
+            continue;
+        }
+        double log_sum = 0.0;
+        for (int w = 0; w < DEFLATION_WINDOW; ++w) {
+            log_sum += log(ratios[w]);
+        }
+        double estimate = exp(log_sum / DEFLATION_WINDOW);
+        int stable = fabs(estimate - est.lambda2) < tol;
+        est.lambda2 = estimate;
+        if (stable) break;
+    }
+    if (est.lambda2 > est.rho) est.lambda2 = est.rho;
+
+    est.rate = est.rho < 1.0 - STOCHASTIC_TOL && est.rho > est.lambda2 ? est.rho : est.lambda2;
+    free(z);
+    free(y);
+    free(u);
+    free(v);
+    return est;
+}
+
+int predictIterations(const t_spectral_estimate *est, int size, float eps, int cap)
+{
+    /* diff(M^n, M^(n-1)) = ||M^(n-1) (M - I)|| : somme, sur size lignes, d'un terme
+     * C rho^(n-1) (1 - rho) selon la valeur propre dominante et d'un terme
+     * C lambda2^(n-1) (1 + lambda2) selon les autres, avec C ~ 2 * size. */
+    double C = 2.0 * (size > 0 ? size : 1);
+    double n = 2.0;
+
+    if (est->rho > 0.0 && est->rho < 1.0 - STOCHASTIC_TOL) {
+        double ratio = eps / (C * (1.0 - est->rho));
+        if (ratio < 1.0) {
+            double n1 = 1.0 + log(ratio) / log(est->rho);
+            if (n1 > n) n = n1;
+        }
+    }
+    if (est->lambda2 >= 1.0 - STOCHASTIC_TOL) return cap;
+    if (est->lambda2 > 0.0) {
+        double ratio = eps / (C * (1.0 + est->lambda2));
+        if (ratio < 1.0) {
+            double n2 = 1.0 + log(ratio) / log(est->lambda2);
+            if (n2 > n) n = n2;
+        }
+    }
+
+    int predicted = (int)ceil(1.5 * n) + 5;
+    if (predicted < 2) predicted = 2;
+    if (predicted > cap) predicted = cap;
+    return predicted;
+}
@@ -0,0 +1,333 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "synth.h"
+
+static const char *const FAMILY_NAMES[NB_SYNTH_FAMILIES] = {
+    "random", "cycle", "absorbing", "dag", "blocks"
+};
+
+const char *synthFamilyName(t_synth_family family)
+{
+    return family >= 0 && family < NB_SYNTH_FAMILIES ? FAMILY_NAMES[family] : "?";
+}
+
+int synthFamilyFromName(const char *name)
+{
+    for (int f = 0; f < NB_SYNTH_FAMILIES; ++f) {
+        if (strcmp(name, FAMILY_NAMES[f]) == 0) return f;
+    }
+    return -1;
+}
+
+/* ================= Générateur pseudo-aléatoire ================= */
+
+/* splitmix64 : suite reproductible, indépendante de la plate-forme. */
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Sommet uniforme dans [first, first + count). */
+static int random_vertex(uint64_t *state, int first, int count)
+{
+    return first + (int)(next_random(state) % (uint64_t)count);
+}
+
+/* Réel uniforme dans [0, 1). */
+static double random_unit(uint64_t *state)
+{
+    return (double)(next_random(state) >> 11) * 0x1.0p-53;
+}
+
+/* Poids dans [0.5, 1.5) : pas de probabilité négligeable après normalisation. */
+static double random_weight(uint64_t *state)
+{
+    return 0.5 + random_unit(state);
+}
+
+/* ================= Familles ================= */
+
+/* Ajoute les arcs src -> dest[k] avec les poids w[k] normalisés. */
+static void add_row(t_graph *g, int src, const int *dest, const double *w, int count)
+{
+    double total = 0.0;
+    for (int k = 0; k < count; ++k) {
+        total += w[k];
+    }
+    for (int k = 0; k < count; ++k) {
+        addArc(g, src, dest[k], (float)(w[k] / total));
+    }
+}
+
+/* count destinations distinctes tirées dans [first, first + range). */
+static int draw_distinct(uint64_t *state, int first, int range, int count, int *dest)
+{
+    if (count > range) count = range;
+    for (int k = 0; k < count; ++k) {
+        int v, dup;
+        do {
+            v = random_vertex(state, first, range);
+            dup = 0;
+            for (int j = 0; j < k; ++j) {
+                if (dest[j] == v) dup = 1;
+            }
+        } while (dup);
+        dest[k] = v;
+    }
+    return count;
+}
+
+static void generate_random_sparse(t_graph *g, uint64_t *state)
+{
+    int n = g->nb_vertices;
+    int dest[SYNTH_SPARSE_DEGREE];
+    double w[SYNTH_SPARSE_DEGREE];
+    for (int i = 1; i <= n; ++i) {
+        int count = draw_distinct(state, 1, n, SYNTH_SPARSE_DEGREE, dest);
+        for (int k = 0; k < count; ++k) {
+            w[k] = random_weight(state);
+        }
+        add_row(g, i, dest, w, count);
+    }
+}
+
+static void generate_long_cycle(t_graph *g)
+{
+    int n = g->nb_vertices;
+    for (int i = 1; i <= n; ++i) {
+        addArc(g, i, i % n + 1, 1.0f);
+    }
+}
+
+/* Etats 1..t transitoires, t+1..n absorbants ; chaque état transitoire va
+ * vers un état transitoire et deux états absorbants tirés au hasard. */
+static void generate_absorbing(t_graph *g, uint64_t *state)
+{
+    int n = g->nb_vertices;
+    int t = n / 2;
+    int absorbing = n - t;
+    for (int i = 1; i <= t; ++i) {
+        int dest[3];
+        double w[3];
+        int count = 0;
+        dest[count++] = random_vertex(state, 1, t);
+        count += draw_distinct(state, t + 1, absorbing, 2, dest + count);
+        for (int k = 0; k < count; ++k) {
+            w[k] = random_weight(state);
+        }
+        add_row(g, i, dest, w, count);
+    }
+    for (int i = t + 1; i <= n; ++i) {
+        addArc(g, i, i, 1.0f);
+    }
+}
+
+static void generate_deep_dag(t_graph *g, uint64_t *state)
+{
+    int n = g->nb_vertices;
+    for (int i = 1; i <= n - 2; ++i) {
+        int dest[2] = {i + 1, i + 2};
+        double w[2] = {random_weight(state), random_weight(state)};
+        add_row(g, i, dest, w, 2);
+    }
+    if (n >= 2) addArc(g, n - 1, n, 1.0f);
+    if (n >= 1) addArc(g, n, n, 1.0f);
+}
+
+/* Blocs complets ; le premier état de chaque bloc (sauf le dernier) mène
+ * aussi au premier état du bloc suivant. */
+static void generate_dense_blocks(t_graph *g, uint64_t *state)
+{
+    int n = g->nb_vertices;
+    int *dest = malloc(sizeof(int) * (SYNTH_BLOCK_SIZE + 1));
+    double *w = malloc(sizeof(double) * (SYNTH_BLOCK_SIZE + 1));
+    if (!dest || !w) {
+        perror("malloc dense blocks");
+        exit(EXIT_FAILURE);
+    }
+    for (int first = 1; first <= n; first += SYNTH_BLOCK_SIZE) {
+        int size = n - first + 1 < SYNTH_BLOCK_SIZE ? n - first + 1 : SYNTH_BLOCK_SIZE;
+        int next = first + size;
+        for (int i = first; i < next; ++i) {
+            int count = 0;
+            for (int j = first; j < next; ++j) {
+                dest[count] = j;
+                w[count++] = random_weight(state);
+            }
+            if (i == first && next <= n) {
+                dest[count] = next;
+                w[count++] = random_weight(state);
+            }
+            add_row(g, i, dest, w, count);
+        }
+    }
+    free(dest);
+    free(w);
+}
+
+t_graph *generateChain(t_synth_family family, int n, uint64_t seed)
+{
+    t_graph *g = createGraph(n);
+    uint64_t state = seed ^ ((uint64_t)family << 32) ^ (uint64_t)n;
+    switch (family) {
+        case SYNTH_RANDOM_SPARSE:
+            generate_random_sparse(g, &state);
+            break;
+        case SYNTH_LONG_CYCLE:
+            generate_long_cycle(g);
+            break;
+        case SYNTH_ABSORBING:
+            generate_absorbing(g, &state);
+            break;
+        case SYNTH_DEEP_DAG:
+            generate_deep_dag(g, &state);
+            break;
+        case SYNTH_DENSE_BLOCKS:
+            generate_dense_blocks(g, &state);
+            break;
+        default:
+            break;
+    }
+    return g;
+}
+
+/* ================= Modèle paramétré ================= */
+
+int initSynthModel(t_synth_model *model, const t_synth_params *params)
+{
+    const t_synth_params *p = params;
+    if (p->nb_states < 1 || p->degree < 1 || p->degree > SYNTH_MAX_DEGREE || p->nb_classes < 0
+        || p->nb_closed < 0 || p->nb_closed > p->nb_classes || p->period < 1
+        || p->absorbing < 0.0 || p->absorbing > 1.0 || p->leak < 0.0 || p->leak > 1.0) {
+        fprintf(stderr, "Parametres du modele invalides\n");
+        return 0;
+    }
+    model->params = *p;
+    int absorbing = (int)llround(p->absorbing * p->nb_states);
+    int in_classes = p->nb_classes ? p->nb_states - absorbing : 0;
+    model->units = in_classes / p->period;
+    model->class_states = model->units * p->period;
+    if (model->units < p->nb_classes) {
+        fprintf(stderr, "%d classes de periode %d demandent au moins %d etats non absorbants\n",
+                p->nb_classes, p->period, p->nb_classes * p->period);
+        return 0;
+    }
+    if (p->nb_classes > p->nb_closed && p->nb_closed == 0 && model->class_states == p->nb_states) {
+        fprintf(stderr, "Les classes transitoires doivent mener a une classe persistante ou a un etat absorbant\n");
+        return 0;
+    }
+    return 1;
+}
+
+int synthAbsorbingStates(const t_synth_model *model)
+{
+    return model->params.nb_states - model->class_states;
+}
+
+/* Classe contenant le groupe u : les units groupes sont répartis entre les
+ * classes, les premières en recevant un de plus. */
+static int class_of_unit(const t_synth_model *model, int u, int *first_unit, int *nb_units)
+{
+    int k = model->params.nb_classes;
+    int base = model->units / k;
+    int extra = model->units % k;
+    int boundary = extra * (base + 1);
+    int c;
+    if (u < boundary) {
+        c = u / (base + 1);
+        *first_unit = c * (base + 1);
+    } else {
+        c = extra + (u - boundary) / base;
+        *first_unit = boundary + (c - extra) * base;
+    }
+    *nb_units = base + (c < extra);
+    return c;
+}
+
+static int draw_degree(const t_synth_params *p, uint64_t *state)
+{
+    int d = p->degree;
+    switch (p->degree_dist) {
+        case DEGREE_UNIFORM:
+            d = 1 + (int)(next_random(state) % (uint64_t)(2 * p->degree - 1));
+            break;
+        case DEGREE_GEOMETRIC:
+            if (p->degree > 1) {
+                double u = 1.0 - random_unit(state);
+                double q = (double)(p->degree - 1) / p->degree;
+                double extra = floor(log(u) / log(q));
+                d = extra >= SYNTH_MAX_DEGREE ? SYNTH_MAX_DEGREE : 1 + (int)extra;
+            }
+            break;
+        default:
+            break;
+    }
+    return d < SYNTH_MAX_DEGREE ? d : SYNTH_MAX_DEGREE;
+}
+
+static int compare_synth_arcs(const void *a, const void *b)
+{
+    int x = ((const t_synth_arc *)a)->dest, y = ((const t_synth_arc *)b)->dest;
+    return (x > y) - (x < y);
+}
+
+int synthRow(const t_synth_model *model, int state, t_synth_arc *row)
+{
+    const t_synth_params *p = &model->params;
+    int i = state - 1;
+    if (i >= model->class_states) {
+        row[0].dest = state;
+        row[0].proba = 1.0f;
+        return 1;
+    }
+
+    uint64_t rng = p->seed ^ ((uint64_t)state * 0xd1b54a32d192ed03ULL);
+    int d = p->period;
+    int first_unit, nb_units;
+    int c = class_of_unit(model, i / d, &first_unit, &nb_units);
+    int first = first_unit * d;
+    int size = nb_units * d;
+    int local = i - first;
+    int next_phase = (local + 1) % d;
+
+    /* Anneau de la classe (forte connexité), arcs vers la phase suivante
+     * (période multiple de d) et raccourci d-1 -> 0 (cycle de longueur d). */
+    double weight[SYNTH_MAX_ROW];
+    int count = 0;
+    row[count++].dest = first + (local + 1) % size + 1;
+    int degree = draw_degree(p, &rng);
+    for (int k = 1; k < degree; ++k) {
+        row[count++].dest = first + (int)(next_random(&rng) % (uint64_t)nb_units) * d + next_phase + 1;
+    }
+    if (local == d - 1 && size > d) row[count++].dest = first + 1;
+    int transient = c < p->nb_classes - p->nb_closed;
+    if (transient && (local == 0 || random_unit(&rng) < p->leak)) {
+        int after = first + size;
+        row[count++].dest = random_vertex(&rng, after + 1, p->nb_states - after);
+    }
+
+    qsort(row, (size_t)count, sizeof(t_synth_arc), compare_synth_arcs);
+    int merged = 0;
+    for (int k = 0; k < count; ++k) {
+        double w = random_weight(&rng);
+        if (merged > 0 && row[merged - 1].dest == row[k].dest) {
+            weight[merged - 1] += w;
+        } else {
+            row[merged].dest = row[k].dest;
+            weight[merged++] = w;
+        }
+    }
+    double total = 0.0;
+    for (int k = 0; k < merged; ++k) {
+        total += weight[k];
+    }
+    for (int k = 0; k < merged; ++k) {
+        row[k].proba = (float)(weight[k] / total);
+    }
+    return merged;
+}
@@ -3,6 +3,7 @@
 #include <string.h>
 #include "tarjan.h"
 #include "utils.h"
+#include "hwcounters.h"
 
 static void init_partition(t_partition *p)
 {
@@ -41,65 +42,83 @@ static void partition_add_class(t_partition *p, const int *verts, int nb_verts,
     p->size++;
 }
 
-static void tarjan_visit(int v_index,
+/**
+ * @brief Cadre du parcours en profondeur : sommet et prochain arc à examiner.
+ */
+typedef struct {
+    int v;
+    const t_arc *next;
+} t_tarjan_frame;
+
+/* Ferme la composante de racine v_index : dépile ses sommets dans scc. */
+static void tarjan_close_class(int v_index,
+                               t_tarjan_vertex *verts,
+                               t_int_stack *stack,
+                               int *scc,
+                               t_partition *part,
+                               int *class_counter)
+{
+    int size = 0;
+    int w_idx;
+    do {
+        w_idx = stack_pop(stack);
+        verts[w_idx].on_stack = 0;
+        scc[size++] = verts[w_idx].id;
+    } while (w_idx != v_index);
+
+    (*class_counter)++;
+    partition_add_class(part, scc, size, *class_counter);
+}
+
+/* Parcours itératif depuis root : la pile de cadres remplace la récursion,
+ * dont la profondeur (un appel par sommet d'un chemin) dépasse la pile
+ * système sur les longs cycles et les DAG profonds. */
+static void tarjan_visit(int root,
                          const t_graph *g,
                          t_tarjan_vertex *verts,
                          t_int_stack *stack,
+                         t_tarjan_frame *frames,
+                         int *scc,
                          int *current_index,
                          t_partition *part,
                          int *class_counter)
 {
-    t_tarjan_vertex *v = &verts[v_index];
-    v->index = *current_index;
-    v->lowlink = *current_index;
-    (*current_index)++;
-
-    stack_push(stack, v_index);
-    v->on_stack = 1;
-
-    t_arc *cur = g->array[v_index].head;
-    while (cur) {
-        int w_index = cur->dest - 1;
-        t_tarjan_vertex *w = &verts[w_index];
-        if (w->index == -1) {
-            tarjan_visit(w_index, g, verts, stack, current_index, part, class_counter);
-            if (w->lowlink < v->lowlink)
-                v->lowlink = w->lowlink;
-        } else if (w->on_stack) {
-            if (w->index < v->lowlink)
+    int depth = 0;
+    frames[0].v = root;
+    frames[0].next = g->array[root].head;
+    verts[root].index = verts[root].lowlink = (*current_index)++;
+    stack_push(stack, root);
+    verts[root].on_stack = 1;
+
+    while (depth >= 0) {
+        t_tarjan_frame *f = &frames[depth];
+        t_tarjan_vertex *v = &verts[f->v];
+        if (f->next) {
+            int w_index = f->next->dest - 1;
+            f->next = f->next->next;
+            t_tarjan_vertex *w = &verts[w_index];
+            if (w->index == -1) {
+                w->index = w->lowlink = (*current_index)++;
+                stack_push(stack, w_index);
+                w->on_stack = 1;
+                depth++;
+                frames[depth].v = w_index;
+                frames[depth].next = g->array[w_index].head;
+            } else if (w->on_stack && w->index < v->lowlink) {
                 v->lowlink = w->index;
+            }
+            continue;
         }
-        cur = cur->next;
-    }
 
-    if (v->lowlink == v->index) {
-        int w_idx;
-        int capacity = 4;
-        int size = 0;
-        int *scc_verts = malloc(sizeof(int) * (size_t)capacity);
-        if (!scc_verts) {
-            perror("malloc scc_verts");
-            exit(EXIT_FAILURE);
+        /* Tous les successeurs de v sont traités : retour au parent. */
+        if (v->lowlink == v->index) {
+            tarjan_close_class(f->v, verts, stack, scc, part, class_counter);
+        }
+        depth--;
+        if (depth >= 0) {
+            t_tarjan_vertex *parent = &verts[frames[depth].v];
+            if (v->lowlink < parent->lowlink) parent->lowlink = v->lowlink;
         }
-
-        do {
-            w_idx = stack_pop(stack);
-            verts[w_idx].on_stack = 0;
-            if (size >= capacity) {
-                capacity *= 2;
-                int *tmp = realloc(scc_verts, sizeof(int) * (size_t)capacity);
-                if (!tmp) {
-                    perror("realloc scc_verts");
-                    exit(EXIT_FAILURE);
-                }
-                scc_verts = tmp;
-            }
-            scc_verts[size++] = verts[w_idx].id;
-        } while (w_idx != v_index);
-
-        (*class_counter)++;
-        partition_add_class(part, scc_verts, size, *class_counter);
-        free(scc_verts);
     }
 }
 
@@ -110,6 +129,9 @@ t_partition tarjanPartition(const t_graph *g)
 
     if (!g) return part;
 
+    double nb_arcs = hwCountersEnabled() ? countArcs(g) : 0.0;
+    t_hw_probe probe;
+    hwProbeBegin(&probe, KERNEL_TARJAN);
     int n = g->nb_vertices;
     t_tarjan_vertex *verts = malloc(sizeof(t_tarjan_vertex) * (size_t)n);
     if (!verts) {
@@ -125,17 +147,26 @@ t_partition tarjanPartition(const t_graph *g)
     }
 
     t_int_stack *stack = stack_create(n);
+    t_tarjan_frame *frames = malloc(sizeof(t_tarjan_frame) * (size_t)(n > 0 ? n : 1));
+    int *scc = malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    if (!frames || !scc) {
+        perror("malloc tarjan frames");
+        exit(EXIT_FAILURE);
+    }
     int current_index = 0;
     int class_counter = 0;
 
     for (int i = 0; i < n; ++i) {
         if (verts[i].index == -1) {
-            tarjan_visit(i, g, verts, stack, &current_index, &part, &class_counter);
+            tarjan_visit(i, g, verts, stack, frames, scc, &current_index, &part, &class_counter);
         }
     }
 
     stack_free(stack);
+    free(frames);
+    free(scc);
     free(verts);
+    hwProbeEnd(&probe, 0.0, nb_arcs);
     return part;
 }
 
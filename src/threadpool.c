@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "threadpool.h"
+
+typedef struct {
+    t_task_fn fn;
+    void *arg;
+    t_task_group *group;
+} t_task;
+
+/* File double : le propriétaire travaille en bas, les voleurs prennent en haut. */
+typedef struct {
+    t_task *tasks;
+    int top;
+    int bottom;
+    int capacity;
+    pthread_mutex_t lock;
+} t_task_deque;
+
+typedef struct {
+    t_thread_pool *pool;
+    int index;
+    pthread_t thread;
+    t_task_deque deque;
+} t_worker;
+
+struct s_thread_pool {
+    t_worker *workers;
+    int nb_workers;
+    int next_worker;        /**< Tourniquet pour les soumissions externes. */
+    int queued;             /**< Tâches en file (toutes files confondues). */
+    int stop;
+    pthread_mutex_t lock;
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+    pthread_key_t self_key;
+};
+
+static void deque_init(t_task_deque *d)
+{
+    d->capacity = 16;
+    d->top = d->bottom = 0;
+    d->tasks = malloc(sizeof(t_task) * (size_t)d->capacity);
+    if (!d->tasks) {
+        perror("malloc task deque");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_init(&d->lock, NULL);
+}
+
+static void deque_free(t_task_deque *d)
+{
+    free(d->tasks);
+    d->tasks = NULL;
+    pthread_mutex_destroy(&d->lock);
+}
+
+static void deque_push_bottom(t_task_deque *d, t_task t)
+{
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom >= d->capacity) {
+        int count = d->bottom - d->top;
+        if (d->top > 0 && count < d->capacity / 2) {
+            for (int i = 0; i < count; ++i) {
+                d->tasks[i] = d->tasks[d->top + i];
+            }
+        } else {
+            d->capacity *= 2;
+            t_task *tmp = malloc(sizeof(t_task) * (size_t)d->capacity);
+            if (!tmp) {
+                perror("realloc task deque");
+                exit(EXIT_FAILURE);
+            }
+            for (int i = 0; i < count; ++i) {
+                tmp[i] = d->tasks[d->top + i];
+            }
+            free(d->tasks);
+            d->tasks = tmp;
+        }
+        d->top = 0;
+        d->bottom = count;
+    }
+    d->tasks[d->bottom++] = t;
+    pthread_mutex_unlock(&d->lock);
+}
+
+static int deque_pop_bottom(t_task_deque *d, t_task *out)
+{
+    int ok = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top) {
+        *out = d->tasks[--d->bottom];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+static int deque_steal_top(t_task_deque *d, t_task *out)
+{
+    int ok = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top) {
+        *out = d->tasks[d->top++];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+/* self vaut -1 pour un thread extérieur au pool (il ne fait que voler). */
+static int pool_take(t_thread_pool *pool, int self, t_task *out)
+{
+    int found = 0;
+    if (self >= 0) {
+        found = deque_pop_bottom(&pool->workers[self].deque, out);
+    }
+    for (int i = 1; !found && i <= pool->nb_workers; ++i) {
+        int victim = (self + i + pool->nb_workers) % pool->nb_workers;
+        found = deque_steal_top(&pool->workers[victim].deque, out);
+    }
+    if (found) {
+        pthread_mutex_lock(&pool->lock);
+        pool->queued--;
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return found;
+}
+
+static void run_task(t_thread_pool *pool, t_task *t)
+{
+    t->fn(t->arg);
+    if (t->group) {
+        pthread_mutex_lock(&pool->lock);
+        t->group->pending--;
+        if (t->group->pending == 0) {
+            pthread_cond_broadcast(&pool->done_cv);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static int current_worker(t_thread_pool *pool)
+{
+    t_worker *w = pthread_getspecific(pool->self_key);
+    return (w && w->pool == pool) ? w->index : -1;
+}
+
+static void *worker_main(void *arg)
+{
+    t_worker *w = arg;
+    t_thread_pool *pool = w->pool;
+    pthread_setspecific(pool->self_key, w);
+
+    for (;;) {
+        t_task t;
+        if (pool_take(pool, w->index, &t)) {
+            run_task(pool, &t);
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        while (pool->queued == 0 && !pool->stop) {
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        }
+        int done = pool->stop && pool->queued == 0;
+        pthread_mutex_unlock(&pool->lock);
+        if (done) break;
+    }
+    return NULL;
+}
+
+t_thread_pool *pool_create(int nb_threads)
+{
+    if (nb_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nb_threads = cpus > 0 ? (int)cpus : 1;
+    }
+
+    t_thread_pool *pool = malloc(sizeof(t_thread_pool));
+    if (!pool) {
+        perror("malloc thread pool");
+        exit(EXIT_FAILURE);
+    }
+    pool->nb_workers = nb_threads;
+    pool->next_worker = 0;
+    pool->queued = 0;
+    pool->stop = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+    pthread_key_create(&pool->self_key, NULL);
+
+    pool->workers = malloc(sizeof(t_worker) * (size_t)nb_threads);
+    if (!pool->workers) {
+        perror("malloc workers");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < nb_threads; ++i) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        deque_init(&pool->workers[i].deque);
+    }
+    for (int i = 0; i < nb_threads; ++i) {
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return pool;
+}
+
+void pool_destroy(t_thread_pool *pool)
+{
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->nb_workers; ++i) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    for (int i = 0; i < pool->nb_workers; ++i) {
+        deque_free(&pool->workers[i].deque);
+    }
+    free(pool->workers);
+    pthread_key_delete(pool->self_key);
+    pthread_cond_destroy(&pool->done_cv);
+    pthread_cond_destroy(&pool->work_cv);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+int pool_size(const t_thread_pool *pool)
+{
+    return pool ? pool->nb_workers : 0;
+}
+
+void pool_submit(t_thread_pool *pool, t_task_fn fn, void *arg, t_task_group *group)
+{
+    t_task t = {fn, arg, group};
+    int self = current_worker(pool);
+
+    /* queued est incrémenté avant l'insertion : un thread qui le voit positif
+     * sans trouver la tâche se contente de refaire un tour. */
+    pthread_mutex_lock(&pool->lock);
+    if (group) group->pending++;
+    pool->queued++;
+    int target = self;
+    if (target < 0) {
+        target = pool->next_worker;
+        pool->next_worker = (pool->next_worker + 1) % pool->nb_workers;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    deque_push_bottom(&pool->workers[target].deque, t);
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->work_cv);
+    pthread_cond_broadcast(&pool->done_cv);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void pool_wait(t_thread_pool *pool, t_task_group *group)
+{
+    int self = current_worker(pool);
+    for (;;) {
+        t_task t;
+        if (pool_take(pool, self, &t)) {
+            run_task(pool, &t);
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        if (group->pending == 0) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        if (pool->queued == 0) {
+            pthread_cond_wait(&pool->done_cv, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "tiled.h"
+
+typedef struct {
+    float *owner;           /* projection de la matrice propriétaire (NULL : libre) */
+    int owner_nb_tiles;
+    int ti;
+    int tj;
+    float *buf;
+    int dirty;
+    int pinned;
+    unsigned long last_use;
+} t_tile_slot;
+
+struct s_tile_cache {
+    int tile;
+    int nb_slots;
+    t_tile_slot *slots;
+    unsigned long clock;
+    t_io_stats stats;
+};
+
+static size_t tile_floats(const t_tiled_matrix *m)
+{
+    return (size_t)m->tile * (size_t)m->tile;
+}
+
+static float *tile_ptr(const t_tiled_matrix *m, int ti, int tj)
+{
+    return m->map + ((size_t)ti * (size_t)m->nb_tiles + (size_t)tj) * tile_floats(m);
+}
+
+/* ================= Stockage ================= */
+
+t_tiled_matrix createTiledMatrix(const char *dir, int n, int tile)
+{
+    t_tiled_matrix m;
+    m.n = n;
+    m.tile = tile;
+    m.nb_tiles = (n + tile - 1) / tile;
+    m.map_bytes = (size_t)m.nb_tiles * (size_t)m.nb_tiles * tile_floats(&m) * sizeof(float);
+    if (m.map_bytes == 0) m.map_bytes = sizeof(float);
+
+    /* Nom unique même entre threads (mode --batch) et entre processus. */
+    snprintf(m.path, sizeof(m.path), "%s/tiled_XXXXXX", dir);
+    m.fd = mkstemp(m.path);
+    if (m.fd < 0) {
+        perror("open tiled matrix file");
+        exit(EXIT_FAILURE);
+    }
+    if (ftruncate(m.fd, (off_t)m.map_bytes) != 0) {
+        perror("ftruncate tiled matrix file");
+        exit(EXIT_FAILURE);
+    }
+    m.map = mmap(NULL, m.map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m.fd, 0);
+    if (m.map == MAP_FAILED) {
+        perror("mmap tiled matrix file");
+        exit(EXIT_FAILURE);
+    }
+    return m;
+}
+
+void freeTiledMatrix(t_tiled_matrix *m)
+{
+    if (!m || !m->map) return;
+    munmap(m->map, m->map_bytes);
+    close(m->fd);
+    unlink(m->path);
+    m->map = NULL;
+    m->fd = -1;
+    m->n = m->nb_tiles = 0;
+}
+
+t_tiled_matrix tiledFromGraph(const t_graph *g, const char *dir, int tile)
+{
+    t_tiled_matrix T = createTiledMatrix(dir, g->nb_vertices, tile);
+    for (int i = 0; i < g->nb_vertices; ++i) {
+        for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
+            int j = cur->dest - 1;
+            float *t = tile_ptr(&T, i / tile, j / tile);
+            t[(i % tile) * tile + (j % tile)] = cur->proba;
+        }
+    }
+    return T;
+}
+
+void tiledReadRow(const t_tiled_matrix *T, int i, float *row)
+{
+    int tile = T->tile;
+    for (int tj = 0; tj < T->nb_tiles; ++tj) {
+        int width = T->n - tj * tile < tile ? T->n - tj * tile : tile;
+        memcpy(row + (size_t)tj * tile, tile_ptr(T, i / tile, tj) + (size_t)(i % tile) * tile,
+               sizeof(float) * (size_t)width);
+    }
+}
+
+/* ================= Cache de tuiles ================= */
+
+t_tile_cache *createTileCache(size_t max_bytes, int tile)
+{
+    t_tile_cache *cache = malloc(sizeof(t_tile_cache));
+    if (!cache) {
+        perror("malloc tile cache");
+        exit(EXIT_FAILURE);
+    }
+    size_t tile_bytes = (size_t)tile * (size_t)tile * sizeof(float);
+    size_t slots = max_bytes / tile_bytes;
+    cache->tile = tile;
+    cache->nb_slots = slots < 3 ? 3 : (int)slots;
+    cache->clock = 0;
+    cache->stats.bytes_read = 0;
+    cache->stats.bytes_written = 0;
+    cache->slots = calloc((size_t)cache->nb_slots, sizeof(t_tile_slot));
+    if (!cache->slots) {
+        perror("calloc tile slots");
+        exit(EXIT_FAILURE);
+    }
+    for (int s = 0; s < cache->nb_slots; ++s) {
+        cache->slots[s].buf = malloc(tile_bytes);
+        if (!cache->slots[s].buf) {
+            perror("malloc tile buffer");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return cache;
+}
+
+static void slot_write_back(t_tile_cache *cache, t_tile_slot *slot)
+{
+    if (!slot->dirty) return;
+    size_t floats = (size_t)cache->tile * (size_t)cache->tile;
+    size_t bytes = floats * sizeof(float);
+    float *dst = slot->owner + ((size_t)slot->ti * (size_t)slot->owner_nb_tiles + (size_t)slot->tj) * floats;
+    memcpy(dst, slot->buf, bytes);
+    cache->stats.bytes_written += bytes;
+    slot->dirty = 0;
+}
+
+static void cache_flush(t_tile_cache *cache, const t_tiled_matrix *m)
+{
+    for (int s = 0; s < cache->nb_slots; ++s) {
+        if (cache->slots[s].owner == m->map) {
+            slot_write_back(cache, &cache->slots[s]);
+        }
+    }
+}
+
+void freeTileCache(t_tile_cache *cache)
+{
+    if (!cache) return;
+    for (int s = 0; s < cache->nb_slots; ++s) {
+        free(cache->slots[s].buf);
+    }
+    free(cache->slots);
+    free(cache);
+}
+
+void tileCacheInvalidate(t_tile_cache *cache, const t_tiled_matrix *m)
+{
+    for (int s = 0; s < cache->nb_slots; ++s) {
+        if (cache->slots[s].owner == m->map) {
+            slot_write_back(cache, &cache->slots[s]);
+            cache->slots[s].owner = NULL;
+        }
+    }
+}
+
+t_io_stats tileCacheStats(const t_tile_cache *cache)
+{
+    return cache->stats;
+}
+
+/*
+ * Renvoie la tuile (ti,tj) de m, épinglée. Si overwrite, la tuile est mise à zéro
+ * au lieu d'être lue (elle sera entièrement recalculée).
+ */
+static t_tile_slot *cache_get(t_tile_cache *cache, const t_tiled_matrix *m, int ti, int tj,
+                              int overwrite)
+{
+    cache->clock++;
+    t_tile_slot *victim = NULL;
+    for (int s = 0; s < cache->nb_slots; ++s) {
+        t_tile_slot *slot = &cache->slots[s];
+        if (slot->owner == m->map && slot->ti == ti && slot->tj == tj) {
+            slot->last_use = cache->clock;
+            slot->pinned = 1;
+            if (overwrite) {
+                memset(slot->buf, 0, tile_floats(m) * sizeof(float));
+                slot->dirty = 1;
+            }
+            return slot;
+        }
+        if (slot->pinned) continue;
+        if (!victim || !slot->owner || (victim->owner && slot->last_use < victim->last_use)) {
+            victim = slot;
+        }
+    }
+
+    if (victim->owner) {
+        slot_write_back(cache, victim);
+    }
+    size_t bytes = tile_floats(m) * sizeof(float);
+    if (overwrite) {
+        memset(victim->buf, 0, bytes);
+        victim->dirty = 1;
+    } else {
+        memcpy(victim->buf, tile_ptr(m, ti, tj), bytes);
+        cache->stats.bytes_read += bytes;
+        victim->dirty = 0;
+    }
+    victim->owner = m->map;
+    victim->owner_nb_tiles = m->nb_tiles;
+    victim->ti = ti;
+    victim->tj = tj;
+    victim->pinned = 1;
+    victim->last_use = cache->clock;
+    return victim;
+}
+
+static void prefetch_tile(const t_tiled_matrix *m, int ti, int tj)
+{
+    if (ti >= m->nb_tiles || tj >= m->nb_tiles) return;
+    long page = sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)tile_ptr(m, ti, tj);
+    uintptr_t aligned = start & ~((uintptr_t)page - 1);
+    size_t len = tile_floats(m) * sizeof(float) + (size_t)(start - aligned);
+    madvise((void *)aligned, len, MADV_WILLNEED);
+}
+
+/* ================= Produits ================= */
+
+void tiledMultiply(const t_tiled_matrix *A, const t_tiled_matrix *B, t_tiled_matrix *C,
+                   t_tile_cache *cache)
+{
+    int nt = A->nb_tiles;
+    int tile = A->tile;
+
+    for (int ti = 0; ti < nt; ++ti) {
+        for (int tj = 0; tj < nt; ++tj) {
+            t_tile_slot *c_slot = cache_get(cache, C, ti, tj, 1);
+            float *c = c_slot->buf;
+
+            for (int tk = 0; tk < nt; ++tk) {
+                prefetch_tile(A, ti, tk + 1);
+                prefetch_tile(B, tk + 1, tj);
+                t_tile_slot *a_slot = cache_get(cache, A, ti, tk, 0);
+                t_tile_slot *b_slot = cache_get(cache, B, tk, tj, 0);
+                const float *a = a_slot->buf;
+                const float *b = b_slot->buf;
+
+                for (int i = 0; i < tile; ++i) {
+                    float *c_row = &c[i * tile];
+                    for (int k = 0; k < tile; ++k) {
+                        float x = a[i * tile + k];
+                        if (x == 0.0f) continue;
+                        const float *b_row = &b[k * tile];
+                        for (int j = 0; j < tile; ++j) {
+                            c_row[j] += x * b_row[j];
+                        }
+                    }
+                }
+                a_slot->pinned = 0;
+                b_slot->pinned = 0;
+            }
+            c_slot->pinned = 0;
+        }
+    }
+    cache_flush(cache, C);
+}
+
+t_tiled_matrix tiledPower(const t_tiled_matrix *M, int power, const char *dir, t_tile_cache *cache)
+{
+    int n = M->n;
+    int tile = M->tile;
+    t_tiled_matrix result = createTiledMatrix(dir, n, tile);
+    t_tiled_matrix tmp = createTiledMatrix(dir, n, tile);
+
+    for (int i = 0; i < n; ++i) {
+        tile_ptr(&result, i / tile, i / tile)[(i % tile) * tile + (i % tile)] = 1.0f;
+    }
+
+    for (int p = 0; p < power; ++p) {
+        tiledMultiply(&result, M, &tmp, cache);
+        t_tiled_matrix sw = result;
+        result = tmp;
+        tmp = sw;
+    }
+
+    tileCacheInvalidate(cache, &tmp);
+    freeTiledMatrix(&tmp);
+    return result;
+}
@@ -98,3 +98,15 @@ int *calloc_int_array(int n)
     }
     return arr;
 }
+
+int gcd_int(int a, int b)
+{
+    if (a < 0) a = -a;
+    if (b < 0) b = -b;
+    while (b != 0) {
+        int temp = b;
+        b = a % b;
+        a = temp;
+    }
+    return a;
+}
@@ -0,0 +1,1353 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <math.h>
+#include "writer.h"
+#include "utils.h"
+
+/*
+ * Format binaire : l'en-tête "MKV2" puis une suite d'enregistrements
+ * [type : u8][taille des données : u64][données], entiers et flottants dans
+ * l'ordre natif de la machine. Les données sont toujours complètes (le niveau
+ * de détail ne s'applique qu'aux formats texte et JSON) :
+ *   1 graphe          i32 n, i32 nb_arcs, u8 continu, u8 valide
+ *   2 partition       i32 nb_classes, puis par classe : u8 lg, nom, i32 k, i32 sommets[k]
+ *   3 classification  i32 nb_classes, puis par classe : u8 transitoire, u8 absorbant ; u8 irreductible
+ *   4 matrice         u8 lg, nom, i32 lignes, i32 colonnes, f32 coefficients (numérotation d'origine)
+ *   5 vecteur         u8 lg, nom, i32 n, f32 valeurs[n]
+ *   6 classe          u8 lg, nom, i32 période, i32 puissance, i32 k, i32 sommets[k], f32 distribution[k],
+ *                     puis si période > 1 : f32 limites[période][k]
+ *   7 absorption      i32 n, i32 np, i32 classes[np], puis par sommet : u8 transitoire, f32 temps,
+ *                     i32 k, puis k fois (i32 p, f32 proba) pour les classes atteintes
+ *   8 simulation      i64 trajectoires, u64 visites, i64 atteintes, f64 temps moyen,
+ *                     i32 n, u64 visites[n], i32 nb_classes, i32 largeur, u64 histogramme[nb_classes]
+ *   9 agrégation      i32 n, i32 nb_blocs, i32 bloc[n]
+ *  10 entrées/sorties u64 octets lus, u64 octets écrits (puissances hors mémoire)
+ */
+enum {
+    RECORD_GRAPH = 1,
+    RECORD_PARTITION,
+    RECORD_CLASSIFICATION,
+    RECORD_MATRIX,
+    RECORD_VECTOR,
+    RECORD_CLASS,
+    RECORD_ABSORPTION,
+    RECORD_SIMULATION,
+    RECORD_LUMPING,
+    RECORD_IO,
+    RECORD_QUOTIENT_CLASS
+};
+
+#define WRITER_BUFFER_BYTES ((size_t)1 << 20)
+
+struct s_writer {
+    FILE *out;
+    t_output_format format;
+    t_print_options print;
+    char *buf;
+    size_t len;
+    size_t cap;
+};
+
+/* ================= Tampon ================= */
+
+void writerFlush(t_writer *w)
+{
+    if (w->len > 0) {
+        fwrite(w->buf, 1, w->len, w->out);
+        w->len = 0;
+    }
+}
+
+static void put_bytes(t_writer *w, const void *data, size_t n)
+{
+    if (w->len + n > w->cap) {
+        writerFlush(w);
+        if (n > w->cap) {
+            fwrite(data, 1, n, w->out);
+            return;
+        }
+    }
+    memcpy(w->buf + w->len, data, n);
+    w->len += n;
+}
+
+static void put_str(t_writer *w, const char *s)
+{
+    put_bytes(w, s, strlen(s));
+}
+
+static void put_char(t_writer *w, char c)
+{
+    if (w->len == w->cap) writerFlush(w);
+    w->buf[w->len++] = c;
+}
+
+/* Texte formaté écrit directement dans le tampon ; une ligne plus longue que
+ * le tampon est formatée à part puis écrite telle quelle. */
+static void put_vfmt(t_writer *w, const char *fmt, va_list ap)
+{
+    va_list again;
+    va_copy(again, ap);
+    size_t room = w->cap - w->len;
+    int n = vsnprintf(w->buf + w->len, room, fmt, ap);
+    if (n >= 0 && (size_t)n < room) {
+        w->len += (size_t)n;
+    } else if (n >= 0) {
+        writerFlush(w);
+        if ((size_t)n < w->cap) {
+            vsnprintf(w->buf, w->cap, fmt, again);
+            w->len = (size_t)n;
+        } else {
+            char *line = malloc((size_t)n + 1);
+            if (!line) {
+                perror("malloc writer line");
+                exit(EXIT_FAILURE);
+            }
+            vsnprintf(line, (size_t)n + 1, fmt, again);
+            put_bytes(w, line, (size_t)n);
+            free(line);
+        }
+    }
+    va_end(again);
+}
+
+static void put_fmt(t_writer *w, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    put_vfmt(w, fmt, ap);
+    va_end(ap);
+}
+
+t_writer *createWriter(FILE *out, t_output_format format, const t_print_options *opt)
+{
+    t_writer *w = malloc(sizeof(t_writer));
+    if (!w) {
+        perror("malloc writer");
+        exit(EXIT_FAILURE);
+    }
+    w->out = out;
+    w->format = format;
+    w->print.mode = opt ? opt->mode : PRINT_FULL;
+    w->print.topk = opt ? opt->topk : 0;
+    w->cap = WRITER_BUFFER_BYTES;
+    w->len = 0;
+    w->buf = malloc(w->cap);
+    if (!w->buf) {
+        perror("malloc writer buffer");
+        exit(EXIT_FAILURE);
+    }
+    if (format == FORMAT_BINARY && out) put_bytes(w, "MKV2", 4);
+    return w;
+}
+
+void writerReset(t_writer *w, FILE *out)
+{
+    writerFlush(w);
+    w->out = out;
+    if (w->format == FORMAT_BINARY && out) put_bytes(w, "MKV2", 4);
+}
+
+void freeWriter(t_writer *w)
+{
+    if (!w) return;
+    writerFlush(w);
+    if (w->out) fflush(w->out);
+    free(w->buf);
+    free(w);
+}
+
+void writeText(t_writer *w, const char *fmt, ...)
+{
+    if (w->format != FORMAT_TEXT) return;
+    va_list ap;
+    va_start(ap, fmt);
+    put_vfmt(w, fmt, ap);
+    va_end(ap);
+}
+
+/* ================= Primitives binaires ================= */
+
+static void put_u8(t_writer *w, uint8_t x) { put_bytes(w, &x, sizeof(x)); }
+static void put_i32(t_writer *w, int32_t x) { put_bytes(w, &x, sizeof(x)); }
+static void put_i64(t_writer *w, int64_t x) { put_bytes(w, &x, sizeof(x)); }
+static void put_u64(t_writer *w, uint64_t x) { put_bytes(w, &x, sizeof(x)); }
+static void put_f32(t_writer *w, float x) { put_bytes(w, &x, sizeof(x)); }
+static void put_f64(t_writer *w, double x) { put_bytes(w, &x, sizeof(x)); }
+
+static void put_record_header(t_writer *w, uint8_t type, size_t payload)
+{
+    put_u8(w, type);
+    put_u64(w, (uint64_t)payload);
+}
+
+static size_t name_bytes(const char *name)
+{
+    size_t n = strlen(name);
+    return n > 255 ? 255 : n;
+}
+
+static void put_name(t_writer *w, const char *name)
+{
+    size_t n = name_bytes(name);
+    put_u8(w, (uint8_t)n);
+    put_bytes(w, name, n);
+}
+
+/* ================= Primitives JSON ================= */
+
+static void put_int(t_writer *w, long long x)
+{
+    char tmp[24];
+    int n = 0;
+    unsigned long long u = x < 0 ? (unsigned long long)(-(x + 1)) + 1 : (unsigned long long)x;
+    do {
+        tmp[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (x < 0) put_char(w, '-');
+    while (n > 0) put_char(w, tmp[--n]);
+}
+
+/* Flottant en notation fixe à 6 décimales au plus (zéros de fin supprimés),
+ * sans passer par printf ; repli sur %.6g pour les très grandes valeurs et sous
+ * 1e-3, où 6 décimales garderaient moins de 4 chiffres significatifs. */
+static void put_float(t_writer *w, double x)
+{
+    if (isnan(x) || isinf(x)) {
+        put_str(w, "null");
+        return;
+    }
+    if (x == 0.0) {
+        put_char(w, '0');
+        return;
+    }
+    double ax = fabs(x);
+    if (ax >= 1e9 || ax < 1e-3) {
+        char tmp[32];
+        int n = snprintf(tmp, sizeof(tmp), "%.6g", x);
+        put_bytes(w, tmp, (size_t)n);
+        return;
+    }
+    long long scaled = llround(ax * 1e6);
+    long long ip = scaled / 1000000;
+    long long fp = scaled % 1000000;
+    if (x < 0) put_char(w, '-');
+    put_int(w, ip);
+    if (fp == 0) return;
+    char digits[6];
+    for (int i = 5; i >= 0; --i) {
+        digits[i] = (char)('0' + fp % 10);
+        fp /= 10;
+    }
+    int last = 5;
+    while (digits[last] == '0') --last;
+    put_char(w, '.');
+    put_bytes(w, digits, (size_t)last + 1);
+}
+
+static void put_json_string(t_writer *w, const char *s)
+{
+    put_char(w, '"');
+    for (; *s; ++s) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            put_char(w, '\\');
+            put_char(w, (char)c);
+        } else if (c < 0x20) {
+            char tmp[8];
+            snprintf(tmp, sizeof(tmp), "\\u%04x", c);
+            put_str(w, tmp);
+        } else {
+            put_char(w, (char)c);
+        }
+    }
+    put_char(w, '"');
+}
+
+static void begin_record(t_writer *w, const char *type)
+{
+    put_str(w, "{\"type\":");
+    put_json_string(w, type);
+}
+
+static void end_record(t_writer *w)
+{
+    put_str(w, "}\n");
+}
+
+static void put_key(t_writer *w, const char *key)
+{
+    put_char(w, ',');
+    put_json_string(w, key);
+    put_char(w, ':');
+}
+
+static void put_float_array(t_writer *w, const float *v, int n)
+{
+    put_char(w, '[');
+    for (int i = 0; i < n; ++i) {
+        if (i) put_char(w, ',');
+        put_float(w, v[i]);
+    }
+    put_char(w, ']');
+}
+
+static void put_int_array(t_writer *w, const int *v, int n)
+{
+    put_char(w, '[');
+    for (int i = 0; i < n; ++i) {
+        if (i) put_char(w, ',');
+        put_int(w, v[i]);
+    }
+    put_char(w, ']');
+}
+
+/* Vecteur selon le niveau de détail : "key" complet, "key_top" [[id, x], ...]
+ * ou "key_sum"/"key_max". ids donne l'identifiant de chaque coefficient (NULL : i+1). */
+static void put_json_vector(t_writer *w, const char *key, const float *v, int n, const int *ids)
+{
+    char k[64];
+    if (w->print.mode == PRINT_FULL) {
+        put_key(w, key);
+        put_float_array(w, v, n);
+    } else if (w->print.mode == PRINT_TOPK) {
+        int *idx = calloc_int_array(n > 0 ? n : 1);
+        int count = topKIndices(v, n, w->print.topk, idx);
+        snprintf(k, sizeof(k), "%s_top", key);
+        put_key(w, k);
+        put_char(w, '[');
+        for (int t = 0; t < count; ++t) {
+            if (t) put_char(w, ',');
+            put_char(w, '[');
+            put_int(w, ids ? ids[idx[t]] : idx[t] + 1);
+            put_char(w, ',');
+            put_float(w, v[idx[t]]);
+            put_char(w, ']');
+        }
+        put_char(w, ']');
+        free(idx);
+    } else {
+        double sum = 0.0;
+        int arg = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += v[i];
+            if (v[i] > v[arg]) arg = i;
+        }
+        snprintf(k, sizeof(k), "%s_sum", key);
+        put_key(w, k);
+        put_float(w, sum);
+        if (n > 0) {
+            snprintf(k, sizeof(k), "%s_max", key);
+            put_key(w, k);
+            put_char(w, '[');
+            put_int(w, ids ? ids[arg] : arg + 1);
+            put_char(w, ',');
+            put_float(w, v[arg]);
+            put_char(w, ']');
+        }
+    }
+}
+
+/* ================= Format texte ================= */
+
+/* Sommets d'une classe ; en mode top-k, seulement les k premiers. */
+static void text_vertex_set(t_writer *w, const t_class *c)
+{
+    int shown = w->print.mode == PRINT_TOPK && w->print.topk < c->size ? w->print.topk : c->size;
+    put_char(w, '{');
+    for (int j = 0; j < shown; ++j) {
+        put_fmt(w, "%d", c->vertices[j]);
+        if (j + 1 < shown) put_str(w, ", ");
+    }
+    if (shown < c->size) put_fmt(w, "%s... (%d sommets)", shown > 0 ? ", " : "", c->size);
+    put_char(w, '}');
+}
+
+/* Indices des k plus grandes classes (taille décroissante) ; renvoie leur nombre. */
+static int largest_classes(const t_partition *part, int k, int *idx)
+{
+    float *sizes = calloc_float_array(part->size > 0 ? part->size : 1);
+    for (int ci = 0; ci < part->size; ++ci) {
+        sizes[ci] = (float)part->classes[ci].size;
+    }
+    int count = topKIndices(sizes, part->size, k, idx);
+    free(sizes);
+    return count;
+}
+
+/* Classes à lister selon le niveau de détail : toutes, dans l'ordre de la
+ * partition, ou les k plus grandes. Renvoie leur nombre (0 en mode résumé). */
+static int listed_classes(const t_writer *w, const t_partition *part, int *idx)
+{
+    if (w->print.mode == PRINT_SUMMARY) return 0;
+    if (w->print.mode == PRINT_TOPK) return largest_classes(part, w->print.topk, idx);
+    for (int ci = 0; ci < part->size; ++ci) {
+        idx[ci] = ci;
+    }
+    return part->size;
+}
+
+/* Vecteur, une ligne "  label[i] = x" par coefficient en mode complet. */
+static void text_vector(t_writer *w, const float *v, int n, const char *label)
+{
+    if (w->print.mode == PRINT_FULL) {
+        for (int j = 0; j < n; ++j) {
+            put_fmt(w, "  %s[%d] = %.4f\n", label, j + 1, v[j]);
+        }
+        return;
+    }
+    if (w->print.mode == PRINT_TOPK) {
+        int *idx = calloc_int_array(n > 0 ? n : 1);
+        int k = topKIndices(v, n, w->print.topk, idx);
+        for (int t = 0; t < k; ++t) {
+            put_fmt(w, "  %s[%d] = %.4f\n", label, idx[t] + 1, v[idx[t]]);
+        }
+        if (k < n) put_fmt(w, "  (%d autres coefficients)\n", n - k);
+        free(idx);
+        return;
+    }
+    double sum = 0.0;
+    int arg = 0, nnz = 0;
+    for (int j = 0; j < n; ++j) {
+        sum += v[j];
+        if (v[j] != 0.0f) nnz++;
+        if (v[j] > v[arg]) arg = j;
+    }
+    put_fmt(w, "  %d coefficients (%d non nuls), somme = %.4f, max = %s[%d] = %.4f\n",
+            n, nnz, sum, label, arg + 1, n > 0 ? v[arg] : 0.0f);
+}
+
+/* Matrice à écrire, en mémoire (M), hors mémoire (T) ou produite ligne par
+ * ligne par read(arg, i), lue ligne par ligne.
+ * Si position n'est pas NULL, la ligne (ou colonne) d'origine v est la ligne
+ * position[v]-1 de la matrice stockée. */
+typedef struct {
+    const t_matrix *M;
+    const t_tiled_matrix *T;
+    t_row_reader read;
+    void *arg;
+    const int *position;
+    int n;
+    float *stored;          /* ligne lue dans T */
+    float *row;             /* ligne dans la numérotation d'origine */
+} t_matrix_source;
+
+static void init_source(t_matrix_source *s, const t_matrix *M, const t_tiled_matrix *T,
+                        t_row_reader read, void *arg, int n, const int *position)
+{
+    s->M = M;
+    s->T = T;
+    s->read = read;
+    s->arg = arg;
+    s->position = position;
+    s->n = M ? M->rows : T ? T->n : n;
+    s->stored = T ? calloc_float_array(s->n > 0 ? s->n : 1) : NULL;
+    s->row = position ? calloc_float_array(s->n > 0 ? s->n : 1) : NULL;
+}
+
+static void free_source(t_matrix_source *s)
+{
+    free(s->stored);
+    free(s->row);
+}
+
+/* Ligne i telle que stockée. */
+static const float *stored_row(void *arg, int i)
+{
+    t_matrix_source *s = arg;
+    if (s->M) return s->M->data[i];
+    if (s->read) return s->read(s->arg, i);
+    tiledReadRow(s->T, i, s->stored);
+    return s->stored;
+}
+
+/* Ligne i dans la numérotation d'origine. */
+static const float *original_row(void *arg, int i)
+{
+    t_matrix_source *s = arg;
+    if (!s->position) return stored_row(s, i);
+    const float *r = stored_row(s, s->position[i] - 1);
+    for (int j = 0; j < s->n; ++j) {
+        s->row[j] = r[s->position[j] - 1];
+    }
+    return s->row;
+}
+
+static void text_matrix(t_writer *w, t_matrix_source *src, const char *name)
+{
+    int n = src->n;
+    if (w->print.mode == PRINT_FULL) {
+        put_fmt(w, "\nMatrice %s (%d x %d):\n", name, n, n);
+        for (int i = 0; i < n; ++i) {
+            const float *row = original_row(src, i);
+            for (int j = 0; j < n; ++j) {
+                put_fmt(w, "%7.4f ", row[j]);
+            }
+            put_char(w, '\n');
+        }
+        return;
+    }
+    if (w->print.mode == PRINT_TOPK) {
+        int k = w->print.topk;
+        int *row = calloc_int_array(k);
+        int *col = calloc_int_array(k);
+        float *value = calloc_float_array(k);
+        int count = topKRowEntries(original_row, src, n, n, k, row, col, value);
+        put_fmt(w, "\nMatrice %s (%d x %d), %d plus grands coefficients :\n", name, n, n, count);
+        for (int t = 0; t < count; ++t) {
+            put_fmt(w, "  [%d][%d] = %.4f\n", row[t] + 1, col[t] + 1, value[t]);
+        }
+        free(row);
+        free(col);
+        free(value);
+        return;
+    }
+    t_matrix_summary s = summarizeRows(stored_row, src, n, n);
+    put_fmt(w, "\nMatrice %s (%d x %d) : %ld coefficients non nuls, max = %.4f, "
+               "sommes des lignes dans [%.4f, %.4f]\n", name, n, n, s.nnz, s.max,
+            s.min_row_sum, s.max_row_sum);
+}
+
+/* Liste d'adjacence puis vérification ligne par ligne, comme printAdjList et checkMarkov. */
+static void text_graph(t_writer *w, const t_graph *g, float eps)
+{
+    if (w->print.mode == PRINT_FULL) {
+        put_fmt(w, "Graphe (%d sommets)\n", g->nb_vertices);
+        for (int i = 0; i < g->nb_vertices; ++i) {
+            put_fmt(w, "Sommet %d: ", i + 1);
+            for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
+                put_fmt(w, "-> (%d, %.2f) ", cur->dest, cur->proba);
+            }
+            put_char(w, '\n');
+        }
+    }
+    float target = g->continuous ? 0.0f : 1.0f;
+    int ok = 1;
+    for (int i = 0; i < g->nb_vertices; ++i) {
+        float sum = 0.0f;
+        for (t_arc *cur = g->array[i].head; cur; cur = cur->next) {
+            sum += cur->proba;
+            if (g->continuous && cur->dest != i + 1 && cur->proba < 0.0f) {
+                put_fmt(w, "Sommet %d : taux negatif vers %d (%.4f)\n", i + 1, cur->dest, cur->proba);
+                ok = 0;
+            }
+        }
+        if (sum < target - eps || sum > target + eps) {
+            put_fmt(w, "Sommet %d : somme des %s = %.4f (hors [%g-eps,%g+eps])\n",
+                    i + 1, g->continuous ? "taux" : "probabilites", sum, target, target);
+            ok = 0;
+        }
+    }
+    const char *kind = g->continuous ? "un generateur de Markov (temps continu)" : "un graphe de Markov";
+    put_fmt(w, ok ? "Le graphe est %s (eps=%.3f)\n" : "Le graphe N'EST PAS %s (eps=%.3f)\n", kind, eps);
+}
+
+static void text_partition(t_writer *w, const t_partition *part)
+{
+    int *idx = calloc_int_array(part->size > 0 ? part->size : 1);
+    int count = listed_classes(w, part, idx);
+    for (int t = 0; t < count; ++t) {
+        put_fmt(w, "Composante %s: ", part->classes[idx[t]].name);
+        text_vertex_set(w, &part->classes[idx[t]]);
+        put_char(w, '\n');
+    }
+    if (w->print.mode == PRINT_TOPK && count < part->size) {
+        put_fmt(w, "(%d autres composantes)\n", part->size - count);
+    } else if (w->print.mode == PRINT_SUMMARY) {
+        int largest = 0, singletons = 0;
+        for (int ci = 0; ci < part->size; ++ci) {
+            singletons += part->classes[ci].size == 1;
+            if (part->classes[ci].size > part->classes[largest].size) largest = ci;
+        }
+        put_fmt(w, "%d composantes (%d reduites a un sommet), plus grande : %s (%d sommets)\n",
+                part->size, singletons, part->size > 0 ? part->classes[largest].name : "-",
+                part->size > 0 ? part->classes[largest].size : 0);
+    }
+    free(idx);
+}
+
+static void text_classification(t_writer *w, const t_partition *part, const t_link_array *links)
+{
+    t_class_kind *kinds = classifyClasses(part, links);
+    int *idx = calloc_int_array(part->size > 0 ? part->size : 1);
+    int count = listed_classes(w, part, idx);
+    put_str(w, "\n=== Caracteristiques des classes ===\n");
+    for (int t = 0; t < count; ++t) {
+        int ci = idx[t];
+        put_fmt(w, "%s: ", part->classes[ci].name);
+        text_vertex_set(w, &part->classes[ci]);
+        put_str(w, kinds[ci] == CLASS_TRANSIENT ? " -> classe transitoire" : " -> classe persistante");
+        if (kinds[ci] == CLASS_ABSORBING) put_str(w, " (etat absorbant)");
+        put_char(w, '\n');
+    }
+    if (w->print.mode != PRINT_FULL) {
+        int nb_transient = 0, nb_absorbing = 0;
+        for (int ci = 0; ci < part->size; ++ci) {
+            nb_transient += kinds[ci] == CLASS_TRANSIENT;
+            nb_absorbing += kinds[ci] == CLASS_ABSORBING;
+        }
+        put_fmt(w, "%d classes : %d transitoires, %d persistantes dont %d absorbantes\n",
+                part->size, nb_transient, part->size - nb_transient, nb_absorbing);
+    }
+    put_str(w, part->size == 1 ? "\nLe graphe de Markov est irreductible (une seule classe).\n"
+                               : "\nLe graphe de Markov n'est pas irreductible.\n");
+    free(idx);
+    free(kinds);
+}
+
+static void text_not_converged(t_writer *w, const t_class_result *res)
+{
+    if (res->converged) return;
+    put_fmt(w, "  (non convergee : budget de %d iterations epuise, valeurs approchees)\n",
+            res->budget);
+}
+
+static void text_class_results(t_writer *w, const t_partition *part, const t_class_result *results)
+{
+    put_str(w, "\nDistributions stationnaires par classe (approx) :\n");
+    for (int ci = 0; ci < part->size; ++ci) {
+        const t_class_result *res = &results[ci];
+        if (res->size == 0) continue;
+        if (res->period <= 1) {
+            put_fmt(w, "\nClasse %s (puissance n=%d): distribution stationnaire approx (ligne 1):\n",
+                    part->classes[ci].name, res->power);
+            text_not_converged(w, res);
+            text_vector(w, res->distribution, res->size, "p");
+            continue;
+        }
+        put_fmt(w, "\nClasse %s (periode d=%d, puissance n=%d sur P^d): distribution limite (Cesaro):\n",
+                part->classes[ci].name, res->period, res->power);
+        text_not_converged(w, res);
+        text_vector(w, res->distribution, res->size, "p");
+        for (int s = 0; s < res->period; ++s) {
+            if (w->print.mode != PRINT_FULL) {
+                put_fmt(w, "  limite de P^(nd+%d) depuis la sous-classe 0 :\n", s);
+                text_vector(w, res->cyclic.phase_limits[s], res->size, "p");
+                continue;
+            }
+            put_fmt(w, "  limite de P^(nd+%d) depuis la sous-classe 0 :", s);
+            for (int j = 0; j < res->size; ++j) {
+                put_fmt(w, " %.4f", res->cyclic.phase_limits[s][j]);
+            }
+            put_char(w, '\n');
+        }
+    }
+
+    put_str(w, "\nPeriode de chaque classe :\n");
+    for (int ci = 0; ci < part->size; ++ci) {
+        if (part->classes[ci].size == 0) continue;
+        put_fmt(w, "  Classe %s : periode = %d\n", part->classes[ci].name, results[ci].period);
+    }
+}
+
+static void text_absorption_state(t_writer *w, const t_partition *part, const t_absorption *abs, int v)
+{
+    put_fmt(w, "  Etat %d : %.4f pas en moyenne ;", v + 1, abs->expected_steps[v]);
+    const int *cols = abs->columns + abs->row_start[v];
+    const float *vals = abs->values + abs->row_start[v];
+    int e = 0;
+    for (int p = 0; p < abs->nb_persistent; ++p) {
+        float x = e < abs->row_size[v] && cols[e] == p ? vals[e++] : 0.0f;
+        put_fmt(w, " %s=%.4f", part->classes[abs->persistent_classes[p]].name, x);
+    }
+    put_char(w, '\n');
+}
+
+static void text_absorption(t_writer *w, const t_partition *part, const t_absorption *abs)
+{
+    put_str(w, "\nProbabilites d'absorption et temps moyens (etats transitoires) :\n");
+    int nb_transient = 0;
+    int slowest = -1;
+    for (int v = 0; v < abs->nb_vertices; ++v) {
+        if (!abs->is_transient[v]) continue;
+        nb_transient++;
+        if (slowest < 0 || abs->expected_steps[v] > abs->expected_steps[slowest]) slowest = v;
+    }
+    if (nb_transient == 0) {
+        put_str(w, "  Aucun etat transitoire.\n");
+        return;
+    }
+
+    if (w->print.mode == PRINT_FULL) {
+        for (int v = 0; v < abs->nb_vertices; ++v) {
+            if (abs->is_transient[v]) text_absorption_state(w, part, abs, v);
+        }
+    } else if (w->print.mode == PRINT_TOPK) {
+        /* Les états persistants ont un temps nul : ils ne passent devant aucun transitoire. */
+        int *idx = calloc_int_array(abs->nb_vertices);
+        int k = topKIndices(abs->expected_steps, abs->nb_vertices,
+                            w->print.topk < nb_transient ? w->print.topk : nb_transient, idx);
+        for (int t = 0; t < k; ++t) {
+            text_absorption_state(w, part, abs, idx[t]);
+        }
+        if (k < nb_transient) put_fmt(w, "  (%d autres etats transitoires)\n", nb_transient - k);
+        free(idx);
+    } else {
+        put_fmt(w, "  %d etats transitoires, temps moyen maximal = %.4f (etat %d)\n",
+                nb_transient, abs->expected_steps[slowest], slowest + 1);
+    }
+}
+
+static void text_occupation(t_writer *w, const t_simulation_result *res, int v)
+{
+    put_fmt(w, "  Etat %d : %llu visites (%.4f)\n", v + 1, (unsigned long long)res->visits[v],
+            (double)res->visits[v] / (double)res->total_steps);
+}
+
+static void text_simulation(t_writer *w, const t_simulation_result *res)
+{
+    put_fmt(w, "\nSimulation : %ld trajectoires, %llu visites au total\n",
+            res->nb_walks, (unsigned long long)res->total_steps);
+    if (w->print.mode == PRINT_FULL) {
+        put_str(w, "Frequences d'occupation :\n");
+        for (int v = 0; v < res->n; ++v) {
+            if (res->visits[v] != 0) text_occupation(w, res, v);
+        }
+    } else if (w->print.mode == PRINT_TOPK) {
+        float *freq = calloc_float_array(res->n > 0 ? res->n : 1);
+        int *idx = calloc_int_array(res->n > 0 ? res->n : 1);
+        for (int v = 0; v < res->n; ++v) {
+            freq[v] = (float)res->visits[v];
+        }
+        int k = topKIndices(freq, res->n, w->print.topk, idx);
+        put_fmt(w, "Frequences d'occupation (%d etats les plus visites) :\n", k);
+        for (int t = 0; t < k; ++t) {
+            if (res->visits[idx[t]] != 0) text_occupation(w, res, idx[t]);
+        }
+        free(freq);
+        free(idx);
+    }
+    put_fmt(w, "Temps d'atteinte des cibles : %ld trajectoires sur %ld, moyenne = %.4f\n",
+            res->nb_hits, res->nb_walks, res->mean_hitting_time);
+    for (int b = 0; b < res->nb_bins; ++b) {
+        if (res->histogram[b] == 0) continue;
+        put_fmt(w, "  [%d, %d[ : %llu\n", b * res->bin_width, (b + 1) * res->bin_width,
+                (unsigned long long)res->histogram[b]);
+    }
+}
+
+static void text_lumping(t_writer *w, const t_lumping *L)
+{
+    put_fmt(w, "Agregation : %d etats -> %d blocs\n", L->nb_vertices, L->nb_blocks);
+    for (int b = 0; b < L->nb_blocks; ++b) {
+        int size = L->block_start[b + 1] - L->block_start[b];
+        if (size < 2) continue;
+        put_fmt(w, "  Bloc %d = {", b + 1);
+        for (int i = L->block_start[b]; i < L->block_start[b + 1]; ++i) {
+            put_fmt(w, "%d%s", L->members[i], i + 1 < L->block_start[b + 1] ? "," : "");
+        }
+        put_str(w, "}\n");
+    }
+}
+
+static void text_quotient_classes(t_writer *w, const t_partition *epart, const t_class_result *results)
+{
+    int *idx = calloc_int_array(epart->size > 0 ? epart->size : 1);
+    int count = listed_classes(w, epart, idx);
+    put_str(w, "\nClasses du quotient ramenees aux etats :\n");
+    for (int t = 0; t < count; ++t) {
+        const t_class *c = &epart->classes[idx[t]];
+        put_fmt(w, "  Classe %s (periode %d) : ", c->name, results[idx[t]].period);
+        text_vertex_set(w, c);
+        put_char(w, '\n');
+    }
+    if (w->print.mode == PRINT_TOPK && count < epart->size) {
+        put_fmt(w, "  (%d autres classes)\n", epart->size - count);
+    } else if (w->print.mode == PRINT_SUMMARY) {
+        put_fmt(w, "  %d classes\n", epart->size);
+    }
+    free(idx);
+}
+
+/* ================= Enregistrements ================= */
+
+void writeGraph(t_writer *w, const t_graph *g, float eps)
+{
+    if (w->format == FORMAT_TEXT) {
+        text_graph(w, g, eps);
+        return;
+    }
+    int nb_arcs = countArcs(g);
+    int valid = isMarkovGraph(g, eps);
+    if (w->format == FORMAT_BINARY) {
+        put_record_header(w, RECORD_GRAPH, 2 * sizeof(int32_t) + 2);
+        put_i32(w, g->nb_vertices);
+        put_i32(w, nb_arcs);
+        put_u8(w, (uint8_t)g->continuous);
+        put_u8(w, (uint8_t)valid);
+        return;
+    }
+    begin_record(w, "graph");
+    put_key(w, "vertices");
+    put_int(w, g->nb_vertices);
+    put_key(w, "arcs");
+    put_int(w, nb_arcs);
+    put_key(w, "continuous");
+    put_str(w, g->continuous ? "true" : "false");
+    put_key(w, "valid");
+    put_str(w, valid ? "true" : "false");
+    end_record(w);
+}
+
+void writePartition(t_writer *w, const t_partition *part)
+{
+    if (w->format == FORMAT_TEXT) {
+        text_partition(w, part);
+        return;
+    }
+    if (w->format == FORMAT_BINARY) {
+        size_t payload = sizeof(int32_t);
+        for (int ci = 0; ci < part->size; ++ci) {
+            payload += 1 + name_bytes(part->classes[ci].name) + sizeof(int32_t) * (size_t)(1 + part->classes[ci].size);
+        }
+        put_record_header(w, RECORD_PARTITION, payload);
+        put_i32(w, part->size);
+        for (int ci = 0; ci < part->size; ++ci) {
+            const t_class *c = &part->classes[ci];
+            put_name(w, c->name);
+            put_i32(w, c->size);
+            for (int i = 0; i < c->size; ++i) {
+                put_i32(w, c->vertices[i]);
+            }
+        }
+        return;
+    }
+    begin_record(w, "partition");
+    if (w->print.mode != PRINT_FULL) {
+        put_key(w, "count");
+        put_int(w, part->size);
+    }
+    if (w->print.mode == PRINT_SUMMARY) {
+        int largest = 0, singletons = 0;
+        for (int ci = 0; ci < part->size; ++ci) {
+            singletons += part->classes[ci].size == 1;
+            if (part->classes[ci].size > part->classes[largest].size) largest = ci;
+        }
+        put_key(w, "singletons");
+        put_int(w, singletons);
+        if (part->size > 0) {
+            put_key(w, "largest");
+            put_str(w, "{\"name\":");
+            put_json_string(w, part->classes[largest].name);
+            put_key(w, "size");
+            put_int(w, part->classes[largest].size);
+            put_char(w, '}');
+        }
+        end_record(w);
+        return;
+    }
+    int *idx = calloc_int_array(part->size > 0 ? part->size : 1);
+    int count = listed_classes(w, part, idx);
+    put_key(w, w->print.mode == PRINT_TOPK ? "classes_top" : "classes");
+    put_char(w, '[');
+    for (int t = 0; t < count; ++t) {
+        const t_class *c = &part->classes[idx[t]];
+        if (t) put_char(w, ',');
+        put_str(w, "{\"name\":");
+        put_json_string(w, c->name);
+        if (w->print.mode == PRINT_TOPK) {
+            put_key(w, "size");
+            put_int(w, c->size);
+        }
+        put_key(w, "vertices");
+        put_int_array(w, c->vertices, w->print.mode == PRINT_TOPK && w->print.topk < c->size ? w->print.topk : c->size);
+        put_char(w, '}');
+    }
+    put_char(w, ']');
+    free(idx);
+    end_record(w);
+}
+
+void writeClassification(t_writer *w, const t_partition *part, const t_link_array *links)
+{
+    if (w->format == FORMAT_TEXT) {
+        text_classification(w, part, links);
+        return;
+    }
+    int *transient = buildTransientFlags(part, links);
+    int irreducible = part->size == 1;
+    if (w->format == FORMAT_BINARY) {
+        put_record_header(w, RECORD_CLASSIFICATION, sizeof(int32_t) + 2 * (size_t)part->size + 1);
+        put_i32(w, part->size);
+        for (int ci = 0; ci < part->size; ++ci) {
+            put_u8(w, (uint8_t)transient[ci]);
+            put_u8(w, (uint8_t)(!transient[ci] && part->classes[ci].size == 1));
+        }
+        put_u8(w, (uint8_t)irreducible);
+    } else {
+        begin_record(w, "classification");
+        put_key(w, "irreducible");
+        put_str(w, irreducible ? "true" : "false");
+        if (w->print.mode != PRINT_FULL) {
+            int nb_transient = 0, nb_absorbing = 0;
+            for (int ci = 0; ci < part->size; ++ci) {
+                nb_transient += transient[ci];
+                nb_absorbing += !transient[ci] && part->classes[ci].size == 1;
+            }
+            put_key(w, "transient_count");
+            put_int(w, nb_transient);
+            put_key(w, "persistent_count");
+            put_int(w, part->size - nb_transient);
+            put_key(w, "absorbing_count");
+            put_int(w, nb_absorbing);
+        }
+        int *idx = calloc_int_array(part->size > 0 ? part->size : 1);
+        int count = listed_classes(w, part, idx);
+        if (w->print.mode != PRINT_SUMMARY) {
+            put_key(w, w->print.mode == PRINT_TOPK ? "classes_top" : "classes");
+            put_char(w, '[');
+        }
+        for (int t = 0; t < count; ++t) {
+            int ci = idx[t];
+            if (t) put_char(w, ',');
+            put_str(w, "{\"name\":");
+            put_json_string(w, part->classes[ci].name);
+            if (w->print.mode == PRINT_TOPK) {
+                put_key(w, "size");
+                put_int(w, part->classes[ci].size);
+            }
+            put_key(w, "transient");
+            put_str(w, transient[ci] ? "true" : "false");
+            put_key(w, "absorbing");
+            put_str(w, !transient[ci] && part->classes[ci].size == 1 ? "true" : "false");
+            put_char(w, '}');
+        }
+        if (w->print.mode != PRINT_SUMMARY) put_char(w, ']');
+        free(idx);
+        end_record(w);
+    }
+    free(transient);
+}
+
+static void write_matrix_source(t_writer *w, t_matrix_source *src, const char *name)
+{
+    int n = src->n;
+    if (w->format == FORMAT_TEXT) {
+        text_matrix(w, src, name);
+        return;
+    }
+    if (w->format == FORMAT_BINARY) {
+        size_t payload = 1 + name_bytes(name) + 2 * sizeof(int32_t) + sizeof(float) * (size_t)n * (size_t)n;
+        put_record_header(w, RECORD_MATRIX, payload);
+        put_name(w, name);
+        put_i32(w, n);
+        put_i32(w, n);
+        for (int i = 0; i < n; ++i) {
+            const float *row = original_row(src, i);
+            for (int j = 0; j < n; ++j) {
+                put_f32(w, row[j]);
+            }
+        }
+        return;
+    }
+
+    begin_record(w, "matrix");
+    put_key(w, "name");
+    put_json_string(w, name);
+    put_key(w, "rows");
+    put_int(w, n);
+    put_key(w, "cols");
+    put_int(w, n);
+    if (w->print.mode == PRINT_FULL) {
+        put_key(w, "data");
+        put_char(w, '[');
+        for (int i = 0; i < n; ++i) {
+            const float *row = original_row(src, i);
+            if (i) put_char(w, ',');
+            put_char(w, '[');
+            for (int j = 0; j < n; ++j) {
+                if (j) put_char(w, ',');
+                put_float(w, row[j]);
+            }
+            put_char(w, ']');
+        }
+        put_char(w, ']');
+    } else if (w->print.mode == PRINT_TOPK) {
+        int k = w->print.topk;
+        int *row = calloc_int_array(k);
+        int *col = calloc_int_array(k);
+        float *value = calloc_float_array(k);
+        int count = topKRowEntries(original_row, src, n, n, k, row, col, value);
+        put_key(w, "top");
+        put_char(w, '[');
+        for (int t = 0; t < count; ++t) {
+            if (t) put_char(w, ',');
+            put_char(w, '[');
+            put_int(w, row[t] + 1);
+            put_char(w, ',');
+            put_int(w, col[t] + 1);
+            put_char(w, ',');
+            put_float(w, value[t]);
+            put_char(w, ']');
+        }
+        put_char(w, ']');
+        free(row);
+        free(col);
+        free(value);
+    } else {
+        t_matrix_summary s = summarizeRows(stored_row, src, n, n);
+        put_key(w, "nnz");
+        put_int(w, s.nnz);
+        put_key(w, "max");
+        put_float(w, s.max);
+        put_key(w, "min_row_sum");
+        put_float(w, s.min_row_sum);
+        put_key(w, "max_row_sum");
+        put_float(w, s.max_row_sum);
+    }
+    end_record(w);
+}
+
+void writeMatrix(t_writer *w, const t_matrix *M, const int *position, const char *name)
+{
+    t_matrix_source src;
+    init_source(&src, M, NULL, NULL, NULL, 0, position);
+    write_matrix_source(w, &src, name);
+    free_source(&src);
+}
+
+void writeTiledMatrix(t_writer *w, const t_tiled_matrix *T, const int *position, const char *name)
+{
+    t_matrix_source src;
+    init_source(&src, NULL, T, NULL, NULL, 0, position);
+    write_matrix_source(w, &src, name);
+    free_source(&src);
+}
+
+void writeRowMatrix(t_writer *w, t_row_reader read, void *arg, int n, const int *position, const char *name)
+{
+    t_matrix_source src;
+    init_source(&src, NULL, NULL, read, arg, n, position);
+    write_matrix_source(w, &src, name);
+    free_source(&src);
+}
+
+void writeVector(t_writer *w, const char *name, const char *label, const float *v, int n)
+{
+    if (w->format == FORMAT_TEXT) {
+        text_vector(w, v, n, label);
+        return;
+    }
+    if (w->format == FORMAT_BINARY) {
+        put_record_header(w, RECORD_VECTOR, 1 + name_bytes(name) + sizeof(int32_t) + sizeof(float) * (size_t)n);
+        put_name(w, name);
+        put_i32(w, n);
+        for (int i = 0; i < n; ++i) {
+            put_f32(w, v[i]);
+        }
+        return;
+    }
+    begin_record(w, "vector");
+    put_key(w, "name");
+    put_json_string(w, name);
+    put_key(w, "size");
+    put_int(w, n);
+    put_json_vector(w, "values", v, n, NULL);
+    end_record(w);
+}
+
+void writeClassResults(t_writer *w, const t_partition *part, const t_class_result *results)
+{
+    if (w->format == FORMAT_TEXT) {
+        text_class_results(w, part, results);
+        return;
+    }
+    for (int ci = 0; ci < part->size; ++ci) {
+        const t_class *c = &part->classes[ci];
+        const t_class_result *res = &results[ci];
+        int k = res->size;
+        int periodic = res->period > 1 && res->cyclic.phase_limits;
+        if (w->format == FORMAT_BINARY) {
+            size_t payload = 1 + name_bytes(c->name) + 3 * sizeof(int32_t)
+                             + (sizeof(int32_t) + sizeof(float)) * (size_t)k;
+            if (periodic) payload += sizeof(float) * (size_t)res->period * (size_t)k;
+            put_record_header(w, RECORD_CLASS, payload);
+            put_name(w, c->name);
+            put_i32(w, res->period);
+            put_i32(w, res->power);
+            put_i32(w, k);
+            for (int i = 0; i < k; ++i) {
+                put_i32(w, c->vertices[i]);
+            }
+            for (int i = 0; i < k; ++i) {
+                put_f32(w, res->distribution ? res->distribution[i] : 0.0f);
+            }
+            if (periodic) {
+                for (int s = 0; s < res->period; ++s) {
+                    for (int i = 0; i < k; ++i) {
+                        put_f32(w, res->cyclic.phase_limits[s][i]);
+                    }
+                }
+            }
+            continue;
+        }
+        begin_record(w, "class");
+        put_key(w, "name");
+        put_json_string(w, c->name);
+        put_key(w, "size");
+        put_int(w, c->size);
+        put_key(w, "period");
+        put_int(w, res->period);
+        put_key(w, "power");
+        put_int(w, res->power);
+        put_key(w, "converged");
+        put_str(w, res->converged ? "true" : "false");
+        if (k > 0 && res->distribution) {
+            if (w->print.mode == PRINT_FULL) {
+                put_key(w, "vertices");
+                put_int_array(w, c->vertices, k);
+            }
+            put_json_vector(w, "distribution", res->distribution, k, c->vertices);
+            if (periodic && w->print.mode == PRINT_FULL) {
+                put_key(w, "phase_limits");
+                put_char(w, '[');
+                for (int s = 0; s < res->period; ++s) {
+                    if (s) put_char(w, ',');
+                    put_float_array(w, res->cyclic.phase_limits[s], k);
+                }
+                put_char(w, ']');
+            }
+        }
+        end_record(w);
+    }
+}
+
+void writeAbsorption(t_writer *w, const t_partition *part, const t_absorption *abs)
+{
+    if (w->format == FORMAT_TEXT) {
+        text_absorption(w, part, abs);
+        return;
+    }
+    int n = abs->nb_vertices;
+    int np = abs->nb_persistent;
+    if (w->format == FORMAT_BINARY) {
+        size_t payload = sizeof(int32_t) * (size_t)(2 + np)
+                         + (size_t)n * (1 + sizeof(float) + sizeof(int32_t));
+        for (int v = 0; v < n; ++v) {
+            payload += (sizeof(int32_t) + sizeof(float)) * (size_t)abs->row_size[v];
+        }
+        put_record_header(w, RECORD_ABSORPTION, payload);
+        put_i32(w, n);
+        put_i32(w, np);
+        for (int p = 0; p < np; ++p) {
+            put_i32(w, abs->persistent_classes[p]);
+        }
+        for (int v = 0; v < n; ++v) {
+            put_u8(w, (uint8_t)abs->is_transient[v]);
+            put_f32(w, abs->expected_steps[v]);
+            put_i32(w, abs->row_size[v]);
+            for (size_t e = abs->row_start[v]; e < abs->row_start[v] + (size_t)abs->row_size[v]; ++e) {
+                put_i32(w, abs->columns[e]);
+                put_f32(w, abs->values[e]);
+            }
+        }
+        return;
+    }
+
+    int nb_transient = 0;
+    for (int v = 0; v < n; ++v) {
+        nb_transient += abs->is_transient[v];
+    }
+    begin_record(w, "absorption");
+    put_key(w, "classes");
+    put_char(w, '[');
+    for (int p = 0; p < np; ++p) {
+        if (p) put_char(w, ',');
+        put_json_string(w, part->classes[abs->persistent_classes[p]].name);
+    }
+    put_char(w, ']');
+    put_key(w, "transient");
+    put_int(w, nb_transient);
+
+    if (w->print.mode == PRINT_SUMMARY) {
+        int slowest = -1;
+        for (int v = 0; v < n; ++v) {
+            if (abs->is_transient[v] && (slowest < 0 || abs->expected_steps[v] > abs->expected_steps[slowest])) {
+                slowest = v;
+            }
+        }
+        if (slowest >= 0) {
+            put_key(w, "slowest");
+            put_int(w, slowest + 1);
+            put_key(w, "max_steps");
+            put_float(w, abs->expected_steps[slowest]);
+        }
+        end_record(w);
+        return;
+    }
+
+    int *order = calloc_int_array(n > 0 ? n : 1);
+    int count = 0;
+    if (w->print.mode == PRINT_TOPK) {
+        int k = w->print.topk < nb_transient ? w->print.topk : nb_transient;
+        count = topKIndices(abs->expected_steps, n, k, order);
+    } else {
+        for (int v = 0; v < n; ++v) {
+            if (abs->is_transient[v]) order[count++] = v;
+        }
+    }
+    put_key(w, "states");
+    put_char(w, '[');
+    for (int t = 0; t < count; ++t) {
+        int v = order[t];
+        if (t) put_char(w, ',');
+        put_str(w, "{\"state\":");
+        put_int(w, v + 1);
+        put_key(w, "steps");
+        put_float(w, abs->expected_steps[v]);
+        put_key(w, "probabilities");
+        put_char(w, '[');
+        const int *cols = abs->columns + abs->row_start[v];
+        const float *vals = abs->values + abs->row_start[v];
+        int e = 0;
+        for (int p = 0; p < np; ++p) {
+            if (p) put_char(w, ',');
+            put_float(w, e < abs->row_size[v] && cols[e] == p ? vals[e++] : 0.0f);
+        }
+        put_char(w, ']');
+        put_char(w, '}');
+    }
+    put_char(w, ']');
+    free(order);
+    end_record(w);
+}
+
+void writeSimulation(t_writer *w, const t_simulation_result *res)
+{
+    if (w->format == FORMAT_TEXT) {
+        text_simulation(w, res);
+        return;
+    }
+    if (w->format == FORMAT_BINARY) {
+        size_t payload = 3 * sizeof(int64_t) + sizeof(double) + 3 * sizeof(int32_t)
+                         + sizeof(uint64_t) * (size_t)(res->n + res->nb_bins);
+        put_record_header(w, RECORD_SIMULATION, payload);
+        put_i64(w, res->nb_walks);
+        put_u64(w, res->total_steps);
+        put_i64(w, res->nb_hits);
+        put_f64(w, res->mean_hitting_time);
+        put_i32(w, res->n);
+        for (int v = 0; v < res->n; ++v) {
+            put_u64(w, res->visits[v]);
+        }
+        put_i32(w, res->nb_bins);
+        put_i32(w, res->bin_width);
+        for (int b = 0; b < res->nb_bins; ++b) {
+            put_u64(w, res->histogram[b]);
+        }
+        return;
+    }
+    begin_record(w, "simulation");
+    put_key(w, "walks");
+    put_int(w, res->nb_walks);
+    put_key(w, "visits_total");
+    put_int(w, (long long)res->total_steps);
+    put_key(w, "hits");
+    put_int(w, res->nb_hits);
+    put_key(w, "mean_hitting_time");
+    put_float(w, res->mean_hitting_time);
+    put_key(w, "bin_width");
+    put_int(w, res->bin_width);
+    put_key(w, "histogram");
+    put_char(w, '[');
+    for (int b = 0; b < res->nb_bins; ++b) {
+        if (b) put_char(w, ',');
+        put_int(w, (long long)res->histogram[b]);
+    }
+    put_char(w, ']');
+    if (w->print.mode != PRINT_SUMMARY) {
+        float *freq = calloc_float_array(res->n > 0 ? res->n : 1);
+        for (int v = 0; v < res->n; ++v) {
+            freq[v] = res->total_steps ? (float)((double)res->visits[v] / (double)res->total_steps) : 0.0f;
+        }
+        put_json_vector(w, "occupation", freq, res->n, NULL);
+        free(freq);
+    }
+    end_record(w);
+}
+
+void writeLumping(t_writer *w, const t_lumping *L)
+{
+    if (w->format == FORMAT_TEXT) {
+        text_lumping(w, L);
+        return;
+    }
+    if (w->format == FORMAT_BINARY) {
+        put_record_header(w, RECORD_LUMPING, sizeof(int32_t) * (size_t)(2 + L->nb_vertices));
+        put_i32(w, L->nb_vertices);
+        put_i32(w, L->nb_blocks);
+        for (int v = 0; v < L->nb_vertices; ++v) {
+            put_i32(w, L->block_of[v]);
+        }
+        return;
+    }
+    begin_record(w, "lumping");
+    put_key(w, "states");
+    put_int(w, L->nb_vertices);
+    put_key(w, "blocks");
+    put_int(w, L->nb_blocks);
+    if (w->print.mode == PRINT_FULL) {
+        put_key(w, "block_of");
+        put_int_array(w, L->block_of, L->nb_vertices);
+    }
+    end_record(w);
+}
+
+void writeQuotientClasses(t_writer *w, const t_partition *epart, const t_class_result *results)
+{
+    if (w->format == FORMAT_TEXT) {
+        text_quotient_classes(w, epart, results);
+        return;
+    }
+    for (int ci = 0; ci < epart->size; ++ci) {
+        const t_class *c = &epart->classes[ci];
+        if (w->format == FORMAT_BINARY) {
+            size_t payload = 1 + name_bytes(c->name) + sizeof(int32_t) * (size_t)(2 + c->size);
+            put_record_header(w, RECORD_QUOTIENT_CLASS, payload);
+            put_name(w, c->name);
+            put_i32(w, results[ci].period);
+            put_i32(w, c->size);
+            for (int i = 0; i < c->size; ++i) {
+                put_i32(w, c->vertices[i]);
+            }
+            continue;
+        }
+        begin_record(w, "quotient_class");
+        put_key(w, "name");
+        put_json_string(w, c->name);
+        put_key(w, "period");
+        put_int(w, results[ci].period);
+        put_key(w, "size");
+        put_int(w, c->size);
+        if (w->print.mode == PRINT_FULL) {
+            put_key(w, "vertices");
+            put_int_array(w, c->vertices, c->size);
+        }
+        end_record(w);
+    }
+}
+
+void writeIoStats(t_writer *w, const t_io_stats *io)
+{
+    if (w->format == FORMAT_TEXT) {
+        writeText(w, "Hors memoire : %zu octets lus, %zu octets ecrits par le cache de tuiles\n",
+                  io->bytes_read, io->bytes_written);
+        return;
+    }
+    if (w->format == FORMAT_BINARY) {
+        put_record_header(w, RECORD_IO, 2 * sizeof(uint64_t));
+        put_u64(w, io->bytes_read);
+        put_u64(w, io->bytes_written);
+        return;
+    }
+    begin_record(w, "io");
+    put_key(w, "bytes_read");
+    put_int(w, (long long)io->bytes_read);
+    put_key(w, "bytes_written");
+    put_int(w, (long long)io->bytes_written);
+    end_record(w);
+}